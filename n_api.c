@@ -0,0 +1,176 @@
+/*!
+ * @file n_api.c
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include "n_lib.h"
+
+// What the transaction engine knows about each Notecard API, sorted by name so
+// that it may be searched. An entry whose name ends in a '.' describes the
+// APIs of that family that have no entry of their own. The response sizes are
+// typical rather than exact, and are only given where they exceed a single
+// allocation chunk. No delete is flagged as safe to resend: once the Notecard
+// has executed it, the resent delete fails for want of what it deleted, and
+// that error would be returned in place of the success.
+static const _noteApiDescriptor noteApis[] = {
+    { "card.attn", 0, API_IDEMPOTENT },
+    { "card.aux", 0, API_IDEMPOTENT },
+    { "card.aux.serial", 0, API_IDEMPOTENT },
+    { "card.binary", 0, API_IDEMPOTENT },
+    { "card.binary.get", 0, API_IDEMPOTENT },
+    { "card.binary.put", 0, 0 },
+    { "card.carrier", 0, API_IDEMPOTENT },
+    { "card.contact", 0, API_IDEMPOTENT },
+    { "card.dfu", 0, API_IDEMPOTENT },
+    { "card.io", 0, API_IDEMPOTENT },
+    { "card.led", 0, API_IDEMPOTENT },
+    { "card.location", 256, API_IDEMPOTENT },
+    { "card.location.mode", 0, API_IDEMPOTENT },
+    { "card.location.track", 0, API_IDEMPOTENT },
+    { "card.monitor", 0, API_IDEMPOTENT },
+    { "card.motion", 0, 0 },
+    { "card.motion.mode", 0, API_IDEMPOTENT },
+    { "card.motion.sync", 0, API_IDEMPOTENT },
+    { "card.motion.track", 0, API_IDEMPOTENT },
+    { "card.power", 0, API_IDEMPOTENT },
+    { "card.random", 0, API_IDEMPOTENT },
+    { "card.restart", 0, 0 },
+    { "card.restore", 0, 0 },
+    { "card.status", 256, API_IDEMPOTENT },
+    { "card.temp", 0, API_IDEMPOTENT },
+    { "card.time", 0, API_IDEMPOTENT },
+    { "card.transport", 0, API_IDEMPOTENT },
+    { "card.triangulate", 0, API_IDEMPOTENT },
+    { "card.usage.get", 256, API_IDEMPOTENT },
+    { "card.usage.test", 256, API_IDEMPOTENT },
+    { "card.version", 512, API_IDEMPOTENT },
+    { "card.voltage", 256, API_IDEMPOTENT },
+    { "card.wifi", 0, API_IDEMPOTENT },
+    { "card.wireless", 384, API_IDEMPOTENT },
+    { "card.wireless.penalty", 0, API_IDEMPOTENT },
+    { "dfu.get", 0, API_IDEMPOTENT },
+    { "dfu.status", 256, API_IDEMPOTENT },
+    { "env.default", 0, API_IDEMPOTENT },
+    { "env.get", 0, API_IDEMPOTENT },
+    { "env.modified", 0, API_IDEMPOTENT },
+    { "env.set", 0, API_IDEMPOTENT },
+    { "env.template", 0, API_IDEMPOTENT },
+    { "file.changes", 256, API_IDEMPOTENT },
+    { "file.changes.pending", 256, API_IDEMPOTENT },
+    { "file.delete", 0, 0 },
+    { "file.stats", 0, API_IDEMPOTENT },
+    { "hub.get", 256, API_IDEMPOTENT },
+    { "hub.log", 0, 0 },
+    { "hub.set", 0, API_IDEMPOTENT },
+    { "hub.signal", 0, API_IDEMPOTENT },
+    { "hub.status", 0, API_IDEMPOTENT },
+    { "hub.sync", 0, API_IDEMPOTENT },
+    { "hub.sync.status", 0, API_IDEMPOTENT },
+    { "note.add", 0, API_TIMEOUT_ARGS },
+    { "note.changes", 512, API_IDEMPOTENT },
+    { "note.delete", 0, 0 },
+    { "note.get", 0, 0 },
+    { "note.template", 0, API_IDEMPOTENT },
+    { "note.update", 0, API_IDEMPOTENT },
+    { "ntn.gps", 0, API_IDEMPOTENT },
+    { "ntn.reset", 0, 0 },
+    { "ntn.status", 0, API_IDEMPOTENT },
+    { "var.delete", 0, 0 },
+    { "var.get", 0, API_IDEMPOTENT },
+    { "var.set", 0, API_IDEMPOTENT },
+    { "web", 0, 0 },
+    { "web.", 0, API_TIMEOUT_ARGS },
+    { "web.delete", 0, API_TIMEOUT_ARGS },
+    { "web.get", 0, API_IDEMPOTENT | API_TIMEOUT_ARGS },
+    { "web.post", 0, API_TIMEOUT_ARGS },
+    { "web.put", 0, API_TIMEOUT_ARGS },
+};
+#define NOTE_APIS (sizeof(noteApis) / sizeof(noteApis[0]))
+
+// Describes the APIs that aren't in the table, which are neither assumed to be
+// safe to resend nor given a timeout by their arguments
+static const _noteApiDescriptor noteApiUnknown = { "", 0, 0 };
+
+/*!
+ @internal
+
+ @brief Search the API table.
+
+ @param api The name of the API.
+ @param apiLen The length of the name.
+
+ @returns The descriptor of the API, or NULL if it isn't in the table.
+ */
+static const _noteApiDescriptor *_noteApiSearch(const char *api, size_t apiLen)
+{
+    size_t lo = 0;
+    size_t hi = NOTE_APIS;
+    while (lo < hi) {
+        const size_t mid = (lo + ((hi - lo) / 2));
+        int cmp = strncmp(api, noteApis[mid].name, apiLen);
+        if (cmp == 0 && noteApis[mid].name[apiLen] != '\0') {
+            cmp = -1;
+        }
+        if (cmp == 0) {
+            return &noteApis[mid];
+        }
+        if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = (mid + 1);
+        }
+    }
+    return NULL;
+}
+
+/*!
+ @internal
+
+ @brief Look up the descriptor of a Notecard API.
+
+ @param api The name of the API, such as "note.add".
+
+ @returns The descriptor of the API, of its family (such as "web.") if the API
+          has no entry of its own, or of an unknown API. Never NULL.
+ */
+const _noteApiDescriptor *_noteApiLookup(const char *api)
+{
+    if (api == NULL) {
+        return &noteApiUnknown;
+    }
+
+    const size_t apiLen = strlen(api);
+    const _noteApiDescriptor *desc = _noteApiSearch(api, apiLen);
+    if (desc == NULL) {
+        const char *dot = strchr(api, '.');
+        if (dot != NULL && (size_t)(dot - api + 1) < apiLen) {
+            desc = _noteApiSearch(api, (size_t)(dot - api + 1));
+        }
+    }
+    return ((desc != NULL) ? desc : &noteApiUnknown);
+}
+
+/*!
+ @internal
+
+ @brief Get the index of a descriptor in the API table.
+
+ @param api The descriptor, as returned by `_noteApiLookup`.
+
+ @returns The index of the descriptor, or 0xFFFF if the API is unknown.
+ */
+uint16_t _noteApiIndex(const _noteApiDescriptor *api)
+{
+    if (api < noteApis || api >= (noteApis + NOTE_APIS)) {
+        return 0xFFFF;
+    }
+    return (uint16_t)(api - noteApis);
+}
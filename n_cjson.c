@@ -349,6 +349,8 @@ typedef struct {
     Jbool noalloc;
     Jbool format; /* is this print a formatted print */
     Jbool omitempty;
+    JPrintSinkFn sink; /* when set, full buffers are flushed here instead of growing */
+    void *sink_context;
 } printbuffer;
 
 /* realloc printbuffer if necessary to have at least "needed" bytes more */
@@ -376,23 +378,31 @@ NOTE_C_STATIC unsigned char* _ensure(printbuffer * const p, size_t needed)
         return p->buffer + p->offset;
     }
 
+    if (p->sink != NULL) {
+        /* flush what has been printed so far and restart at the top of the buffer */
+        if (p->offset > 0) {
+            if (!p->sink(p->sink_context, (const char*)p->buffer, p->offset)) {
+                return NULL;
+            }
+            needed -= p->offset;
+            p->offset = 0;
+        }
+        return (needed <= p->length) ? p->buffer : NULL;
+    }
+
     if (p->noalloc) {
         return NULL;
     }
 
-    /* otherwise reallocate manually */
-    newsize = (ALLOC_CHUNK * ((needed / ALLOC_CHUNK) + ((needed % ALLOC_CHUNK) > 0)));  // chunked, linear calculation for new buffer to reduce memory waste
-    newbuffer = (unsigned char*)_Malloc(newsize);
+    /* otherwise reallocate, in ALLOC_CHUNK blocks to reduce memory waste */
+    newsize = _noteAllocGrowLen(p->length, needed);
+    newbuffer = (unsigned char*)_Realloc(p->buffer, p->offset + 1, newsize);
     if (!newbuffer) {
         _Free(p->buffer);
         p->length = 0;
         p->buffer = NULL;
         return NULL;
     }
-    if (newbuffer) {
-        memcpy(newbuffer, p->buffer, p->offset + 1);
-    }
-    _Free(p->buffer);
 
     p->length = newsize;
     p->buffer = newbuffer;
@@ -744,6 +754,83 @@ void _n_htoa16(uint16_t n, unsigned char *p)
     *p = '\0';
 }
 
+/* Render a single character, escaping it if needed. Writes at most 6
+ * characters plus a null-terminator, and returns the number of characters
+ * written (excluding the null-terminator). */
+NOTE_C_STATIC size_t _print_char(const unsigned char c, unsigned char * const output_pointer)
+{
+    if ((c > 31) && (c != '\"') && (c != '\\')) {
+        /* normal character, copy */
+        output_pointer[0] = c;
+        return 1;
+    }
+
+    /* character needs to be escaped */
+    output_pointer[0] = '\\';
+    switch (c) {
+    case '\\':
+        output_pointer[1] = '\\';
+        break;
+    case '\"':
+        output_pointer[1] = '\"';
+        break;
+    case '\b':
+        output_pointer[1] = 'b';
+        break;
+    case '\f':
+        output_pointer[1] = 'f';
+        break;
+    case '\n':
+        output_pointer[1] = 'n';
+        break;
+    case '\r':
+        output_pointer[1] = 'r';
+        break;
+    case '\t':
+        output_pointer[1] = 't';
+        break;
+    default:
+        /* escape and print as unicode codepoint */
+        output_pointer[1] = 'u';
+        _n_htoa16(c, &output_pointer[2]);
+        return 6;
+    }
+    return 2;
+}
+
+/* Render a string one character at a time, for strings that are longer than
+ * the buffer of a printbuffer that flushes to a sink. */
+NOTE_C_STATIC Jbool _print_string_segmented(const unsigned char * const input, printbuffer * const output_buffer)
+{
+    const unsigned char *input_pointer = NULL;
+    unsigned char *output_pointer = _ensure(output_buffer, 1);
+
+    if (output_pointer == NULL) {
+        return false;
+    }
+    *output_pointer = '\"';
+    output_buffer->offset++;
+
+    for (input_pointer = input; *input_pointer != '\0'; input_pointer++) {
+        /* reserve room for the longest escape sequence */
+        output_pointer = _ensure(output_buffer, 6);
+        if (output_pointer == NULL) {
+            return false;
+        }
+        output_buffer->offset += _print_char(*input_pointer, output_pointer);
+    }
+
+    /* the closing quote is accounted for by the caller's _update_offset */
+    output_pointer = _ensure(output_buffer, 1);
+    if (output_pointer == NULL) {
+        return false;
+    }
+    output_pointer[0] = '\"';
+    output_pointer[1] = '\0';
+
+    return true;
+}
+
 /* Render the cstring provided to an escaped version that can be printed. */
 NOTE_C_STATIC Jbool _print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
 {
@@ -794,6 +881,11 @@ NOTE_C_STATIC Jbool _print_string_ptr(const unsigned char * const input, printbu
     }
     output_length = (size_t)(input_pointer - input) + escape_characters;
 
+    /* strings that can never fit are split across segments when printing to a sink */
+    if ((output_buffer->sink != NULL) && ((output_length + 3) > output_buffer->length)) {
+        return _print_string_segmented(input, output_buffer);
+    }
+
     output = _ensure(output_buffer, output_length + 2);  // sizeof("\"\"")
     if (output == NULL) {
         return false;
@@ -812,43 +904,8 @@ NOTE_C_STATIC Jbool _print_string_ptr(const unsigned char * const input, printbu
     output[0] = '\"';
     output_pointer = output + 1;
     /* copy the string */
-    for (input_pointer = input; *input_pointer != '\0'; (void)input_pointer++, output_pointer++) {
-        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\')) {
-            /* normal character, copy */
-            *output_pointer = *input_pointer;
-        } else {
-            /* character needs to be escaped */
-            *output_pointer++ = '\\';
-            switch (*input_pointer) {
-            case '\\':
-                *output_pointer = '\\';
-                break;
-            case '\"':
-                *output_pointer = '\"';
-                break;
-            case '\b':
-                *output_pointer = 'b';
-                break;
-            case '\f':
-                *output_pointer = 'f';
-                break;
-            case '\n':
-                *output_pointer = 'n';
-                break;
-            case '\r':
-                *output_pointer = 'r';
-                break;
-            case '\t':
-                *output_pointer = 't';
-                break;
-            default:
-                /* escape and print as unicode codepoint */
-                *output_pointer++ = 'u';
-                _n_htoa16(*input_pointer, output_pointer);
-                output_pointer += 4;
-                break;
-            }
-        }
+    for (input_pointer = input; *input_pointer != '\0'; input_pointer++) {
+        output_pointer += _print_char(*input_pointer, output_pointer);
     }
     output[output_length + 1] = '\"';
     output[output_length + 2] = '\0';
@@ -1070,7 +1127,7 @@ N_CJSON_PUBLIC(char *) JPrintUnformattedOmitEmpty(const J *item)
 
 N_CJSON_PUBLIC(char *) JPrintBuffered(const J *item, int prebuffer, Jbool fmt)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, 0 };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
     if (item == NULL) {
         return NULL;
@@ -1100,7 +1157,7 @@ N_CJSON_PUBLIC(char *) JPrintBuffered(const J *item, int prebuffer, Jbool fmt)
 
 NOTE_C_STATIC Jbool _printPreallocated(J *item, char *buf, const int len, const Jbool fmt, const Jbool omit)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, 0 };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
     if (item == NULL) {
         return false;
@@ -1129,6 +1186,34 @@ N_CJSON_PUBLIC(Jbool) JPrintPreallocated(J *item, char *buf, const int len, cons
     return _printPreallocated(item, buf, len, fmt, false);
 }
 
+N_CJSON_PUBLIC(int) JPrintToSink(J *item, char *buf, const int len, const Jbool fmt, JPrintSinkFn sink, void *context)
+{
+    printbuffer p = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    if ((item == NULL) || (sink == NULL)) {
+        return -1;
+    }
+    /* the buffer must hold at least the longest escape sequence */
+    if ((len < 8) || (buf == NULL)) {
+        return -1;
+    }
+
+    p.buffer = (unsigned char*)buf;
+    p.length = (size_t)len;
+    p.offset = 0;
+    p.noalloc = true;
+    p.format = fmt;
+    p.sink = sink;
+    p.sink_context = context;
+
+    if (!_print_value(item, &p)) {
+        return -1;
+    }
+    _update_offset(&p);
+
+    return (int)p.offset;
+}
+
 /* Parser core - when encountering text, process appropriately. */
 NOTE_C_STATIC Jbool _parse_value(J * const item, parse_buffer * const input_buffer)
 {
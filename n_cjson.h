@@ -102,6 +102,9 @@ typedef struct JHooks {
 
 typedef int Jbool;
 
+/* Receives each completed segment of output from JPrintToSink. Return false to abort printing. */
+typedef Jbool (*JPrintSinkFn)(void *context, const char *data, size_t length);
+
 #if !defined(__WINDOWS__) && (defined(WIN32) || defined(WIN64) || defined(_MSC_VER) || defined(_WIN32))
 #define __WINDOWS__
 #endif
@@ -201,6 +204,10 @@ N_CJSON_PUBLIC(char *) JPrintBuffered(const J *item, int prebuffer, Jbool fmt);
 /* NOTE: J is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
 N_CJSON_PUBLIC(Jbool) JPrintPreallocated(J *item, char *buffer, const int length, const Jbool format);
 N_CJSON_PUBLIC(Jbool) JPrintPreallocatedOmitEmpty(J *item, char *buffer, const int length, const Jbool format);
+/* Render a J entity to text through a buffer of the given length, passing each full segment to sink so the whole text never needs to be in memory. */
+/* The final segment is left null-terminated in the buffer for the caller to amend or emit, and its length is returned. Returns -1 on failure. */
+/* Strings are split across segments as needed, but every other value must fit in the buffer. */
+N_CJSON_PUBLIC(int) JPrintToSink(J *item, char *buffer, const int length, const Jbool format, JPrintSinkFn sink, void *context);
 /* Delete a J entity and all subentities. */
 N_CJSON_PUBLIC(void) JDelete(J *c);
 
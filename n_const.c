@@ -15,6 +15,7 @@
 
 const char *c_bad = "bad";
 const char *c_badbinerr = "{bad-bin}";
+const char *c_busy = "{busy}";
 const char *c_cmd = "cmd";
 const char *c_err = "err";
 const char *c_false = "false";
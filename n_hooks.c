@@ -68,6 +68,12 @@ mutexFn hookLockNote = NULL;
 /**************************************************************************/
 mutexFn hookUnlockNote = NULL;
 //**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's Notecard try-lock function.
+*/
+/**************************************************************************/
+tryMutexFn hookTryLockNote = NULL;
+//**************************************************************************/
 /*!
   @brief  Hook for the calling platform's transaction initiation function.
 */
@@ -92,6 +98,12 @@ NOTE_C_STATIC mallocFn hookMalloc = NULL;
 /**************************************************************************/
 NOTE_C_STATIC freeFn hookFree = NULL;
 //**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's memory reallocation function.
+*/
+/**************************************************************************/
+NOTE_C_STATIC reallocFn hookRealloc = NULL;
+//**************************************************************************/
 /*!
   @brief  Hook for the calling platform's delay function.
 */
@@ -139,6 +151,43 @@ NOTE_C_STATIC serialAvailableFn hookSerialAvailable = NULL;
 /**************************************************************************/
 NOTE_C_STATIC serialReceiveFn hookSerialReceive = NULL;
 //**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's Serial available count function.
+*/
+/**************************************************************************/
+NOTE_C_STATIC serialAvailableCountFn hookSerialAvailableCount = NULL;
+//**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's Serial bulk receive function.
+*/
+/**************************************************************************/
+NOTE_C_STATIC serialReceiveBufferFn hookSerialReceiveBuffer = NULL;
+// Bytes read by the bulk receive hook that haven't been consumed yet. Reads
+// are staged here because a read may return bytes beyond the end of the
+// packet being received.
+static uint8_t serialRxBuf[NOTE_C_SERIAL_RX_BUFFER_LEN];
+static size_t serialRxOff = 0;
+static size_t serialRxLen = 0;
+static bool _noteSerialFill(void);
+//**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's vectored Serial transmit function.
+*/
+/**************************************************************************/
+NOTE_C_STATIC serialTransmitVectorFn hookSerialTransmitVector = NULL;
+//**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's vectored I2C transmit function.
+*/
+/**************************************************************************/
+NOTE_C_STATIC i2cTransmitVectorFn hookI2CTransmitVector = NULL;
+//**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's I2C data-ready wait function.
+*/
+/**************************************************************************/
+NOTE_C_STATIC waitForDataFn hookWaitForData = NULL;
+//**************************************************************************/
 /*!
   @brief  Hook for the calling platform's I2C address.
 */
@@ -177,6 +226,12 @@ NOTE_C_STATIC i2cReceiveFn hookI2CReceive = NULL;
 NOTE_C_STATIC heartbeatFn hookHeartbeat = NULL;
 NOTE_C_STATIC void *hookHeartbeatContext = NULL;
 #endif
+//**************************************************************************/
+/*!
+  @brief  Hook for the calling platform's CRC32 function, if any.
+*/
+/**************************************************************************/
+NOTE_C_STATIC crc32Fn hookCrc32 = NULL;
 #ifndef NOTE_NODEBUG
 //**************************************************************************/
 /*!
@@ -184,6 +239,40 @@ NOTE_C_STATIC void *hookHeartbeatContext = NULL;
 */
 /**************************************************************************/
 NOTE_C_STATIC int noteLogLevel = NOTE_C_LOG_LEVEL;
+
+// Deferred debug output. The ring holds output written by NoteDebug until
+// NoteDebugFlush passes it to the debug output hook. One slot is always left
+// empty so that a full ring can be told apart from an empty one. Only a writer
+// moves the head and only NoteDebugFlush moves the tail, so the two may run
+// concurrently without a lock: each side publishes its index with a release
+// store only once it is done with the ring, and reads the other side's index
+// with an acquire load. Writers are serialized by a flag that is only ever
+// tried, so that logging never waits, and output written while another task
+// holds it is dropped. Without C11 atomics the indices are only volatile,
+// which is enough for a single writer on a single core.
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__) && !defined(NOTE_C_NO_ATOMICS)
+#include <stdatomic.h>
+typedef _Atomic uint32_t _noteDebugIndex;
+#define _debugLoad(p) atomic_load_explicit((p), memory_order_acquire)
+#define _debugStore(p, v) atomic_store_explicit((p), (v), memory_order_release)
+#define _debugCount(p) atomic_fetch_add_explicit((p), 1, memory_order_relaxed)
+static atomic_flag debugWriting = ATOMIC_FLAG_INIT;
+#define _debugWriterTake() (!atomic_flag_test_and_set_explicit(&debugWriting, memory_order_acquire))
+#define _debugWriterGive() atomic_flag_clear_explicit(&debugWriting, memory_order_release)
+#else
+typedef volatile uint32_t _noteDebugIndex;
+#define _debugLoad(p) (*(p))
+#define _debugStore(p, v) (*(p) = (v))
+#define _debugCount(p) ((*(p))++)
+static volatile bool debugWriting = false;
+#define _debugWriterTake() (debugWriting ? false : (debugWriting = true))
+#define _debugWriterGive() (debugWriting = false)
+#endif
+static char *debugRing = NULL;
+static uint32_t debugRingSize = 0;
+static _noteDebugIndex debugRingHead = 0;
+static _noteDebugIndex debugRingTail = 0;
+static _noteDebugIndex debugDropped = 0;
 #endif
 
 // Internal hooks
@@ -274,6 +363,13 @@ void NoteSetFn(mallocFn mallocHook, freeFn freeHook, delayMsFn delayMsHook,
     _UnlockNote();
 }
 
+void NoteSetFnRealloc(reallocFn reallocHook)
+{
+    _LockNote();
+    hookRealloc = reallocHook;
+    _UnlockNote();
+}
+
 #ifdef NOTE_C_HEARTBEAT_CALLBACK
 //**************************************************************************/
 /*!
@@ -291,6 +387,13 @@ void NoteSetFnHeartbeat(heartbeatFn fn, void *context)
 }
 #endif
 
+void NoteSetFnCRC32(crc32Fn fn)
+{
+    _LockNote();
+    hookCrc32 = fn;
+    _UnlockNote();
+}
+
 void NoteSetFnDebugOutput(debugOutputFn fn)
 {
     _LockNote();
@@ -338,6 +441,11 @@ void NoteSetFnNoteMutex(mutexFn lockFn, mutexFn unlockFn)
     hookUnlockNote = unlockFn;
 }
 
+void NoteSetFnNoteTryLock(tryMutexFn tryLockFn)
+{
+    hookTryLockNote = tryLockFn;
+}
+
 void NoteSetFnSerial(serialResetFn resetFn, serialTransmitFn transmitFn,
                      serialAvailableFn availFn, serialReceiveFn receiveFn)
 {
@@ -471,17 +579,121 @@ void NoteDebugln(const char *msg)
 #endif // !NOTE_NODEBUG
 }
 
+#ifndef NOTE_NODEBUG
+/*!
+ @internal
+
+ @brief Append debug output to the deferred output ring, or drop it if it
+        doesn't fit.
+
+ @param msg The debug output.
+ */
+static void _noteDebugDefer(const char *msg)
+{
+    if (msg == NULL) {
+        return;
+    }
+    if (!_debugWriterTake()) {
+        _debugCount(&debugDropped);
+        return;
+    }
+    const uint32_t len = (uint32_t)strlen(msg);
+    const uint32_t head = _debugLoad(&debugRingHead);
+    const uint32_t tail = _debugLoad(&debugRingTail);
+    const uint32_t used = ((head >= tail) ? (head - tail) : (debugRingSize - tail + head));
+    if (len > (debugRingSize - 1 - used)) {
+        _debugCount(&debugDropped);
+        _debugWriterGive();
+        return;
+    }
+
+    // Copy up to the end of the ring, then wrap around to the start
+    uint32_t firstLen = (debugRingSize - head);
+    if (firstLen > len) {
+        firstLen = len;
+    }
+    memcpy(&debugRing[head], msg, firstLen);
+    memcpy(debugRing, &msg[firstLen], (len - firstLen));
+
+    // Publish the output only once it has been copied
+    _debugStore(&debugRingHead, ((head + len) % debugRingSize));
+    _debugWriterGive();
+}
+#endif // !NOTE_NODEBUG
+
 void NoteDebug(const char *msg)
 {
 #ifndef NOTE_NODEBUG
     if (_noteIsDebugOutputActive()) {
-        hookDebugOutput(msg);
+        if (debugRing != NULL) {
+            _noteDebugDefer(msg);
+        } else {
+            hookDebugOutput(msg);
+        }
     }
 #else
     (void)msg;
 #endif // !NOTE_NODEBUG
 }
 
+void NoteSetDebugBuffer(char *buffer, size_t size)
+{
+#ifndef NOTE_NODEBUG
+    _LockNote();
+    NoteDebugFlush();
+    if (buffer == NULL || size < 2) {
+        debugRing = NULL;
+        debugRingSize = 0;
+    } else {
+        debugRing = buffer;
+        debugRingSize = (uint32_t)size;
+    }
+    _debugStore(&debugRingHead, 0);
+    _debugStore(&debugRingTail, 0);
+    _UnlockNote();
+#else
+    (void)buffer;
+    (void)size;
+#endif // !NOTE_NODEBUG
+}
+
+size_t NoteDebugFlush(void)
+{
+    size_t flushed = 0;
+#ifndef NOTE_NODEBUG
+    // The debug output hook takes a string, so output is passed to it in
+    // terminated chunks
+    char chunk[64];
+    const uint32_t head = _debugLoad(&debugRingHead);
+    uint32_t tail = _debugLoad(&debugRingTail);
+    while (tail != head) {
+        uint32_t len = ((head > tail) ? (head - tail) : (debugRingSize - tail));
+        if (len > (sizeof(chunk) - 1)) {
+            len = (sizeof(chunk) - 1);
+        }
+        memcpy(chunk, &debugRing[tail], len);
+        chunk[len] = '\0';
+        tail = ((tail + len) % debugRingSize);
+        _debugStore(&debugRingTail, tail);
+        debugOutputFn fn = hookDebugOutput;
+        if (fn != NULL) {
+            fn(chunk);
+        }
+        flushed += len;
+    }
+#endif // !NOTE_NODEBUG
+    return flushed;
+}
+
+uint32_t NoteDebugDropped(void)
+{
+#ifndef NOTE_NODEBUG
+    return _debugLoad(&debugDropped);
+#else
+    return 0;
+#endif // !NOTE_NODEBUG
+}
+
 void NoteDebugWithLevel(uint8_t level, const char *msg)
 {
 #ifndef NOTE_NODEBUG
@@ -608,6 +820,104 @@ void NoteFree(void *ptr)
     }
 }
 
+/*!
+ @internal
+
+ @brief Resize memory allocated with `NoteMalloc`, using the platform-specific
+        reallocation hook if one is set, and otherwise allocating new memory,
+        copying the bytes in use and freeing the old memory.
+
+ @param ptr The memory to resize, or NULL.
+ @param used The number of bytes in use at `ptr`, which are preserved.
+ @param size The number of bytes to resize the memory to.
+
+ @returns A pointer to the resized memory, or NULL on failure, in which case
+          `ptr` is left allocated.
+ */
+void *_noteRealloc(void *ptr, size_t used, size_t size)
+{
+    if (hookRealloc != NULL) {
+        return hookRealloc(ptr, size);
+    }
+    void *p = NoteMalloc(size);
+    if (p != NULL && ptr != NULL) {
+        memcpy(p, ptr, ((used < size) ? used : size));
+        NoteFree(ptr);
+    }
+    return p;
+}
+
+/*!
+ @internal
+
+ @brief Determine the new length of a growing buffer.
+
+ With `NOTE_C_ALLOC_GROWTH_GEOMETRIC`, the buffer grows by at least half its
+ length, so that a buffer grown a byte at a time is copied a bounded number of
+ times. Otherwise, it grows by just enough `ALLOC_CHUNK` blocks, to waste the
+ least memory.
+
+ @param allocLen The current length of the buffer.
+ @param needed The length the buffer must at least have.
+
+ @returns The new length, a multiple of `ALLOC_CHUNK`.
+ */
+size_t _noteAllocGrowLen(size_t allocLen, size_t needed)
+{
+#if NOTE_C_ALLOC_GROWTH_GEOMETRIC
+    if (needed < (allocLen + (allocLen / 2))) {
+        needed = (allocLen + (allocLen / 2));
+    }
+#else
+    (void)allocLen;
+#endif
+    return (ALLOC_CHUNK * ((needed / ALLOC_CHUNK) + ((needed % ALLOC_CHUNK) > 0)));
+}
+
+/*!
+ @internal
+
+ @brief Make room in a response buffer for more of the response.
+
+ The first block is large enough for the expected response, so that the
+ typical response is received without growing the buffer. Space for the
+ NULL-terminator the JSON parser requires is always left beyond `allocLen`.
+
+ @param buf (in/out) The buffer, or NULL if none has been allocated yet. It is
+        freed and set to NULL if it can't be grown.
+ @param len The number of bytes already received into the buffer.
+ @param allocLen (in/out) The length of the buffer, excluding the space for the
+        NULL-terminator.
+ @param needed The number of additional bytes to make room for.
+ @param sizeHint The expected length of the response, or 0.
+
+ @returns A c-string with an error, or `NULL` if no error ocurred.
+ */
+const char *_noteResponseBufGrow(uint8_t **buf, uint32_t len, uint32_t *allocLen, uint32_t needed, uint32_t sizeHint)
+{
+    size_t newLen;
+    if (*buf == NULL) {
+        newLen = _noteAllocGrowLen(0, ((needed > sizeHint) ? needed : sizeHint));
+    } else {
+        newLen = _noteAllocGrowLen(*allocLen, (*allocLen + needed));
+    }
+
+    uint8_t *newBuf = (uint8_t *)_Realloc(*buf, len, (newLen + 1));
+    if (newBuf == NULL) {
+        const char *err = ERRSTR("transaction: jsonbuf malloc failed", c_mem);
+        NOTE_C_LOG_ERROR(err);
+        _Free(*buf);
+        *buf = NULL;
+        return err;
+    }
+    if (*buf != NULL) {
+        NOTE_C_LOG_DEBUG("additional receive buffer chunk allocated");
+    }
+    *buf = newBuf;
+    *allocLen = (uint32_t)newLen;
+    return NULL;
+}
+
 //**************************************************************************/
 /*!
   @brief  Lock the I2C bus using the platform-specific hook.
@@ -649,30 +959,195 @@ bool _noteHeartbeat(const char *heartbeatJson)
 }
 #endif
 
+#ifndef NOTE_C_LOW_MEM
 //**************************************************************************/
 /*!
-  @brief  Lock the Notecard using the platform-specific hook.
+  @brief  Compute a CRC32 using the platform-specific hook, if set, or the
+  built-in tables otherwise.
+  @param   crc The CRC32 of the preceding pieces, or 0 for the first piece.
+  @param   data The buffer.
+  @param   length The length of the buffer.
+  @returns  The CRC32 of the buffer up to and including this piece.
 */
 /**************************************************************************/
-void _noteLockNote(void)
+uint32_t _noteCrc32(uint32_t crc, const uint8_t *data, size_t length)
 {
+    if (hookCrc32 != NULL) {
+        return hookCrc32(crc, data, length);
+    }
+    return _crc32Compute(crc, data, length);
+}
+#endif
+
+// A thread waiting for its turn with the Notecard
+typedef struct _noteWaiter {
+    struct _noteWaiter *next;
+} _noteWaiter;
+
+// Request scheduling state, guarded by the platform's Notecard mutex
+static bool scheduleRequests = false;
+static bool schedulerBusy = false;
+static _noteWaiter *schedulerQueue[NOTE_C_PRIORITY_CLASSES];
+
+//**************************************************************************/
+/*!
+  @brief  Take the platform's Notecard mutex.
+  @param   timeoutMs
+  The longest time to wait, or 0 to wait for as long as it takes. Only
+  honored when there is a try-lock hook.
+  @returns `true` if the mutex was taken.
+*/
+/**************************************************************************/
+static bool _noteMutexLock(uint32_t timeoutMs)
+{
+    if (timeoutMs != 0 && hookTryLockNote != NULL) {
+        return hookTryLockNote(timeoutMs);
+    }
     if (hookLockNote != NULL) {
         hookLockNote();
     }
+    return true;
 }
 
 //**************************************************************************/
 /*!
-  @brief  Unlock the Notecard using the platform-specific hook.
+  @brief  Release the platform's Notecard mutex.
 */
 /**************************************************************************/
-void _noteUnlockNote(void)
+static void _noteMutexUnlock(void)
 {
     if (hookUnlockNote != NULL) {
         hookUnlockNote();
     }
 }
 
+//**************************************************************************/
+/*!
+  @brief  Determine whether it's a waiter's turn with the Notecard, which is
+  when the Notecard is free, the waiter is first in its class and no class of
+  higher priority has waiters. Called with the mutex held.
+  @param   priority
+  The priority class of the waiter.
+  @param   waiter
+  The waiter.
+  @returns `true` if it's the waiter's turn.
+*/
+/**************************************************************************/
+static bool _noteSchedulerTurn(uint8_t priority, const _noteWaiter *waiter)
+{
+    if (schedulerBusy || schedulerQueue[priority] != waiter) {
+        return false;
+    }
+    for (uint8_t i = 0 ; i < priority ; ++i) {
+        if (schedulerQueue[i] != NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//**************************************************************************/
+/*!
+  @brief  Lock the Notecard using the platform-specific hook.
+*/
+/**************************************************************************/
+void _noteLockNote(void)
+{
+    (void)_noteLockNotePriority(NOTE_C_PRIORITY_NORMAL, 0);
+}
+
+//**************************************************************************/
+/*!
+  @brief  Lock the Notecard, waiting for it in a priority class when request
+  scheduling is enabled.
+  @param   priority
+  The priority class of the caller.
+  @param   timeoutMs
+  The longest time to wait, or 0 to wait for as long as it takes.
+  @returns `true` if the Notecard was locked, and `false` if the wait timed out.
+*/
+/**************************************************************************/
+bool _noteLockNotePriority(uint8_t priority, uint32_t timeoutMs)
+{
+    if (!scheduleRequests) {
+        return _noteMutexLock(timeoutMs);
+    }
+    if (priority >= NOTE_C_PRIORITY_CLASSES) {
+        priority = (NOTE_C_PRIORITY_CLASSES - 1);
+    }
+
+    // Join the back of the queue of the class. The mutex is only ever held
+    // briefly while scheduling, so the wait for it isn't bounded.
+    const uint32_t startMs = _GetMs();
+    _noteWaiter waiter = { NULL };
+    _noteMutexLock(0);
+    _noteWaiter **link = &schedulerQueue[priority];
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+    *link = &waiter;
+
+    uint32_t pollMs = NOTE_C_SCHEDULER_POLL_MS;
+    for (;;) {
+        if (_noteSchedulerTurn(priority, &waiter)) {
+            schedulerQueue[priority] = waiter.next;
+            schedulerBusy = true;
+            _noteMutexUnlock();
+            return true;
+        }
+        if (timeoutMs != 0 && (_GetMs() - startMs) >= timeoutMs) {
+            // Leave the queue
+            link = &schedulerQueue[priority];
+            while (*link != &waiter) {
+                link = &(*link)->next;
+            }
+            *link = waiter.next;
+            _noteMutexUnlock();
+            return false;
+        }
+
+        // Back off while the Notecard stays busy, so that a waiter behind a
+        // long transaction doesn't keep taking the mutex, but look again
+        // promptly while it's being handed on
+        const bool busy = schedulerBusy;
+        _noteMutexUnlock();
+        uint32_t delayMs = pollMs;
+        if (timeoutMs != 0 && (timeoutMs - (_GetMs() - startMs)) < delayMs) {
+            delayMs = (timeoutMs - (_GetMs() - startMs));
+        }
+        _DelayMs(delayMs);
+        if (!busy) {
+            pollMs = NOTE_C_SCHEDULER_POLL_MS;
+        } else if (pollMs < NOTE_C_SCHEDULER_POLL_MAX_MS) {
+            pollMs = (((pollMs * 2) < NOTE_C_SCHEDULER_POLL_MAX_MS) ? (pollMs * 2) : NOTE_C_SCHEDULER_POLL_MAX_MS);
+        }
+        _noteMutexLock(0);
+    }
+}
+
+//**************************************************************************/
+/*!
+  @brief  Unlock the Notecard using the platform-specific hook.
+*/
+/**************************************************************************/
+void _noteUnlockNote(void)
+{
+    if (scheduleRequests) {
+        _noteMutexLock(0);
+        schedulerBusy = false;
+        _noteMutexUnlock();
+        return;
+    }
+    _noteMutexUnlock();
+}
+
+bool NoteSetRequestScheduling(bool enable)
+{
+    bool previous = scheduleRequests;
+    scheduleRequests = enable;
+    return previous;
+}
+
 //**************************************************************************/
 /*!
   @brief  Indicate that we're initiating a transaction using the platform-specific hook.
@@ -698,6 +1173,13 @@ void _noteTransactionStop(void)
     }
 }
 
+void NoteGetFnCRC32(crc32Fn *fn)
+{
+    if (fn != NULL) {
+        *fn = hookCrc32;
+    }
+}
+
 void NoteGetFnDebugOutput(debugOutputFn *fn)
 {
     if (fn != NULL) {
@@ -771,6 +1253,13 @@ void NoteGetFnNoteMutex(mutexFn *lockFn, mutexFn *unlockFn)
     }
 }
 
+void NoteGetFnNoteTryLock(tryMutexFn *tryLockFn)
+{
+    if (tryLockFn != NULL) {
+        *tryLockFn = hookTryLockNote;
+    }
+}
+
 void NoteGetFn(mallocFn *mallocHook, freeFn *freeHook, delayMsFn *delayMsHook,
                getMsFn *getMsHook)
 {
@@ -790,6 +1279,15 @@ void NoteGetFn(mallocFn *mallocHook, freeFn *freeHook, delayMsFn *delayMsHook,
     _UnlockNote();
 }
 
+void NoteGetFnRealloc(reallocFn *reallocHook)
+{
+    _LockNote();
+    if (reallocHook != NULL) {
+        *reallocHook = hookRealloc;
+    }
+    _UnlockNote();
+}
+
 void NoteGetFnSerial(serialResetFn *resetFn, serialTransmitFn *transmitFn,
                      serialAvailableFn *availFn, serialReceiveFn *receiveFn)
 {
@@ -809,6 +1307,65 @@ void NoteGetFnSerial(serialResetFn *resetFn, serialTransmitFn *transmitFn,
     _UnlockNote();
 }
 
+void NoteSetFnSerialReceiveBuffer(serialAvailableCountFn availCountFn,
+                                  serialReceiveBufferFn receiveBufferFn)
+{
+    _LockNote();
+    hookSerialAvailableCount = availCountFn;
+    hookSerialReceiveBuffer = receiveBufferFn;
+    serialRxLen = 0;
+    _UnlockNote();
+}
+
+void NoteGetFnSerialReceiveBuffer(serialAvailableCountFn *availCountFn,
+                                  serialReceiveBufferFn *receiveBufferFn)
+{
+    _LockNote();
+    if (availCountFn != NULL) {
+        *availCountFn = hookSerialAvailableCount;
+    }
+    if (receiveBufferFn != NULL) {
+        *receiveBufferFn = hookSerialReceiveBuffer;
+    }
+    _UnlockNote();
+}
+
+void NoteSetFnTransmitVector(serialTransmitVectorFn serialFn, i2cTransmitVectorFn i2cFn)
+{
+    _LockNote();
+    hookSerialTransmitVector = serialFn;
+    hookI2CTransmitVector = i2cFn;
+    _UnlockNote();
+}
+
+void NoteGetFnTransmitVector(serialTransmitVectorFn *serialFn, i2cTransmitVectorFn *i2cFn)
+{
+    _LockNote();
+    if (serialFn != NULL) {
+        *serialFn = hookSerialTransmitVector;
+    }
+    if (i2cFn != NULL) {
+        *i2cFn = hookI2CTransmitVector;
+    }
+    _UnlockNote();
+}
+
+void NoteSetFnWaitForData(waitForDataFn fn)
+{
+    _LockNote();
+    hookWaitForData = fn;
+    _UnlockNote();
+}
+
+void NoteGetFnWaitForData(waitForDataFn *fn)
+{
+    _LockNote();
+    if (fn != NULL) {
+        *fn = hookWaitForData;
+    }
+    _UnlockNote();
+}
+
 void NoteGetFnI2C(uint32_t *notecardAddr, uint32_t *maxTransmitSize,
                   i2cResetFn *resetFn, i2cTransmitFn *transmitFn,
                   i2cReceiveFn *receiveFn)
@@ -854,6 +1411,7 @@ void NoteGetI2CMtu(uint32_t *i2cMtu)
 /**************************************************************************/
 bool _noteSerialReset(void)
 {
+    serialRxLen = 0;
     if (hookActiveInterface == NOTE_C_INTERFACE_SERIAL && hookSerialReset != NULL) {
         return hookSerialReset();
     }
@@ -877,6 +1435,26 @@ void _noteSerialTransmit(const uint8_t *text, size_t len, bool flush)
     }
 }
 
+//**************************************************************************/
+/*!
+  @brief  Transmit a gather list over Serial using the platform-specific
+  vectored hook, or one buffer at a time if there is none.
+  @param   iov The buffers to transmit.
+  @param   iovCount The number of buffers.
+  @param   flush `true` to flush the bytes upon transmit.
+*/
+/**************************************************************************/
+void _noteSerialTransmitv(const NoteIoVec *iov, size_t iovCount, bool flush)
+{
+    if (hookActiveInterface == NOTE_C_INTERFACE_SERIAL && hookSerialTransmitVector != NULL) {
+        hookSerialTransmitVector(iov, iovCount, flush);
+        return;
+    }
+    for (size_t i = 0 ; i < iovCount ; ++i) {
+        _noteSerialTransmit(iov[i].data, iov[i].len, (flush && (i == (iovCount - 1))));
+    }
+}
+
 //**************************************************************************/
 /*!
   @brief  Determine if Serial bus is available using the platform-specific
@@ -886,12 +1464,44 @@ void _noteSerialTransmit(const uint8_t *text, size_t len, bool flush)
 /**************************************************************************/
 bool _noteSerialAvailable(void)
 {
+    if (hookActiveInterface == NOTE_C_INTERFACE_SERIAL && hookSerialReceiveBuffer != NULL) {
+        return (serialRxLen > 0 || _noteSerialFill());
+    }
     if (hookActiveInterface == NOTE_C_INTERFACE_SERIAL && hookSerialAvailable != NULL) {
         return hookSerialAvailable();
     }
     return false;
 }
 
+//**************************************************************************/
+/*!
+  @brief  Refill the staging buffer using the platform-specific bulk receive
+  hook.
+  @returns A boolean indicating whether any bytes were received.
+*/
+/**************************************************************************/
+static bool _noteSerialFill(void)
+{
+    size_t max = sizeof(serialRxBuf);
+    if (hookSerialAvailableCount != NULL) {
+        const size_t count = hookSerialAvailableCount();
+        if (count == 0) {
+            return false;
+        }
+        if (count < max) {
+            max = count;
+        }
+    }
+
+    size_t got = 0;
+    if (!hookSerialReceiveBuffer(serialRxBuf, max, &got) || got > max) {
+        got = 0;
+    }
+    serialRxOff = 0;
+    serialRxLen = got;
+    return (got > 0);
+}
+
 //**************************************************************************/
 /*!
   @brief  Obtain a character from the Serial bus using the platform-specific
@@ -901,12 +1511,56 @@ bool _noteSerialAvailable(void)
 /**************************************************************************/
 char _noteSerialReceive(void)
 {
+    if (hookActiveInterface == NOTE_C_INTERFACE_SERIAL && hookSerialReceiveBuffer != NULL) {
+        if (serialRxLen == 0 && !_noteSerialFill()) {
+            return '\0';
+        }
+        serialRxLen--;
+        return (char)serialRxBuf[serialRxOff++];
+    }
     if (hookActiveInterface == NOTE_C_INTERFACE_SERIAL && hookSerialReceive != NULL) {
         return hookSerialReceive();
     }
     return '\0';
 }
 
+//**************************************************************************/
+/*!
+  @brief  Obtain the available characters from the Serial bus, up to and
+  including the next newline.
+  @param   buf A buffer to store the characters.
+  @param   max The size of `buf`, which must be at least 1.
+  @param   eop (out) `true` if the last character stored is a newline.
+  @returns The number of characters stored in `buf`.
+*/
+/**************************************************************************/
+size_t _noteSerialReceiveLine(uint8_t *buf, size_t max, bool *eop)
+{
+    *eop = false;
+
+    // Without a bulk receive hook, data is received a byte at a time
+    if (hookActiveInterface != NOTE_C_INTERFACE_SERIAL || hookSerialReceiveBuffer == NULL) {
+        const char ch = _noteSerialReceive();
+        buf[0] = (uint8_t)ch;
+        *eop = (ch == '\n');
+        return 1;
+    }
+
+    if (serialRxLen == 0 && !_noteSerialFill()) {
+        return 0;
+    }
+    size_t len = ((serialRxLen < max) ? serialRxLen : max);
+    const uint8_t *nl = (const uint8_t *)memchr(&serialRxBuf[serialRxOff], '\n', len);
+    if (nl != NULL) {
+        len = (size_t)(nl - &serialRxBuf[serialRxOff]) + 1;
+        *eop = true;
+    }
+    memcpy(buf, &serialRxBuf[serialRxOff], len);
+    serialRxOff += len;
+    serialRxLen -= len;
+    return len;
+}
+
 //**************************************************************************/
 /*!
   @brief  Reset the I2C bus using the platform-specific hook.
@@ -941,6 +1595,30 @@ const char *_noteI2CTransmit(uint16_t DevAddress, const uint8_t* pBuffer, uint16
     return "i2c not active";
 }
 
+//**************************************************************************/
+/*!
+  @brief  Transmit a gather list over I2C using the platform-specific
+  vectored hook, or one buffer at a time if there is none.
+  @param   DevAddress The I2C address of the device to transmit to.
+  @param   iov The buffers to transmit, each sent as its own I2C write.
+  @param   iovCount The number of buffers.
+  @returns A c-string with an error, or `NULL` if no error ocurred.
+*/
+/**************************************************************************/
+const char *_noteI2CTransmitv(uint16_t DevAddress, const NoteIoVec *iov, size_t iovCount)
+{
+    if (hookActiveInterface == NOTE_C_INTERFACE_I2C && hookI2CTransmitVector != NULL) {
+        return hookI2CTransmitVector(DevAddress, iov, iovCount);
+    }
+    for (size_t i = 0 ; i < iovCount ; ++i) {
+        const char *err = _noteI2CTransmit(DevAddress, iov[i].data, (uint16_t)iov[i].len);
+        if (err != NULL) {
+            return err;
+        }
+    }
+    return NULL;
+}
+
 //**************************************************************************/
 /*!
   @brief  Receive bytes from I2C using the platform-specific hook.
@@ -960,6 +1638,25 @@ const char *_noteI2CReceive(uint16_t DevAddress, uint8_t* pBuffer, uint16_t Size
     return "i2c not active";
 }
 
+//**************************************************************************/
+/*!
+  @brief  Wait for the Notecard to signal that it has data, using the
+  platform-specific hook.
+  @param   timeoutMs The maximum time, in milliseconds, to wait.
+  @param   ready (out) Whether the Notecard signalled before the timeout.
+  @returns `true` if the hook waited, or `false` if there is no hook and the
+  caller must poll instead.
+*/
+/**************************************************************************/
+bool _noteI2CWaitForData(uint32_t timeoutMs, bool *ready)
+{
+    if (hookActiveInterface == NOTE_C_INTERFACE_I2C && hookWaitForData != NULL) {
+        *ready = hookWaitForData(timeoutMs);
+        return true;
+    }
+    return false;
+}
+
 //**************************************************************************/
 /*!
   @brief  Get the I2C address of the Notecard.
@@ -1014,10 +1711,17 @@ uint32_t NoteI2CMax(void)
 /**************************************************************************/
 bool _noteHardReset(void)
 {
+    _StatsAdd(resets, 1);
     if (notecardReset == NULL) {
+        _Trace(NOTE_C_TRACE_RESET, true);
         return true;
     }
-    return notecardReset();
+    const bool success = notecardReset();
+    if (!success) {
+        _StatsAdd(resetFailures, 1);
+    }
+    _Trace(NOTE_C_TRACE_RESET, success);
+    return success;
 }
 
 
@@ -15,9 +15,25 @@
 
 #include "n_lib.h"
 
+// The default pacing is the one every Notecard keeps up with
+#define I2C_PACING_DEFAULT { \
+    CARD_REQUEST_I2C_IO_DELAY_MS, \
+    CARD_REQUEST_I2C_CHUNK_DELAY_MS, \
+    CARD_REQUEST_I2C_SEGMENT_MAX_LEN, \
+    CARD_REQUEST_I2C_SEGMENT_DELAY_MS \
+}
+
+static const NoteI2CPacing defaultI2CPacing = I2C_PACING_DEFAULT;
+static NoteI2CPacing i2cPacing = I2C_PACING_DEFAULT;
+
+// In bus-sharing mode the I2C bus is claimed around each I/O rather than for a
+// whole exchange with the Notecard, which the Notecard lock keeps atomic
+static bool i2cBusSharing = false;
+
 // Forwards
 NOTE_C_STATIC void _delayIO(void);
 NOTE_C_STATIC const char * _i2cNoteQueryLength(uint32_t * available, uint32_t timeoutMs);
+NOTE_C_STATIC void _i2cWaitForData(uint32_t startMs, uint32_t timeoutMs, uint32_t *pollMs);
 
 /**************************************************************************/
 /*!
@@ -29,9 +45,304 @@ NOTE_C_STATIC const char * _i2cNoteQueryLength(uint32_t * available, uint32_t ti
 /**************************************************************************/
 NOTE_C_STATIC void _delayIO(void)
 {
-    if (!cardTurboIO) {
-        _DelayMs(6);
+    if (!cardTurboIO && i2cPacing.ioDelayMs) {
+        _DelayMs(i2cPacing.ioDelayMs);
+    }
+}
+
+void NoteSetI2CPacing(const NoteI2CPacing *pacing)
+{
+    _LockNote();
+    i2cPacing = ((pacing != NULL) ? *pacing : defaultI2CPacing);
+
+    // Normalize the pacing, so that segments are never empty
+    if (i2cPacing.segmentLen == 0) {
+        i2cPacing.segmentLen = defaultI2CPacing.segmentLen;
+    }
+    _UnlockNote();
+}
+
+void NoteGetI2CPacing(NoteI2CPacing *pacing)
+{
+    if (pacing != NULL) {
+        _LockNote();
+        *pacing = i2cPacing;
+        _UnlockNote();
+    }
+}
+
+void NoteSetI2CBusSharing(bool enable)
+{
+    _LockNote();
+    i2cBusSharing = enable;
+    _UnlockNote();
+}
+
+void NoteGetI2CBusSharing(bool *enabled)
+{
+    if (enabled != NULL) {
+        _LockNote();
+        *enabled = i2cBusSharing;
+        _UnlockNote();
+    }
+}
+
+/*!
+ @internal
+
+ @brief Claim the I2C bus for an exchange with the Notecard, unless the bus is
+        shared, in which case it is claimed around each I/O instead.
+ */
+static void _i2cLockExchange(void)
+{
+    if (!i2cBusSharing) {
+        _LockI2C();
+    }
+}
+
+/*!
+ @internal
+
+ @brief Release the I2C bus at the end of an exchange with the Notecard.
+ */
+static void _i2cUnlockExchange(void)
+{
+    if (!i2cBusSharing) {
+        _UnlockI2C();
+    }
+}
+
+/*!
+ @internal
+
+ @brief Reset the I2C peripheral, claiming the bus if it is shared.
+
+ @returns `true` if the reset was successful, `false` if not.
+ */
+static bool _i2cBusReset(void)
+{
+    if (i2cBusSharing) {
+        _LockI2C();
+    }
+    const bool success = _I2CReset(_I2CAddress());
+    if (i2cBusSharing) {
+        _UnlockI2C();
+    }
+    return success;
+}
+
+/*!
+ @internal
+
+ @brief Receive bytes from the Notecard, claiming the bus if it is shared.
+
+ @param buffer A buffer in which to place received bytes.
+ @param size The number of bytes to receive.
+ @param available (out) The number of bytes left to read.
+
+ @returns A c-string with an error, or `NULL` if no error occurred.
+ */
+static const char *_i2cBusReceive(uint8_t *buffer, uint16_t size, uint32_t *available)
+{
+    if (i2cBusSharing) {
+        _LockI2C();
+    }
+    const char *err = _I2CReceive(_I2CAddress(), buffer, size, available);
+    if (i2cBusSharing) {
+        _UnlockI2C();
+    }
+    return err;
+}
+
+/*!
+ @internal
+
+ @brief Transmit bytes to the Notecard, claiming the bus if it is shared.
+
+ @param buffer The bytes to transmit.
+ @param size The number of bytes.
+
+ @returns A c-string with an error, or `NULL` if no error occurred.
+ */
+static const char *_i2cBusTransmit(const uint8_t *buffer, uint16_t size)
+{
+    if (i2cBusSharing) {
+        _LockI2C();
+    }
+    const char *err = _I2CTransmit(_I2CAddress(), buffer, size);
+    if (i2cBusSharing) {
+        _UnlockI2C();
     }
+    return err;
+}
+
+/*!
+ @internal
+
+ @brief Transmit a gather list to the Notecard, claiming the bus if it is
+        shared.
+
+ @param iov The buffers to transmit, each sent as its own I2C write.
+ @param iovCount The number of buffers.
+
+ @returns A c-string with an error, or `NULL` if no error occurred.
+ */
+static const char *_i2cBusTransmitv(const NoteIoVec *iov, size_t iovCount)
+{
+    if (i2cBusSharing) {
+        _LockI2C();
+    }
+    const char *err = _I2CTransmitv(_I2CAddress(), iov, iovCount);
+    if (i2cBusSharing) {
+        _UnlockI2C();
+    }
+    return err;
+}
+
+/*!
+ @internal
+
+ @brief Exchange calibration `echo` requests with the Notecard.
+
+ @returns `true` if every round trip succeeded, `false` at the first failure.
+ */
+static bool _i2cCalibrationTrials(void)
+{
+    for (uint32_t trial = 0 ; trial < NOTE_C_I2C_CALIBRATION_TRIALS ; ++trial) {
+        if (!_noteEcho(NOTE_C_I2C_CALIBRATION_LEN, NOTE_C_I2C_CALIBRATION_TIMEOUT_MS)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NoteCalibrateI2CPacing(i2cPacingSaveFn saveFn)
+{
+    if (NoteGetActiveInterface() != NOTE_C_INTERFACE_I2C) {
+        return false;
+    }
+
+    NoteI2CPacing previous;
+    NoteGetI2CPacing(&previous);
+
+    // The first candidate has no pauses at all, and each one after it halves
+    // the distance to the default pacing, which is the last
+    for (uint32_t step = 0 ; step <= NOTE_C_I2C_CALIBRATION_STEPS ; ++step) {
+        NoteI2CPacing pacing = defaultI2CPacing;
+        if (step == 0) {
+            pacing.ioDelayMs = 0;
+            pacing.chunkDelayMs = 0;
+            pacing.segmentDelayMs = 0;
+        } else {
+            const uint32_t shift = (NOTE_C_I2C_CALIBRATION_STEPS - step);
+            pacing.ioDelayMs >>= shift;
+            pacing.chunkDelayMs >>= shift;
+            pacing.segmentDelayMs >>= shift;
+        }
+        NoteSetI2CPacing(&pacing);
+        if (_i2cCalibrationTrials()) {
+            NOTE_C_LOG_INFO("I2C pacing calibrated");
+            if (saveFn != NULL) {
+                saveFn(&pacing);
+            }
+            return true;
+        }
+
+        // Whatever the Notecard made of the failed request, get back in sync
+        // before backing off
+        NOTE_C_LOG_WARN(ERRSTR("I2C pacing unstable, backing off", c_iobad));
+        NoteReset();
+    }
+
+    NOTE_C_LOG_ERROR(ERRSTR("I2C pacing calibration failed", c_err));
+    NoteSetI2CPacing(&previous);
+    return false;
+}
+
+uint32_t NoteProbeI2CMtu(void)
+{
+    if (NoteGetActiveInterface() != NOTE_C_INTERFACE_I2C) {
+        return 0;
+    }
+
+    uint32_t previous = 0;
+    NoteGetI2CMtu(&previous);
+
+    // The default MTU must work before any larger one is tried
+    uint32_t good = NOTE_I2C_MTU_DEFAULT;
+    NoteSetI2CMtu(good);
+    if (!_i2cCalibrationTrials()) {
+        NOTE_C_LOG_ERROR(ERRSTR("I2C MTU probe failed", c_err));
+        NoteSetI2CMtu(previous);
+        return 0;
+    }
+
+    // Double the MTU until it fails or reaches the maximum, then narrow the
+    // gap between the largest that worked and the smallest that failed
+    uint32_t bad = (NOTE_I2C_MTU_MAX + 1);
+    while (good < NOTE_I2C_MTU_MAX && (bad - good) > NOTE_C_I2C_MTU_PROBE_RESOLUTION) {
+        uint32_t mtu = ((bad > NOTE_I2C_MTU_MAX) ? (good * 2) : ((good + bad) / 2));
+        mtu = ((mtu > NOTE_I2C_MTU_MAX) ? NOTE_I2C_MTU_MAX : mtu);
+        NoteSetI2CMtu(mtu);
+        if (_i2cCalibrationTrials()) {
+            good = mtu;
+            continue;
+        }
+
+        // Whatever the Notecard or the host driver made of the failed
+        // request, get back in sync at an MTU known to work
+        bad = mtu;
+        NoteSetI2CMtu(good);
+        NoteReset();
+    }
+
+    NoteSetI2CMtu(good);
+    return good;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Wait before querying the Notecard again for a response.
+
+  @details  With a data-ready hook, this sleeps until the Notecard signals or
+             the wait times out. Otherwise, or once a signal has proved
+             spurious, it sleeps for the poll interval and doubles it, up to
+             `NOTE_C_I2C_POLL_MAX_MS`. The wait never extends past the
+             caller's timeout.
+
+  @param   startMs The time, in milliseconds, at which the caller began waiting.
+  @param   timeoutMs The caller's timeout, in milliseconds, or zero for none.
+  @param   pollMs [in,out] The wait state, which must be zero before the first
+            wait for a response.
+*/
+/**************************************************************************/
+NOTE_C_STATIC void _i2cWaitForData(uint32_t startMs, uint32_t timeoutMs, uint32_t *pollMs)
+{
+    uint32_t waitMs = NOTE_C_I2C_WAIT_MAX_MS;
+    if (timeoutMs) {
+        const uint32_t elapsedMs = _GetMs() - startMs;
+        if (elapsedMs >= timeoutMs) {
+            return;
+        }
+        if ((timeoutMs - elapsedMs) < waitMs) {
+            waitMs = (timeoutMs - elapsedMs);
+        }
+    }
+
+    if (*pollMs == 0) {
+        bool ready = false;
+        if (_I2CWaitForData(waitMs, &ready)) {
+            // If we're back after a signal, nothing was there, so poll
+            if (ready) {
+                *pollMs = NOTE_C_I2C_POLL_MS;
+            }
+            return;
+        }
+        *pollMs = NOTE_C_I2C_POLL_MS;
+    }
+
+    _DelayMs((*pollMs < waitMs) ? *pollMs : waitMs);
+    *pollMs = ((*pollMs * 2) < NOTE_C_I2C_POLL_MAX_MS) ? (*pollMs * 2) : NOTE_C_I2C_POLL_MAX_MS;
 }
 
 /**************************************************************************/
@@ -49,22 +360,33 @@ NOTE_C_STATIC const char * _i2cNoteQueryLength(uint32_t * available,
         uint32_t timeoutMs)
 {
     uint8_t dummy_buffer = 0;
+    uint32_t pollMs = 0;
 
-    for (const uint32_t startMs = _GetMs() ; !(*available) ; _DelayMs(50)) {
+    _StatsAdd(i2cQueries, 1);
+    const uint32_t startMs = _GetMs();
+    while (!(*available)) {
         // Send a dummy I2C transaction to prime the Notecard
-        const char *err = _I2CReceive(_I2CAddress(), &dummy_buffer, 0, available);
+        const char *err = _i2cBusReceive(&dummy_buffer, 0, available);
         if (err) {
+            _StatsAdd(i2cQueryMs, (_GetMs() - startMs));
             NOTE_C_LOG_ERROR(err);
             return err;
         }
+        if (*available) {
+            break;
+        }
 
         // If we've timed out, return an error
         if (timeoutMs && _GetMs() - startMs >= timeoutMs) {
+            _StatsAdd(i2cQueryMs, (_GetMs() - startMs));
             const char *err = ERRSTR("timeout: no response from Notecard {io}", c_iotimeout);
             NOTE_C_LOG_ERROR(err);
             return err;
         }
+
+        _i2cWaitForData(startMs, timeoutMs, &pollMs);
     }
+    _StatsAdd(i2cQueryMs, (_GetMs() - startMs));
     return NULL;
 }
 
@@ -88,47 +410,48 @@ const char *_i2cNoteTransaction(const char *request, size_t reqLen, char **respo
 {
     const char *err = NULL;
 
-    // Lock over the entire transaction
-    _LockI2C();
+    // Lock over the entire transaction, unless the bus is shared
+    _i2cLockExchange();
 
     // Do not attempt to send a zero-length request
     if (reqLen > 0) {
         err = _i2cChunkedTransmit((const uint8_t *)request, reqLen, true);
         if (err) {
             NOTE_C_LOG_ERROR(err);
-            _UnlockI2C();
+            _i2cUnlockExchange();
             return err;
         }
     }
 
     // If no reply expected, we're done
     if (response == NULL) {
-        _UnlockI2C();
+        _i2cUnlockExchange();
         return NULL;
     }
 
     // Wait for something to become available
     _delayIO();
 
-    // Allocate a buffer for input, noting that we always put the +1 in the
-    // alloc so we can be assured that it can be null-terminated. This must be
-    // the case because json parsing requires a null-terminated string.
+    // Wait for the response to begin
     uint32_t available = 0;
     err = _i2cNoteQueryLength(&available, timeoutMs);
     if (err) {
         NOTE_C_LOG_ERROR(ERRSTR("failed to query Notecard", c_err));
-        _UnlockI2C();
+        _i2cUnlockExchange();
         return err;
     }
-    size_t jsonbufAllocLen = (ALLOC_CHUNK * ((available / ALLOC_CHUNK) + ((available % ALLOC_CHUNK) > 0)));
+    _Trace(NOTE_C_TRACE_FIRST_RX, 0);
+
+    // Allocate a buffer for input, large enough for what is already queued
+    // and for the typical response to the API, and always with space for the
+    // NULL-terminator the JSON parser requires.
     uint8_t *jsonbuf = NULL;
+    uint32_t jsonbufAllocLen = 0;
     uint32_t jsonbufLen = 0;
-    if (jsonbufAllocLen) {
-        jsonbuf = (uint8_t *)_Malloc(jsonbufAllocLen + 1);
-        if (jsonbuf == NULL) {
-            err = ERRSTR("transaction: jsonbuf malloc failed", c_mem);
-            NOTE_C_LOG_ERROR(err);
-            _UnlockI2C();
+    if (available) {
+        err = _noteResponseBufGrow(&jsonbuf, 0, &jsonbufAllocLen, available, cardResponseSizeHint);
+        if (err) {
+            _i2cUnlockExchange();
             return err;
         }
 
@@ -141,38 +464,26 @@ const char *_i2cNoteTransaction(const char *request, size_t reqLen, char **respo
             if (err) {
                 _Free(jsonbuf);
                 NOTE_C_LOG_ERROR(ERRSTR(err, c_iobad));
-                _UnlockI2C();
+                _i2cUnlockExchange();
                 return err;
             }
             jsonbufLen += jsonbufAvailLen;
             jsonbuf[jsonbufLen] = '\0';
 
+            // When more bytes are available than we have buffer to
+            // accommodate (i.e. overflow), then grow the buffer
             if (available) {
-                // When more bytes are available than we have buffer to accommodate
-                // (i.e. overflow), then we allocate blocks of size `ALLOC_CHUNK` to
-                // reduce heap fragmentation.
-                // NOTE: We always put the +1 in the allocation so we can be assured
-                // that it can be null-terminated, because the json parser requires
-                // a null-terminated string.
-                jsonbufAllocLen += (ALLOC_CHUNK * ((available / ALLOC_CHUNK) + ((available % ALLOC_CHUNK) > 0)));
-                uint8_t *jsonbufNew = (uint8_t *)_Malloc(jsonbufAllocLen + 1);
-                if (jsonbufNew == NULL) {
-                    err = ERRSTR("transaction: jsonbuf grow malloc failed", c_mem);
-                    NOTE_C_LOG_ERROR(err);
-                    _Free(jsonbuf);
-                    _UnlockI2C();
+                err = _noteResponseBufGrow(&jsonbuf, jsonbufLen, &jsonbufAllocLen, available, 0);
+                if (err) {
+                    _i2cUnlockExchange();
                     return err;
                 }
-                memcpy(jsonbufNew, jsonbuf, jsonbufLen);
-                _Free(jsonbuf);
-                jsonbuf = jsonbufNew;
-                NOTE_C_LOG_DEBUG("additional receive buffer chunk allocated");
             }
         } while (available);
     }
 
     // Done with the bus
-    _UnlockI2C();
+    _i2cUnlockExchange();
 
     // Null-terminate it, using the +1 space that we'd allocated in the buffer
     if (jsonbuf) {
@@ -197,83 +508,78 @@ bool _i2cNoteReset(void)
     bool notecardReady = false;
 
     // Claim the I2C bus
-    _LockI2C();
+    _i2cLockExchange();
     NOTE_C_LOG_DEBUG("resetting I2C interface...");
 
     // Reset the I2C subsystem and exit if failure
-    _DelayMs(CARD_REQUEST_I2C_SEGMENT_DELAY_MS);
-    notecardReady = _I2CReset(_I2CAddress());
+    notecardReady = _i2cBusReset();
     if (!notecardReady) {
         NOTE_C_LOG_ERROR(ERRSTR("error encountered during I2C reset hook execution", c_err));
-        _UnlockI2C();
+        _i2cUnlockExchange();
         return false;
     }
     _delayIO();
 
-    // The guaranteed behavior for robust resyncing is to send two newlines
-    // and  wait for two echoed blank lines in return.
+    // Rather than draining for a fixed window, send a newline followed by an
+    // `echo` request carrying a nonce, and stop as soon as the Notecard echoes
+    // the nonce back. Each round waits at most CARD_RESET_DRAIN_MS for the
+    // echo, and gives up sooner once unrecognized data has been followed by
+    // CARD_RESET_QUIET_MS of silence.
+    // NOTE: This MUST always be `\n` and not `\r\n`, because there are some
+    //       versions of the Notecard firmware will not respond to `\r\n`
+    //       after communicating over I2C.
+    notecardReady = false;
+    uint32_t backoffMs = CARD_RESET_BACKOFF_MS;
     for (size_t retries = 0; retries < CARD_RESET_SYNC_RETRIES ; ++retries) {
-        // Send a newline to the module to clean out request/response processing
-        // NOTE: This MUST always be `\n` and not `\r\n`, because there are some
-        //       versions of the Notecard firmware will not respond to `\r\n`
-        //       after communicating over I2C.
-        // Stack buffer used to avoid passing flash-resident data through the
-        // non-const hook. TODO: Remove when i2cTransmitFn accepts const uint8_t *.
-        uint8_t lf[] = {'\n'};
-        const char *transmitErr = _I2CTransmit(_I2CAddress(), lf, 1);
-        // If we get a failure on transmitting the `\n`, it means that the
-        // Notecard isn't present.
+        // Pause between rounds, so that an unresponsive Notecard is not
+        // hammered with requests
+        _DelayMs(backoffMs);
+        backoffMs = ((backoffMs * 2) < CARD_RESET_DRAIN_MS) ? (backoffMs * 2) : CARD_RESET_DRAIN_MS;
+
+        _noteResetSync sync;
+        _noteResetSyncBegin(&sync);
+        const char *transmitErr = _i2cChunkedTransmit(sync.request, sync.requestLen, true);
+        // If we get a failure on transmitting, it means that the Notecard
+        // isn't present.
         if (transmitErr) {
-            NOTE_C_LOG_ERROR(transmitErr);
             NOTE_C_LOG_ERROR(ERRSTR("error encountered during I2C transmit hook execution", c_err));
             _DelayMs(CARD_REQUEST_I2C_NACK_WAIT_MS);
-            notecardReady = false;
             continue;
         }
 
-        // Wait for the Notecard to respond with a carriage return and newline
-        _DelayMs(CARD_REQUEST_I2C_SEGMENT_DELAY_MS);
+        // Wait for something to become available
+        _delayIO();
 
-        // Determine if I2C data is available
-        // set initial state of variable to perform query
+        // Set initial state of variable to perform query
         uint16_t chunkLen = 0;
-
-        // Content flags to determine if reset conditions are met.
         bool somethingFound = false;
-        bool nonControlCharFound = false;
+        const uint32_t startMs = _GetMs();
+        uint32_t dataMs = startMs;
 
-        // Read I2C data for at least `CARD_RESET_DRAIN_MS` continuously
-        for (uint32_t startMs = _GetMs() ; (_GetMs() - startMs) < CARD_RESET_DRAIN_MS ;) {
+        for (;;) {
 
             // Read the next chunk of available data
             uint32_t available = 0;
-            uint8_t buffer[ALLOC_CHUNK] = {0};
+            uint8_t buffer[ALLOC_CHUNK];
             chunkLen = (chunkLen > sizeof(buffer)) ? sizeof(buffer) : chunkLen;
             chunkLen = (chunkLen > _I2CMax()) ? _I2CMax() : chunkLen;
-            const char *err = _I2CReceive(_I2CAddress(), buffer, chunkLen, &available);
+            const char *err = _i2cBusReceive(buffer, chunkLen, &available);
             if (err) {
                 // We have received a hardware or protocol level error.
                 // Introduce delay to relieve system stress.
                 NOTE_C_LOG_ERROR(err);
                 NOTE_C_LOG_ERROR(ERRSTR("error encountered during I2C receive hook execution", c_err));
                 _DelayMs(CARD_REQUEST_I2C_SEGMENT_DELAY_MS);
-                notecardReady = false;
-                continue;
-            }
-
-            // Set content flags
-            if (chunkLen) {
+                available = 0;
+            } else if (chunkLen) {
                 somethingFound = true;
-                // The Notecard responds to a bare `\n` with `\r\n`. If we get
-                // any other characters back, it means the host and Notecard
-                // aren't synced up yet and we need to transmit `\n` again.
-                for (size_t i = 0; i < chunkLen ; ++i) {
-                    char ch = buffer[i];
-                    if (ch != '\n' && ch != '\r') {
-                        nonControlCharFound = true;
-                        // Reset the timer with each non-control character
-                        startMs = _GetMs();
-                    }
+                const uint32_t dataLen = sync.dataLen;
+                if (_noteResetSyncScan(&sync, buffer, chunkLen)) {
+                    notecardReady = true;
+                    break;
+                }
+                if (sync.dataLen != dataLen) {
+                    dataMs = _GetMs();
                 }
             }
 
@@ -282,35 +588,40 @@ bool _i2cNoteReset(void)
             // buffer size as a uint16_t).
             chunkLen = (available > 0xFFFF) ? 0xFFFF : available;
 
-            _DelayMs(CARD_REQUEST_I2C_CHUNK_DELAY_MS);
+            const uint32_t nowMs = _GetMs();
+            if ((nowMs - startMs) >= CARD_RESET_DRAIN_MS) {
+                break;
+            }
+            if (sync.dataLen && (nowMs - dataMs) >= CARD_RESET_QUIET_MS) {
+                break;
+            }
+            if (!chunkLen) {
+                _DelayMs(CARD_REQUEST_I2C_CHUNK_DELAY_MS);
+            }
         }
 
-        // If characters were received and they were ONLY `\r` or `\n`,
-        // then the Notecard has been successfully reset.
-        if (!somethingFound || nonControlCharFound) {
-            notecardReady = false;
-            if (somethingFound) {
-                NOTE_C_LOG_WARN(ERRSTR("unrecognized data from notecard", c_iobad));
-            } else {
-                NOTE_C_LOG_ERROR(ERRSTR("notecard not responding", c_iobad));
-
-                // Reset the I2C subsystem and exit if failure
-                if (!_I2CReset(_I2CAddress())) {
-                    NOTE_C_LOG_ERROR(ERRSTR("error encountered during I2C reset hook execution", c_err));
-                    break;
-                }
-                _delayIO();
-            }
-        } else {
-            notecardReady = true;
+        if (notecardReady) {
             break;
         }
 
+        if (somethingFound) {
+            NOTE_C_LOG_WARN(ERRSTR("unrecognized data from notecard", c_iobad));
+        } else {
+            NOTE_C_LOG_ERROR(ERRSTR("notecard not responding", c_iobad));
+
+            // Reset the I2C subsystem and exit if failure
+            if (!_i2cBusReset()) {
+                NOTE_C_LOG_ERROR(ERRSTR("error encountered during I2C reset hook execution", c_err));
+                break;
+            }
+            _delayIO();
+        }
+
         NOTE_C_LOG_DEBUG("retrying I2C interface reset...");
     }
 
     // Done with the I2C bus
-    _UnlockI2C();
+    _i2cUnlockExchange();
 
     // Done
     return notecardReady;
@@ -337,9 +648,9 @@ bool _i2cNoteReset(void)
 /**************************************************************************/
 const char *_i2cNoteChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint32_t timeoutMs, uint32_t *available)
 {
-    _LockI2C();
+    _i2cLockExchange();
     const char *errstr = _i2cChunkedReceive(buffer, size, delay, timeoutMs, available);
-    _UnlockI2C();
+    _i2cUnlockExchange();
     return errstr;
 }
 
@@ -369,6 +680,7 @@ const char *_i2cChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint
     uint16_t requested = 0;
     bool overflow = false;
     uint32_t startMs = _GetMs();
+    uint32_t pollMs = 0;
 
     // Request all available bytes, up to the maximum request size
     requested = (*available > 0xFFFF) ? 0xFFFF : *available;
@@ -379,7 +691,7 @@ const char *_i2cChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint
         // Read a chunk of data from I2C
         // The first read will request zero bytes to query the amount of data
         // available to receive from the Notecard.
-        const char *err = _I2CReceive(_I2CAddress(), (buffer + received), requested, available);
+        const char *err = _i2cBusReceive((buffer + received), requested, available);
         if (err) {
             *size = received;
             NOTE_C_LOG_ERROR(err);
@@ -388,11 +700,13 @@ const char *_i2cChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint
 
         // Add requested bytes to received total
         received += requested;
+        _StatsAdd(bytesReceived, requested);
 
         // Once we've received any character, we will no longer wait patiently
         if (requested != 0) {
             timeoutMs = (CARD_INTRA_TRANSACTION_TIMEOUT_SEC * 1000);
             startMs = _GetMs();
+            pollMs = 0;
         }
 
         // Request all available bytes, up to the maximum request size
@@ -432,9 +746,9 @@ const char *_i2cChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint
             return ERRSTR("timeout: transaction incomplete {io}", c_iotimeout);
         }
 
-        // Delay, simply waiting for the Note to process the request
+        // Wait for the Notecard to process the request
         if (delay) {
-            _DelayMs(50);
+            _i2cWaitForData(startMs, timeoutMs, &pollMs);
         }
     }
 
@@ -455,9 +769,9 @@ const char *_i2cChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint
 /**************************************************************************/
 const char *_i2cNoteChunkedTransmit(const uint8_t *buffer, uint32_t size, bool delay)
 {
-    _LockI2C();
+    _i2cLockExchange();
     const char *errstr = _i2cChunkedTransmit(buffer, size, delay);
-    _UnlockI2C();
+    _i2cUnlockExchange();
     return errstr;
 }
 
@@ -479,6 +793,32 @@ const char *_i2cChunkedTransmit(const uint8_t *buffer, uint32_t size, bool delay
     const char *estr;
     const uint8_t *chunk = buffer;
     uint16_t sentInSegment = 0;
+
+    // Without processing delays the chunks are sent back to back, so they are
+    // handed to the transport as gather lists
+    while (!delay && size > 0) {
+        NoteIoVec iov[NOTE_C_I2C_GATHER_MAX];
+        size_t iovCount = 0;
+        uint32_t gatherLen = 0;
+        for ( ; size > 0 && iovCount < NOTE_C_I2C_GATHER_MAX ; ++iovCount) {
+            uint16_t chunkLen = (size > 0xFFFF) ? 0xFFFF : size;
+            chunkLen = (chunkLen > _I2CMax()) ? _I2CMax() : chunkLen;
+            iov[iovCount].data = chunk;
+            iov[iovCount].len = chunkLen;
+            chunk += chunkLen;
+            size -= chunkLen;
+            gatherLen += chunkLen;
+        }
+        estr = _i2cBusTransmitv(iov, iovCount);
+        if (estr != NULL) {
+            _i2cBusReset();
+            NOTE_C_LOG_ERROR(estr);
+            return estr;
+        }
+        _StatsAdd(bytesSent, gatherLen);
+        _Trace(NOTE_C_TRACE_SEGMENT_TX, gatherLen);
+    }
+
     while (size > 0) {
         // Constrain chunkLen to fit into 16 bits (_I2CTransmit takes the buffer
         // size as a uint16_t).
@@ -489,23 +829,25 @@ const char *_i2cChunkedTransmit(const uint8_t *buffer, uint32_t size, bool delay
         if (delay) {
             _delayIO();
         }
-        estr = _I2CTransmit(_I2CAddress(), chunk, chunkLen);
+        estr = _i2cBusTransmit(chunk, chunkLen);
         if (estr != NULL) {
-            _I2CReset(_I2CAddress());
+            _i2cBusReset();
             NOTE_C_LOG_ERROR(estr);
             return estr;
         }
+        _StatsAdd(bytesSent, chunkLen);
+        _Trace(NOTE_C_TRACE_SEGMENT_TX, chunkLen);
         chunk += chunkLen;
         size -= chunkLen;
         sentInSegment += chunkLen;
-        if (sentInSegment > CARD_REQUEST_I2C_SEGMENT_MAX_LEN) {
+        if (sentInSegment > i2cPacing.segmentLen) {
             sentInSegment = 0;
-            if (delay) {
-                _DelayMs(CARD_REQUEST_I2C_SEGMENT_DELAY_MS);
+            if (delay && i2cPacing.segmentDelayMs) {
+                _DelayMs(i2cPacing.segmentDelayMs);
             }
         }
-        if (delay) {
-            _DelayMs(CARD_REQUEST_I2C_CHUNK_DELAY_MS);
+        if (delay && i2cPacing.chunkDelayMs) {
+            _DelayMs(i2cPacing.chunkDelayMs);
         }
     }
 
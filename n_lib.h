@@ -73,6 +73,12 @@ extern uint32_t cardTransactionTimeoutOverrideSecs;
 /**************************************************************************/
 #define CARD_REQUEST_I2C_NACK_WAIT_MS 1000
 /**************************************************************************/
+/*!
+    @brief  The delay, in miliseconds, before each I2C I/O.
+*/
+/**************************************************************************/
+#define CARD_REQUEST_I2C_IO_DELAY_MS 6
+/**************************************************************************/
 /*!
     @brief  The max length, in bytes, of each request segment when using Serial.
 */
@@ -86,11 +92,27 @@ extern uint32_t cardTransactionTimeoutOverrideSecs;
 #define CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS 250
 /**************************************************************************/
 /*!
-    @brief  The time, in miliseconds, to drain incoming messages.
+    @brief  The time, in miliseconds, to wait for the Notecard to answer when
+    resynchronizing.
 */
 /**************************************************************************/
 #define CARD_RESET_DRAIN_MS 500
 /**************************************************************************/
+/*!
+    @brief  The time, in miliseconds, without incoming bytes after which
+    unrecognized data from the Notecard is considered drained.
+*/
+/**************************************************************************/
+#define CARD_RESET_QUIET_MS 20
+/**************************************************************************/
+/*!
+    @brief  The pause, in miliseconds, before the first attempt to
+    resynchronize with the Notecard. It doubles with each retry, up to
+    `CARD_RESET_DRAIN_MS`.
+*/
+/**************************************************************************/
+#define CARD_RESET_BACKOFF_MS 20
+/**************************************************************************/
 /*!
     @brief  The number of times we will retry a request before giving up.
 */
@@ -103,6 +125,78 @@ extern uint32_t cardTransactionTimeoutOverrideSecs;
 /**************************************************************************/
 #define CARD_RESET_SYNC_RETRIES 10
 /**************************************************************************/
+/*!
+    @brief  The number of responses held by the response cache.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_RESPONSE_CACHE_ENTRIES
+#define NOTE_C_RESPONSE_CACHE_ENTRIES 4
+#endif
+/**************************************************************************/
+/*!
+    @brief  The size, in bytes, of the buffer filled by the bulk serial
+    receive hook.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_SERIAL_RX_BUFFER_LEN
+#define NOTE_C_SERIAL_RX_BUFFER_LEN 64
+#endif
+/**************************************************************************/
+/*!
+    @brief  The most I2C chunks passed to the vectored I2C transmit hook in a
+    single call.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_I2C_GATHER_MAX
+#define NOTE_C_I2C_GATHER_MAX 8
+#endif
+/**************************************************************************/
+/*!
+    @brief  The number of steps by which I2C pacing calibration backs off,
+    halving the distance to the default pacing with each step.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_I2C_CALIBRATION_STEPS
+#define NOTE_C_I2C_CALIBRATION_STEPS 5
+#endif
+/**************************************************************************/
+/*!
+    @brief  The number of `echo` round trips an I2C pacing or MTU must
+    complete during calibration to be considered stable.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_I2C_CALIBRATION_TRIALS
+#define NOTE_C_I2C_CALIBRATION_TRIALS 3
+#endif
+/**************************************************************************/
+/*!
+    @brief  The length, in bytes, of the text echoed during I2C pacing and
+    MTU calibration, long enough for the request to span two segments and
+    more than one chunk of the largest MTU.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_I2C_CALIBRATION_LEN
+#define NOTE_C_I2C_CALIBRATION_LEN (CARD_REQUEST_I2C_SEGMENT_MAX_LEN * 2)
+#endif
+/**************************************************************************/
+/*!
+    @brief  The time, in miliseconds, to wait for each `echo` during I2C
+    pacing and MTU calibration.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_I2C_CALIBRATION_TIMEOUT_MS
+#define NOTE_C_I2C_CALIBRATION_TIMEOUT_MS 2000
+#endif
+/**************************************************************************/
+/*!
+    @brief  How close, in bytes, the I2C MTU probe gets to the smallest MTU
+    that failed before it settles on the largest that worked.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_I2C_MTU_PROBE_RESOLUTION
+#define NOTE_C_I2C_MTU_PROBE_RESOLUTION 8
+#endif
+/**************************************************************************/
 /*!
     @brief  Memory allocation chunk size.
 */
@@ -112,6 +206,22 @@ extern uint32_t cardTransactionTimeoutOverrideSecs;
 #else
 #define ALLOC_CHUNK 128
 #endif // NOTE_C_LOW_MEM
+/**************************************************************************/
+/*!
+    @brief  Whether buffers of unknown final size (received responses and
+    printed JSON) grow geometrically, by half their size at a time, rather
+    than by just enough `ALLOC_CHUNK` blocks. Geometric growth copies each
+    byte a bounded number of times, while linear growth wastes the least
+    memory.
+*/
+/**************************************************************************/
+#ifndef NOTE_C_ALLOC_GROWTH_GEOMETRIC
+#ifdef NOTE_C_LOW_MEM
+#define NOTE_C_ALLOC_GROWTH_GEOMETRIC 0
+#else
+#define NOTE_C_ALLOC_GROWTH_GEOMETRIC 1
+#endif // NOTE_C_LOW_MEM
+#endif
 
 #ifdef NOTE_C_LOW_MEM
 #define NOTE_DISABLE_USER_AGENT
@@ -120,7 +230,9 @@ extern uint32_t cardTransactionTimeoutOverrideSecs;
 // Transactions
 void _noteResumeTransactionDebug(void);
 void _noteSuspendTransactionDebug(void);
+bool _noteEcho(size_t textLen, uint32_t timeoutMs);
 J *_noteTransactionShouldLock(J *req, bool lockNotecard);
+J *_noteTransactionShouldLockAndStart(J *req, bool lockNotecard, bool startTransaction);
 const char *_i2cNoteTransaction(const char *request, size_t reqLen, char **response, uint32_t timeoutMs);
 bool _i2cNoteReset(void);
 const char *_serialNoteTransaction(const char *request, size_t reqLen, char **response, uint32_t timeoutMs);
@@ -131,9 +243,32 @@ const char *_i2cNoteChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay,
 const char *_i2cNoteChunkedTransmit(const uint8_t *buffer, uint32_t size, bool delay);
 const char *_serialChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint32_t timeoutMs, uint32_t *available);
 const char *_serialChunkedTransmit(const uint8_t *buffer, uint32_t size, bool delay);
+const char *_serialChunkedTransmitLine(const uint8_t *buffer, uint32_t size, bool delay);
+uint32_t _serialPacingDelayMs(uint32_t len);
+void _serialPacingReset(void);
+uint32_t _serialPacingSegmentLen(void);
+void _serialPacingSent(uint32_t len);
+
+// Interface resynchronization. The Notecard is in sync once it answers an
+// `echo` request carrying a nonce, sent after a newline that terminates
+// whatever it was receiving.
+#define NOTE_C_RESET_NONCE_LEN 8
+typedef struct {
+    uint8_t request[48];
+    uint32_t requestLen;
+    char nonce[NOTE_C_RESET_NONCE_LEN];
+    uint8_t matched;        // Nonce characters matched so far
+    uint32_t dataLen;       // Bytes other than `\r` or `\n` received
+} _noteResetSync;
+void _noteResetSyncBegin(_noteResetSync *sync);
+bool _noteResetSyncScan(_noteResetSync *sync, const uint8_t *data, uint32_t len);
 
 // Hooks
+size_t _noteAllocGrowLen(size_t allocLen, size_t needed);
+const char *_noteResponseBufGrow(uint8_t **buf, uint32_t len, uint32_t *allocLen, uint32_t needed, uint32_t sizeHint);
+void *_noteRealloc(void *ptr, size_t used, size_t size);
 void _noteLockNote(void);
+bool _noteLockNotePriority(uint8_t priority, uint32_t timeoutMs);
 void _noteUnlockNote(void);
 bool _noteTransactionStart(uint32_t timeoutMs);
 void _noteTransactionStop(void);
@@ -142,9 +277,13 @@ bool _noteSerialReset(void);
 void _noteSerialTransmit(const uint8_t *, size_t, bool);
 bool _noteSerialAvailable(void);
 char _noteSerialReceive(void);
+size_t _noteSerialReceiveLine(uint8_t *buf, size_t max, bool *eop);
+void _noteSerialTransmitv(const NoteIoVec *iov, size_t iovCount, bool flush);
 bool _noteI2CReset(uint16_t DevAddress);
 const char *_noteI2CTransmit(uint16_t DevAddress, const uint8_t* pBuffer, uint16_t Size);
+const char *_noteI2CTransmitv(uint16_t DevAddress, const NoteIoVec *iov, size_t iovCount);
 const char *_noteI2CReceive(uint16_t DevAddress, uint8_t* pBuffer, uint16_t Size, uint32_t *avail);
+bool _noteI2CWaitForData(uint32_t timeoutMs, bool *ready);
 bool _noteHardReset(void);
 const char *_noteJSONTransaction(const char *request, size_t reqLen, char **response, uint32_t timeoutMs);
 const char *_noteChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, uint32_t timeoutMs, uint32_t *available);
@@ -153,12 +292,37 @@ bool _noteIsDebugOutputActive(void);
 #ifdef NOTE_C_HEARTBEAT_CALLBACK
 bool _noteHeartbeat(const char *heartbeatJson);
 #endif
+#ifndef NOTE_C_LOW_MEM
+uint32_t _noteCrc32(uint32_t crc, const uint8_t *data, size_t length);
+#endif
+
+// Statistics
+#ifdef NOTE_C_STATS
+extern NoteStats noteStats;
+void _noteStatsTransaction(const char *api, uint32_t elapsedMs, uint32_t retries, bool isError);
+#define _StatsAdd(field, n) (noteStats.field += (uint32_t)(n))
+#else
+#define _StatsAdd(field, n) ((void)0)
+#endif
+
+// Transaction trace
+#ifdef NOTE_C_TRACE
+void _noteTrace(uint8_t type, uint32_t arg);
+#define _Trace(type, arg) _noteTrace((type), (uint32_t)(arg))
+#else
+#define _Trace(type, arg) ((void)0)
+#endif
 
 // Utilities
 void _n_htoa32(uint32_t n, char *p);
 void _n_htoa16(uint16_t n, unsigned char *p);
 uint64_t _n_atoh(char *p, int maxLen);
 
+// CRC32
+#ifndef NOTE_C_LOW_MEM
+uint32_t _crc32Compute(uint32_t crc, const uint8_t *data, size_t length);
+#endif
+
 // COBS Helpers
 uint32_t _cobsDecode(uint8_t *ptr, uint32_t length, uint8_t eop, uint8_t *dst);
 uint32_t _cobsEncode(uint8_t *ptr, uint32_t length, uint8_t eop, uint8_t *dst);
@@ -169,6 +333,44 @@ uint32_t _cobsGuaranteedFit(uint32_t bufLen);
 // Turbo I/O mode
 extern bool cardTurboIO;
 
+// Notecard API descriptors
+#define API_IDEMPOTENT          0x01    // Safe to resend once it may have been executed
+#define API_TIMEOUT_ARGS        0x02    // Timeout set by "seconds" or "milliseconds"
+typedef struct {
+    const char *name;
+    uint16_t rspSize;   // Typical size of the response, or 0 if it's small
+    uint8_t flags;
+} _noteApiDescriptor;
+const _noteApiDescriptor *_noteApiLookup(const char *api);
+uint16_t _noteApiIndex(const _noteApiDescriptor *api);
+
+// The expected size of the response to the transaction in progress, used to
+// size the receive buffer up front
+extern uint32_t cardResponseSizeHint;
+
+// Request scheduling. Waiters check for their turn after the shorter poll
+// interval, which doubles up to the longer one while the Notecard stays busy.
+#ifndef NOTE_C_SCHEDULER_POLL_MS
+#define NOTE_C_SCHEDULER_POLL_MS    1
+#endif
+#ifndef NOTE_C_SCHEDULER_POLL_MAX_MS
+#define NOTE_C_SCHEDULER_POLL_MAX_MS    50
+#endif
+
+// Waiting for an I2C response. Without a data-ready hook, the Notecard is
+// queried after the shorter poll interval, which doubles up to the longer one.
+// A data-ready hook is never left waiting longer than the last constant, in
+// case a signal was missed.
+#ifndef NOTE_C_I2C_POLL_MS
+#define NOTE_C_I2C_POLL_MS      1
+#endif
+#ifndef NOTE_C_I2C_POLL_MAX_MS
+#define NOTE_C_I2C_POLL_MAX_MS  50
+#endif
+#ifndef NOTE_C_I2C_WAIT_MAX_MS
+#define NOTE_C_I2C_WAIT_MAX_MS  1000
+#endif
+
 // Constants, a global optimization to save static string memory
 extern const char *c_bad;
 #define c_bad_len 3
@@ -176,6 +378,9 @@ extern const char *c_bad;
 extern const char *c_badbinerr;
 #define c_badbinerr_len 9
 
+extern const char *c_busy;
+#define c_busy_len 6
+
 extern const char *c_cmd;
 #define c_cmd_len 3
 
@@ -231,15 +436,21 @@ extern const char *c_unsupported;
 #define _SerialTransmit _noteSerialTransmit
 #define _SerialAvailable _noteSerialAvailable
 #define _SerialReceive _noteSerialReceive
+#define _SerialReceiveLine _noteSerialReceiveLine
+#define _SerialTransmitv _noteSerialTransmitv
 #define _I2CReset _noteI2CReset
 #define _I2CTransmit _noteI2CTransmit
+#define _I2CTransmitv _noteI2CTransmitv
 #define _I2CReceive _noteI2CReceive
+#define _I2CWaitForData _noteI2CWaitForData
 #define _Reset _noteHardReset
 #define _Transaction _noteJSONTransaction
 #define _ChunkedReceive _noteChunkedReceive
 #define _ChunkedTransmit _noteChunkedTransmit
+#define _Crc32 _noteCrc32
 #define _Malloc NoteMalloc
 #define _Free NoteFree
+#define _Realloc _noteRealloc
 #define _GetMs NoteGetMs
 #define _DelayMs NoteDelayMs
 #define _LockI2C NoteLockI2C
@@ -17,14 +17,6 @@
 
 #include "n_lib.h"
 
-// Externalized Hooks
-//**************************************************************************/
-/*!
-  @brief  Hook for the calling platform's debug interface, if any.
-*/
-/**************************************************************************/
-extern debugOutputFn hookDebugOutput;
-
 //**************************************************************************/
 /*!
   @brief  Write a formatted string to the debug output.
@@ -41,7 +33,7 @@ void NoteDebugf(const char *format, ...)
         va_start(args, format);
         vsnprintf(line, sizeof(line), format, args);
         va_end(args);
-        hookDebugOutput(line);
+        NoteDebug(line);
     }
 #else
     (void)format;
@@ -12,32 +12,92 @@
 
 #include "n_lib.h"
 
+#include <limits.h>
 #include <string.h>
 
-static const int RETRY_DELAY_MS = 500;
+static const int I2C_QUERY_DELAY_MS = 50;
+
+// The default retry policy, which matches the fixed retries of earlier releases
+#define RETRY_POLICY_DEFAULT {                                      \
+    500,                            /* initialDelayMs */            \
+    500,                            /* maxDelayMs */                \
+    0,                              /* deadlineMs */                \
+    1,                              /* backoffFactor */             \
+    0,                              /* jitterPercent */             \
+    CARD_REQUEST_RETRIES_ALLOWED,   /* maxRetries */                \
+    CARD_REQUEST_RETRIES_ALLOWED,   /* ioRetries */                 \
+    CARD_REQUEST_RETRIES_ALLOWED,   /* crcRetries */                \
+    0,                              /* badBinRetries */             \
+}
+static const NoteRetryPolicy defaultRetryPolicy = RETRY_POLICY_DEFAULT;
+static NoteRetryPolicy retryPolicy = RETRY_POLICY_DEFAULT;
+static uint32_t retryJitterState = 0;
+
+// Classes of failure, each with its own retry limit
+#define RETRY_CLASS_IO          0
+#define RETRY_CLASS_CRC         1
+#define RETRY_CLASS_BADBIN      2
+#define RETRY_CLASSES           3
+
+// Retries made by a transaction, checked against the retry policy
+typedef struct {
+    uint32_t startMs;
+    uint8_t retries;
+    uint8_t classRetries[RETRY_CLASSES];
+} _noteRetry;
 
 // A value that optionally overrides CARD_INTER_TRANSACTION_TIMEOUT_SEC
 uint32_t cardTransactionTimeoutOverrideSecs = 0;
 
+// The expected size of the response to the transaction in progress, or 0
+uint32_t cardResponseSizeHint = 0;
+
 // For flow tracing
 static int suppressShowTransactions = 0;
 
+// Set when requests should be serialized straight into the transport
+static bool streamRequests = false;
+
+// The size of the buffer used to stream requests, matching the size of the
+// segments sent by the chunked transmit functions
+#define STREAM_SEGMENT_LEN      CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN
+
 // Flag that gets set whenever an error occurs that should force a reset
 NOTE_C_STATIC bool resetRequired = true;
 
+#define ERR_FIELD_NAME_TEST     "\"err\":\""
+
+// Outcomes of inspecting the response to a request
+#define RSP_COMPLETE            0   // Done, whether or not it holds an error
+#define RSP_RETRY_IO            1   // An {io} error, so resend
+#define RSP_RETRY_CRC           2   // Failed its CRC, so resend
+#define RSP_HEARTBEAT           3   // Heartbeat, keep waiting for the response
+#define RSP_ABANDONED           4   // The heartbeat callback gave up
+#define RSP_BADBIN              5   // A {bad-bin} error, resent only by policy
+#define RSP_CORRUPT             6   // Malformed, so resent only if that's safe
+
+// What a transaction does once its response has been inspected
+#define RSP_ACTION_DONE         0   // Return the response
+#define RSP_ACTION_FAIL         1   // Return the error
+#define RSP_ACTION_RESEND       2   // Send the request again
+#define RSP_ACTION_RECEIVE      3   // Keep waiting for the response
+
 // CRC data
 #ifndef NOTE_C_LOW_MEM
 static uint16_t seqNo = 0;
 #define CRC_FIELD_LENGTH        22  // ,"crc":"SSSS:CCCCCCCC"
 #define CRC_FIELD_NAME_OFFSET   1
 #define CRC_FIELD_NAME_TEST     "\"crc\":\""
-#define ERR_FIELD_NAME_TEST     "\"err\":\""
 NOTE_C_STATIC int32_t _crc32(const void* data, size_t length);
+NOTE_C_STATIC uint32_t _crc32Update(uint32_t crc, const void* data, size_t length);
 NOTE_C_STATIC char * _crcAdd(char *json, uint16_t seqno);
+NOTE_C_STATIC size_t _crcAppend(char *json, size_t jsonLen, size_t bufLen, uint16_t seqno);
+NOTE_C_STATIC size_t _crcAppendField(char *json, size_t jsonLen, size_t bufLen, uint16_t seqno, uint32_t crc, bool isEmptyObject);
 NOTE_C_STATIC bool _crcError(char *json, uint16_t shouldBeSeqno);
 
 NOTE_C_STATIC bool notecardFirmwareSupportsCrc = false;
 #endif // !NOTE_C_LOW_MEM
+NOTE_C_STATIC int _noteTransactionResponse(char *rspJsonStr, bool crcAdded, uint16_t seqno, J **rsp, const char **errStr, bool *isHeartbeat);
 
 /*!
  @internal
@@ -74,6 +134,252 @@ NOTE_C_STATIC J * _errDoc(uint32_t id, const char *errmsg)
     return rspdoc;
 }
 
+/*!
+ @internal
+
+ @brief Skip the whitespace in a JSON text.
+
+ @param p The position in the JSON text.
+ @param end The end of the JSON text.
+
+ @returns The first position that is not whitespace, or `end`.
+ */
+static const char * _jsonScanSpace(const char *p, const char *end)
+{
+    while (p < end && *p <= ' ') {
+        p++;
+    }
+    return p;
+}
+
+/*!
+ @internal
+
+ @brief Skip the contents of a JSON string.
+
+ @param p The position just after the opening quote.
+ @param end The end of the JSON text.
+
+ @returns The position of the closing quote, or NULL if the string isn't
+          terminated.
+ */
+static const char * _jsonScanString(const char *p, const char *end)
+{
+    for ( ; p < end ; p++) {
+        if (*p == '\\') {
+            p++;
+        } else if (*p == '"') {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/*!
+ @internal
+
+ @brief Skip a JSON value, including any objects or arrays nested within it.
+
+ @param p The position of the start of the value.
+ @param end The end of the JSON text.
+
+ @returns The position just after the value, or NULL if it's malformed.
+ */
+static const char * _jsonScanValue(const char *p, const char *end)
+{
+    if (*p == '"') {
+        p = _jsonScanString(p + 1, end);
+        return ((p == NULL) ? NULL : (p + 1));
+    }
+
+    if (*p == '{' || *p == '[') {
+        int depth = 0;
+        for ( ; p < end ; p++) {
+            if (*p == '"') {
+                p = _jsonScanString(p + 1, end);
+                if (p == NULL) {
+                    return NULL;
+                }
+            } else if (*p == '{' || *p == '[') {
+                depth++;
+            } else if ((*p == '}' || *p == ']') && --depth == 0) {
+                return (p + 1);
+            }
+        }
+        return NULL;
+    }
+
+    // A number, `true`, `false` or `null`
+    const char * const start = p;
+    while (p < end && *p > ' ' && *p != ',' && *p != '}' && *p != ']') {
+        p++;
+    }
+    return ((p == start) ? NULL : p);
+}
+
+/*!
+ @internal
+
+ @brief Find the value of a top-level field in a JSON object, straight from
+        its text.
+
+ This is far cheaper than `JParse`, as nothing is allocated, and it stops as
+ soon as the field is found. Nested objects and arrays are skipped, so only
+ the fields of the outermost object are matched.
+
+ @param json The JSON text, which needn't be null-terminated.
+ @param jsonLen The length of the JSON text.
+ @param key The name of the field, which must not contain escapes.
+ @param value [out] The raw text of the value, including the quotes of a
+        string. May be NULL.
+ @param valueLen [out] The length of the raw text of the value. May be NULL.
+
+ @returns 1 if the field was found, 0 if it wasn't, or -1 if the JSON text
+          was malformed before the field could be found.
+ */
+NOTE_C_STATIC int _noteJSONScanKey(const char *json, size_t jsonLen, const char *key, const char **value, size_t *valueLen)
+{
+    const char * const end = (json + jsonLen);
+    const size_t keyLen = strlen(key);
+
+    const char *p = _jsonScanSpace(json, end);
+    if (p == end || *p != '{') {
+        return -1;
+    }
+    p = _jsonScanSpace(p + 1, end);
+    if (p < end && *p == '}') {
+        return 0;
+    }
+
+    while (p < end) {
+        if (*p != '"') {
+            return -1;
+        }
+        const char * const name = (p + 1);
+        p = _jsonScanString(name, end);
+        if (p == NULL) {
+            return -1;
+        }
+        const size_t nameLen = (size_t)(p - name);
+        p = _jsonScanSpace(p + 1, end);
+        if (p == end || *p != ':') {
+            return -1;
+        }
+        p = _jsonScanSpace(p + 1, end);
+        if (p == end) {
+            return -1;
+        }
+        const char * const fieldValue = p;
+        p = _jsonScanValue(p, end);
+        if (p == NULL) {
+            return -1;
+        }
+        if (nameLen == keyLen && memcmp(name, key, keyLen) == 0) {
+            if (value != NULL) {
+                *value = fieldValue;
+            }
+            if (valueLen != NULL) {
+                *valueLen = (size_t)(p - fieldValue);
+            }
+            return 1;
+        }
+        p = _jsonScanSpace(p, end);
+        if (p < end && *p == '}') {
+            return 0;
+        }
+        if (p == end || *p != ',') {
+            return -1;
+        }
+        p = _jsonScanSpace(p + 1, end);
+    }
+
+    return -1;
+}
+
+/*!
+ @internal
+
+ @brief Determine whether a string that isn't null-terminated contains a
+        substring.
+ */
+static bool _strnContains(const char *str, size_t len, const char *substr)
+{
+    const size_t substrLen = strlen(substr);
+    for (size_t i = 0 ; (i + substrLen) <= len ; ++i) {
+        if (memcmp(&str[i], substr, substrLen) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+ @internal
+
+ @brief Classify a response from its top-level "err" field, without parsing it.
+
+ @param json The response text.
+ @param jsonLen The length of the response text.
+ @param err [out] The text of the error, without its quotes, or NULL if the
+        response has no error.
+ @param errLen [out] The length of the text of the error.
+
+ @returns `RSP_HEARTBEAT` for a heartbeat, `RSP_BADBIN` for a `{bad-bin}`
+          error, `RSP_RETRY_IO` for an `{io}` error and `RSP_CORRUPT` for a
+          malformed response. Otherwise `RSP_COMPLETE`, including for errors
+          that are simply returned to the caller.
+ */
+static int _noteResponseClassify(const char *json, size_t jsonLen, const char **err, size_t *errLen)
+{
+    const char *value = NULL;
+    size_t valueLen = 0;
+    *err = NULL;
+    *errLen = 0;
+
+    const int found = _noteJSONScanKey(json, jsonLen, c_err, &value, &valueLen);
+    if (found < 0) {
+        return RSP_CORRUPT;
+    }
+    if (found == 0 || value[0] != '"') {
+        return RSP_COMPLETE;
+    }
+
+    *err = (value + 1);
+    *errLen = (valueLen - 2);
+    if (_strnContains(*err, *errLen, c_heartbeat)) {
+        return RSP_HEARTBEAT;
+    }
+    if (_strnContains(*err, *errLen, c_badbinerr)) {
+        return RSP_BADBIN;
+    }
+    if (_strnContains(*err, *errLen, c_ioerr) && !_strnContains(*err, *errLen, c_unsupported)) {
+        return RSP_RETRY_IO;
+    }
+    return RSP_COMPLETE;
+}
+
+/*!
+ @internal
+
+ @brief Determine whether a request may be resent after a corrupt response,
+        which shows that the Notecard has already executed it.
+
+ @param api The descriptor of the API of the request.
+ @param crcAdded Whether the request carried a CRC and sequence number.
+
+ @returns `true` if the request may be resent.
+ */
+static bool _noteResendAllowed(const _noteApiDescriptor *api, bool crcAdded)
+{
+    // The Notecard recognizes a resent request by its sequence number, and
+    // would otherwise execute it again
+    if (crcAdded || (api->flags & API_IDEMPOTENT)) {
+        return true;
+    }
+    NOTE_C_LOG_DEBUG(ERRSTR("request is not safe to resend", c_iobad));
+    return false;
+}
+
 /*!
  @brief Resume showing transaction details.
  */
@@ -101,35 +407,23 @@ void _noteSuspendTransactionDebug(void)
   these transactions to timeout prematurely.
 
   The algorithm executes the following logic:
-  - If the request is a `note.add`, set the timeout value to the
-    value of the "milliseconds" parameter, if it exists. If it
-    doesn't, use the "seconds" parameter. If that doesn't exist,
-    use the standard timeout of `CARD_INTER_TRANSACTION_TIMEOUT_SEC`.
-  - If the request is a `web.*`, follow the same logic, but instead
-    of using the standard timeout, use the Notecard timeout of 90
-    seconds for all `web.*` transactions.
+  - If the API descriptor has `API_TIMEOUT_ARGS` set (`note.add` and
+    `web.*`), set the timeout value to the value of the "milliseconds"
+    parameter, if it exists. If it doesn't, use the "seconds" parameter.
+  - Otherwise, or if neither parameter exists, use the standard timeout
+    of `CARD_INTER_TRANSACTION_TIMEOUT_SEC`.
 
  @param req The request object.
- @param isReq Whether the request is a regular request or a command.
+ @param apiFlags The flags of the API descriptor of the request.
 
  @returns The timeout in milliseconds.
  */
-NOTE_C_STATIC uint32_t _noteTransaction_calculateTimeoutMs(J *req, bool isReq)
+NOTE_C_STATIC uint32_t _noteTransaction_calculateTimeoutMs(J *req, uint8_t apiFlags)
 {
     uint32_t result = ((CARD_INTER_TRANSACTION_TIMEOUT_SEC - 1) * 1000);
 
     // Interrogate the request
-    if (JContainsString(req, (isReq ? "req" : "cmd"), "note.add")) {
-        if (JIsPresent(req, "milliseconds")) {
-            NOTE_C_LOG_DEBUG("Using `milliseconds` parameter value for "
-                             "timeout.");
-            result = JGetInt(req, "milliseconds");
-        } else if (JIsPresent(req, "seconds")) {
-            NOTE_C_LOG_DEBUG("Using `seconds` parameter value for timeout.");
-            result = (JGetInt(req, "seconds") * 1000);
-        }
-    } else if (JContainsString(req, (isReq ? "req" : "cmd"), "web.")) {
-        NOTE_C_LOG_DEBUG("web.* request received.");
+    if (apiFlags & API_TIMEOUT_ARGS) {
         if (JIsPresent(req, "milliseconds")) {
             NOTE_C_LOG_DEBUG("Using `milliseconds` parameter value for "
                              "timeout.");
@@ -170,6 +464,215 @@ uint32_t NoteSetRequestTimeout(uint32_t overrideSecs)
     return previous;
 }
 
+bool NoteSetRequestStreaming(bool enable)
+{
+    bool previous = streamRequests;
+    streamRequests = enable;
+    return previous;
+}
+
+void NoteSetRetryPolicy(const NoteRetryPolicy *policy)
+{
+    _LockNote();
+    retryPolicy = ((policy != NULL) ? *policy : defaultRetryPolicy);
+
+    // Normalize the policy, so that the delay never shrinks or exceeds its cap
+    if (retryPolicy.backoffFactor == 0) {
+        retryPolicy.backoffFactor = 1;
+    }
+    if (retryPolicy.maxDelayMs < retryPolicy.initialDelayMs) {
+        retryPolicy.maxDelayMs = retryPolicy.initialDelayMs;
+    }
+    if (retryPolicy.jitterPercent > 100) {
+        retryPolicy.jitterPercent = 100;
+    }
+    _UnlockNote();
+}
+
+void NoteGetRetryPolicy(NoteRetryPolicy *policy)
+{
+    if (policy != NULL) {
+        _LockNote();
+        *policy = retryPolicy;
+        _UnlockNote();
+    }
+}
+
+/*!
+ @internal
+
+ @brief Calculate the delay before a retry, according to the retry policy.
+
+ @param retry The number of retries already made.
+
+ @returns The delay, in milliseconds.
+ */
+NOTE_C_STATIC uint32_t _noteRetryDelayMs(uint8_t retry)
+{
+    // Exponential backoff, capped at the maximum delay
+    uint32_t delayMs = retryPolicy.initialDelayMs;
+    for (uint8_t i = 0 ; i < retry && delayMs < retryPolicy.maxDelayMs ; ++i) {
+        if (delayMs > (retryPolicy.maxDelayMs / retryPolicy.backoffFactor)) {
+            delayMs = retryPolicy.maxDelayMs;
+        } else {
+            delayMs *= retryPolicy.backoffFactor;
+        }
+    }
+    if (delayMs > retryPolicy.maxDelayMs) {
+        delayMs = retryPolicy.maxDelayMs;
+    }
+
+    // Spread the delay by up to +/- the jitter percentage, so that retries
+    // don't fall into lockstep with whatever is keeping the Notecard busy. A
+    // xorshift32 generator is used because rand() isn't available everywhere.
+    uint32_t spreadMs = ((delayMs / 100) * retryPolicy.jitterPercent) + (((delayMs % 100) * retryPolicy.jitterPercent) / 100);
+    if (spreadMs > (UINT32_MAX / 2)) {
+        spreadMs = (UINT32_MAX / 2);
+    }
+    if (spreadMs > 0) {
+        if (retryJitterState == 0) {
+            retryJitterState = (_GetMs() | 1u);  // avoid the all-zero fixed point
+        }
+        retryJitterState ^= retryJitterState << 13;
+        retryJitterState ^= retryJitterState >> 17;
+        retryJitterState ^= retryJitterState << 5;
+        delayMs = ((delayMs - spreadMs) + (retryJitterState % ((spreadMs * 2) + 1)));
+    }
+
+    return delayMs;
+}
+
+/*!
+ @internal
+
+ @brief Begin tracking the retries of a transaction.
+
+ @param retry The retry state of the transaction.
+ */
+NOTE_C_STATIC void _noteRetryStart(_noteRetry *retry)
+{
+    memset(retry, 0, sizeof(*retry));
+    retry->startMs = _GetMs();
+}
+
+/*!
+ @internal
+
+ @brief Determine whether a failed transaction may be retried, according to
+        the retry policy, and if so record the retry.
+
+ @param retry The retry state of the transaction.
+ @param errClass The class of the failure (i.e. `RETRY_CLASS_*`).
+ @param delayMs [out] The delay to observe before retrying. When the retries
+        are exhausted this is the delay the blocking paths still observe to
+        let the Notecard settle, and it is zero once the deadline is reached
+        or for a class that is never retried.
+
+ @returns `true` if the transaction should be retried after `delayMs`, and
+          `false` if it has run out of retries or time.
+ */
+NOTE_C_STATIC bool _noteRetryAllowed(_noteRetry *retry, int errClass, uint32_t *delayMs)
+{
+    *delayMs = 0;
+
+    uint8_t classLimit;
+    switch (errClass) {
+    case RETRY_CLASS_CRC:
+        _StatsAdd(crcErrors, 1);
+        classLimit = retryPolicy.crcRetries;
+        break;
+    case RETRY_CLASS_BADBIN:
+        _StatsAdd(badBinErrors, 1);
+        classLimit = retryPolicy.badBinRetries;
+        break;
+    default:
+        _StatsAdd(ioErrors, 1);
+        errClass = RETRY_CLASS_IO;
+        classLimit = retryPolicy.ioRetries;
+        break;
+    }
+    if (classLimit == 0) {
+        return false;
+    }
+
+    *delayMs = _noteRetryDelayMs(retry->retries);
+    if (retry->retries >= retryPolicy.maxRetries || retry->classRetries[errClass] >= classLimit) {
+        return false;
+    }
+    if (retryPolicy.deadlineMs && ((_GetMs() - retry->startMs) + *delayMs) >= retryPolicy.deadlineMs) {
+        NOTE_C_LOG_DEBUG("retry deadline reached");
+        *delayMs = 0;
+        return false;
+    }
+
+    retry->retries++;
+    retry->classRetries[errClass]++;
+    _StatsAdd(retries, 1);
+    _Trace(NOTE_C_TRACE_RETRY, errClass);
+    return true;
+}
+
+/*!
+ @internal
+
+ @brief Wait before retrying a failed transaction, and report whether the
+        retry policy allows another attempt.
+
+ @param retry The retry state of the transaction.
+ @param errClass The class of the failure (i.e. `RETRY_CLASS_*`).
+
+ @returns `true` if the transaction should be retried, and `false` otherwise.
+ */
+NOTE_C_STATIC bool _noteRetryWait(_noteRetry *retry, int errClass)
+{
+    uint32_t delayMs = 0;
+    const bool allowed = _noteRetryAllowed(retry, errClass, &delayMs);
+
+    // Pace the final failure too, so that the Notecard settles before the
+    // interface reset queued by the failed transaction
+    if (delayMs > 0) {
+        _DelayMs(delayMs);
+    }
+    return allowed;
+}
+
+#ifdef NOTE_C_STATS
+/*!
+ @internal
+
+ @brief Record the statistics of a completed transaction.
+
+ @param req The request, used for its API name when `json` is NULL.
+ @param json The serialized request, or NULL.
+ @param cmdFound `true` if the request is a command (i.e. "cmd").
+ @param retry The retry state of the transaction.
+ @param isError `true` if the transaction ended in an error.
+ */
+static void _noteStatsRecord(J *req, const char *json, bool cmdFound, const _noteRetry *retry, bool isError)
+{
+    const char *key = (cmdFound ? "cmd" : "req");
+    char api[NOTE_C_STATS_API_LEN] = "";
+    if (json != NULL) {
+        const char *value = NULL;
+        size_t valueLen = 0;
+        if (_noteJSONScanKey(json, strlen(json), key, &value, &valueLen) > 0 && valueLen >= 2 && value[0] == '"') {
+            valueLen -= 2;
+            if (valueLen >= sizeof(api)) {
+                valueLen = sizeof(api) - 1;
+            }
+            memcpy(api, value + 1, valueLen);
+            api[valueLen] = '\0';
+        }
+    } else if (req != NULL) {
+        strlcpy(api, JGetString(req, key), sizeof(api));
+    }
+    _noteStatsTransaction(api, (_GetMs() - retry->startMs), retry->retries, isError);
+}
+#define _StatsRecord(req, json, cmdFound, retry, isError) _noteStatsRecord(req, json, cmdFound, retry, isError)
+#else
+#define _StatsRecord(req, json, cmdFound, retry, isError) ((void)0)
+#endif // NOTE_C_STATS
+
 J *NoteNewRequest(const char *request)
 {
     J *reqdoc = JCreateObject();
@@ -217,71 +720,432 @@ bool NoteRequestWithRetry(J *req, uint32_t timeoutSeconds)
     return success;
 }
 
-J *NoteRequestResponse(J *req)
-{
-    // Exit if null request. This allows safe execution of the form
-    // NoteRequestResponse(NoteNewRequest("xxx"))
-    if (req == NULL) {
-        return NULL;
-    }
-    // Execute the transaction
-    J *rsp = NoteTransaction(req);
-    // Free the request and exit
-    JDelete(req);
-    return rsp;
-}
-
-J *NoteRequestResponseWithRetry(J *req, uint32_t timeoutSeconds)
-{
-    // Exit if null request. This allows safe execution of the form
-    // NoteRequestResponse(NoteNewRequest("xxx"))
-    if (req == NULL) {
-        return NULL;
-    }
+// APIs whose responses may be cached, because they only report state
+typedef struct {
+    const char *api;
+    const char *args;           // Arguments allowed in a cached request, space-delimited
+    const char *invalidatedBy;  // Prefix of the APIs whose requests invalidate the cached responses
+    uint32_t ttlMs;             // Time that a response remains valid (0 to disable caching)
+} _noteCacheableApi;
+
+static _noteCacheableApi cacheableApis[] = {
+    {"card.version", "", "card.dfu", 0},
+    {"hub.status", "", "hub.", 0},
+    {"card.time", "", "card.time", 0},
+    {"card.wireless", "", "card.wireless", 0},
+    {"env.get", "name names time", "env.", 0},
+};
+#define CACHEABLE_APIS (sizeof(cacheableApis) / sizeof(cacheableApis[0]))
 
+// Cached responses, keyed on the serialized request
+typedef struct {
+    char *key;
     J *rsp;
+    uint32_t storedMs;
+    uint8_t api;                // Index in cacheableApis
+} _noteCacheEntry;
 
-    // Calculate expiry time in milliseconds
-    uint32_t startMs = _GetMs();
-    uint32_t timeoutMs = timeoutSeconds * 1000;
+static _noteCacheEntry responseCache[NOTE_C_RESPONSE_CACHE_ENTRIES];
+static bool responseCacheEnabled = false;
 
-    while(true) {
-        // Execute the transaction
-        rsp = NoteTransaction(req);
+/*!
+ @internal
 
-        // Loop if there is no response, or if there is an io error
-        if ((rsp == NULL) || (JContainsString(rsp, c_err, c_ioerr) && !JContainsString(rsp, c_err, c_unsupported))) {
+ @brief Determine whether an argument may be present in a cached request.
 
-            // Free error response
-            if (rsp != NULL) {
-                JDelete(rsp);
-                rsp = NULL;
-            }
-        } else {
+ @param args The space-delimited arguments allowed.
+ @param arg The argument.
 
-            // Exit loop on non-null response without io error
-            break;
+ @returns `true` if the argument is allowed, and `false` otherwise.
+ */
+static bool _noteCacheArgAllowed(const char *args, const char *arg)
+{
+    const size_t argLen = strlen(arg);
+    for (const char *p = args ; *p != '\0' ;) {
+        const char *end = strchr(p, ' ');
+        const size_t len = (end == NULL ? strlen(p) : (size_t)(end - p));
+        if (len == argLen && memcmp(p, arg, len) == 0) {
+            return true;
         }
-
-        // Exit loop on timeout
-        if (_GetMs() - startMs >= timeoutMs) {
-            break;
+        p += len;
+        if (*p == ' ') {
+            p++;
         }
     }
+    return false;
+}
 
-    // Free the request
-    JDelete(req);
+/*!
+ @internal
 
-    // Return the response
-    return rsp;
-}
+ @brief Find the cacheable API of a request.
 
-char * NoteRequestResponseJSON(const char *reqJSON)
+ @param req The request.
+
+ @returns The index of the API in `cacheableApis`, or -1 if the response to
+          the request may not be cached, because the API isn't cacheable, its
+          caching is disabled or the request has arguments that may make it
+          change the state of the Notecard.
+ */
+static int _noteCacheApi(J *req)
+{
+    const char *api = JGetString(req, c_req);
+    for (size_t i = 0 ; i < CACHEABLE_APIS ; ++i) {
+        if (strcmp(api, cacheableApis[i].api) != 0) {
+            continue;
+        }
+        if (cacheableApis[i].ttlMs == 0) {
+            return -1;
+        }
+        for (J *field = req->child ; field != NULL ; field = field->next) {
+            if (strcmp(field->string, c_req) != 0 && !_noteCacheArgAllowed(cacheableApis[i].args, field->string)) {
+                return -1;
+            }
+        }
+        return (int)i;
+    }
+    return -1;
+}
+
+/*!
+ @internal
+
+ @brief Discard a cached response.
+
+ @param entry The cache entry.
+ */
+static void _noteCacheDiscard(_noteCacheEntry *entry)
+{
+    _Free(entry->key);
+    entry->key = NULL;
+    JDelete(entry->rsp);
+    entry->rsp = NULL;
+}
+
+/*!
+ @internal
+
+ @brief Discard the cached responses invalidated by a request that wasn't
+        served from the cache. Must be called with the Notecard locked.
+
+ @param api The API of the request, or NULL to discard every response.
+ */
+static void _noteCacheInvalidate(const char *api)
+{
+    for (size_t i = 0 ; i < NOTE_C_RESPONSE_CACHE_ENTRIES ; ++i) {
+        _noteCacheEntry *entry = &responseCache[i];
+        if (entry->key == NULL) {
+            continue;
+        }
+        const char *prefix = cacheableApis[entry->api].invalidatedBy;
+        if (api == NULL || strncmp(api, prefix, strlen(prefix)) == 0) {
+            _noteCacheDiscard(entry);
+        }
+    }
+}
+
+/*!
+ @internal
+
+ @brief Look up the cached response to a request, discarding expired
+        responses. The Notecard must be locked.
+
+ @param api The index of the request's API in `cacheableApis`.
+ @param key The serialized request.
+ @param rsp [out] A copy of the cached response, when it's found.
+ @param slot [out] The entry in which to cache the response when it isn't
+        found, i.e. an unused or else the oldest entry.
+
+ @returns `true` if the response is cached, and `false` otherwise.
+ */
+static bool _noteCacheLookup(int api, const char *key, J **rsp, _noteCacheEntry **slot)
+{
+    *slot = NULL;
+    for (size_t i = 0 ; i < NOTE_C_RESPONSE_CACHE_ENTRIES ; ++i) {
+        _noteCacheEntry *entry = &responseCache[i];
+        if (entry->key != NULL && (_GetMs() - entry->storedMs) >= cacheableApis[entry->api].ttlMs) {
+            _noteCacheDiscard(entry);
+        }
+        if (entry->key == NULL) {
+            if (*slot == NULL || (*slot)->key != NULL) {
+                *slot = entry;
+            }
+            continue;
+        }
+        if (entry->api == api && strcmp(entry->key, key) == 0) {
+            *rsp = JDuplicate(entry->rsp, true);
+            return true;
+        }
+        if (*slot == NULL || ((*slot)->key != NULL && (int32_t)(entry->storedMs - (*slot)->storedMs) < 0)) {
+            *slot = entry;
+        }
+    }
+    return false;
+}
+
+/*!
+ @internal
+
+ @brief Perform a transaction through the response cache.
+
+ A response to a cacheable request is served from the cache while it is valid,
+ without waking the Notecard, and otherwise cached once received. Any other
+ request invalidates the cached responses that it may have made stale. As for
+ any other transaction, the transaction window is opened before the Notecard
+ is locked. The cache is checked again once the lock is held, so that tasks
+ issuing the same request concurrently share one transaction.
+
+ @param req The request, which is not freed.
+
+ @returns The response, or NULL if there is insufficient memory.
+ */
+static J *_noteCacheTransaction(J *req)
+{
+    const int api = _noteCacheApi(req);
+    char *key = NULL;
+    J *rsp = NULL;
+    _noteCacheEntry *slot = NULL;
+    if (api >= 0 && (key = JPrintUnformatted(req)) != NULL) {
+        _LockNote();
+        const bool found = _noteCacheLookup(api, key, &rsp, &slot);
+        _UnlockNote();
+        if (found) {
+            _Free(key);
+            return rsp;
+        }
+    }
+
+    // Ensure the Notecard is ready
+    if (!_TransactionStart(CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000)) {
+        _Free(key);
+        const char *errStr = ERRSTR("Notecard not ready (CTX/RTX) {io}", c_ioerr);
+        if (JGetString(req, c_cmd)[0]) {
+            NOTE_C_LOG_ERROR(errStr);
+            return NULL;
+        }
+        return _errDoc(JGetInt(req, "id"), errStr);
+    }
+    _LockNote();
+
+    if (key == NULL) {
+        rsp = _noteTransactionShouldLockAndStart(req, false, false);
+        const char *reqApi = JGetString(req, c_req);
+        _noteCacheInvalidate(reqApi[0] ? reqApi : JGetString(req, c_cmd));
+    } else if (!_noteCacheLookup(api, key, &rsp, &slot)) {
+        // Perform the transaction and cache a successful response
+        rsp = _noteTransactionShouldLockAndStart(req, false, false);
+        if (rsp != NULL && !NoteResponseError(rsp)) {
+            J *cached = JDuplicate(rsp, true);
+            if (cached != NULL) {
+                _noteCacheDiscard(slot);
+                slot->key = key;
+                slot->rsp = cached;
+                slot->storedMs = _GetMs();
+                slot->api = (uint8_t)api;
+                key = NULL;
+            }
+        }
+    }
+
+    _UnlockNote();
+    _TransactionStop();
+    _Free(key);
+    return rsp;
+}
+
+bool NoteSetResponseCacheTTL(const char *api, uint32_t ttlMs)
+{
+    if (api == NULL) {
+        return false;
+    }
+
+    bool found = false;
+    _LockNote();
+    responseCacheEnabled = false;
+    for (size_t i = 0 ; i < CACHEABLE_APIS ; ++i) {
+        if (strcmp(api, cacheableApis[i].api) == 0) {
+            cacheableApis[i].ttlMs = ttlMs;
+            found = true;
+        }
+        responseCacheEnabled = (responseCacheEnabled || cacheableApis[i].ttlMs != 0);
+    }
+
+    // Responses cached under the previous TTL are discarded
+    for (size_t i = 0 ; found && i < NOTE_C_RESPONSE_CACHE_ENTRIES ; ++i) {
+        if (responseCache[i].key != NULL && strcmp(cacheableApis[responseCache[i].api].api, api) == 0) {
+            _noteCacheDiscard(&responseCache[i]);
+        }
+    }
+    _UnlockNote();
+
+    return found;
+}
+
+void NoteInvalidateResponseCache(const char *api)
+{
+    _LockNote();
+    for (size_t i = 0 ; i < NOTE_C_RESPONSE_CACHE_ENTRIES ; ++i) {
+        if (responseCache[i].key != NULL && (api == NULL || strcmp(cacheableApis[responseCache[i].api].api, api) == 0)) {
+            _noteCacheDiscard(&responseCache[i]);
+        }
+    }
+    _UnlockNote();
+}
+
+J *NoteRequestResponse(J *req)
+{
+    // Exit if null request. This allows safe execution of the form
+    // NoteRequestResponse(NoteNewRequest("xxx"))
+    if (req == NULL) {
+        return NULL;
+    }
+    // Execute the transaction, through the response cache when it's in use
+    J *rsp = (responseCacheEnabled ? _noteCacheTransaction(req) : NoteTransaction(req));
+    // Free the request and exit
+    JDelete(req);
+    return rsp;
+}
+
+J *NoteRequestResponseWithRetry(J *req, uint32_t timeoutSeconds)
+{
+    // Exit if null request. This allows safe execution of the form
+    // NoteRequestResponse(NoteNewRequest("xxx"))
+    if (req == NULL) {
+        return NULL;
+    }
+
+    J *rsp;
+
+    // Calculate expiry time in milliseconds
+    uint32_t startMs = _GetMs();
+    uint32_t timeoutMs = timeoutSeconds * 1000;
+
+    for (uint8_t attempt = 0 ; ; ) {
+        // Execute the transaction
+        rsp = NoteTransaction(req);
+
+        // Loop if there is no response, or if there is an io error
+        if ((rsp == NULL) || (JContainsString(rsp, c_err, c_ioerr) && !JContainsString(rsp, c_err, c_unsupported))) {
+
+            // Free error response
+            if (rsp != NULL) {
+                JDelete(rsp);
+                rsp = NULL;
+            }
+        } else {
+
+            // Exit loop on non-null response without io error
+            break;
+        }
+
+        // Exit loop on timeout
+        const uint32_t elapsedMs = (_GetMs() - startMs);
+        if (elapsedMs >= timeoutMs) {
+            break;
+        }
+
+        // Back off before trying again, so as not to hammer a busy Notecard
+        uint32_t delayMs = _noteRetryDelayMs(attempt);
+        if (delayMs > (timeoutMs - elapsedMs)) {
+            delayMs = (timeoutMs - elapsedMs);
+        }
+        _DelayMs(delayMs);
+        if (attempt < UINT8_MAX) {
+            attempt++;
+        }
+    }
+
+    // Free the request
+    JDelete(req);
+
+    // Return the response
+    return rsp;
+}
+
+/*!
+ @internal
+
+ @brief Serialize the error document for a request that failed.
+
+ @param reqJSON The request, which need not be null-terminated.
+ @param reqLen The length of the request.
+ @param errStr The error.
+
+ @returns A newline-terminated JSON string, which the caller must free, or
+          NULL if there is insufficient memory.
+ */
+static char *_noteErrDocJSON(const char *reqJSON, size_t reqLen, const char *errStr)
+{
+    // Extract ID from the request JSON, if present
+    uint32_t id = 0;
+    const char *idValue = NULL;
+    if (_noteJSONScanKey(reqJSON, reqLen, "id", &idValue, NULL) > 0) {
+        id = (uint32_t)JAtoI(idValue);
+    }
+
+    // Use _errDoc() to create a well-formed JSON error string
+    char *rspJSON = NULL;
+    J *errdoc = _errDoc(id, errStr);
+    if (errdoc != NULL) {
+        char *errdocJSON = JPrintUnformatted(errdoc);
+        JDelete(errdoc);
+        if (errdocJSON != NULL) {
+            uint32_t errdocJSONLen = strlen(errdocJSON);
+            rspJSON = (char *) _Malloc(errdocJSONLen+2);
+            if (rspJSON != NULL) {
+                memcpy(rspJSON, errdocJSON, errdocJSONLen);
+                rspJSON[errdocJSONLen++] = '\n';
+                rspJSON[errdocJSONLen] = '\0';
+            }
+            _Free((void *)errdocJSON);
+        }
+    }
+    return rspJSON;
+}
+
+/*!
+ @internal
+
+ @brief Append a response to the newline-delimited responses of a pipeline.
+
+ @param rspJSON [in/out] The responses so far, or NULL if there are none.
+ @param rspJSONLen [in/out] The length of the responses so far.
+ @param lineRsp The response to append, which is consumed.
+
+ @returns `true` on success, and `false` if there is insufficient memory.
+ */
+static bool _noteAppendResponseJSON(char **rspJSON, size_t *rspJSONLen, char *lineRsp)
+{
+    const size_t lineRspLen = strlen(lineRsp);
+
+    // The first response is returned as it was received
+    if (*rspJSON == NULL) {
+        *rspJSON = lineRsp;
+        *rspJSONLen = lineRspLen;
+        return true;
+    }
+
+    const bool addNewline = (*rspJSONLen == 0 || (*rspJSON)[*rspJSONLen - 1] != '\n');
+    char *joined = (char *)_Realloc(*rspJSON, *rspJSONLen, *rspJSONLen + addNewline + lineRspLen + 1);
+    if (joined == NULL) {
+        _Free(lineRsp);
+        return false;
+    }
+    if (addNewline) {
+        joined[*rspJSONLen] = '\n';
+    }
+    memcpy(&joined[*rspJSONLen + addNewline], lineRsp, lineRspLen + 1);
+    _Free(lineRsp);
+    *rspJSON = joined;
+    *rspJSONLen += (addNewline + lineRspLen);
+    return true;
+}
+
+char * NoteRequestResponseJSON(const char *reqJSON)
 {
     const uint32_t transactionTimeoutMs = (CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000);
     char *rspJSON = NULL;
-    char *allocatedJSON = NULL; // required to free the string if it is not newline-terminated
-    bool isCmdPipeline = false;
+    size_t rspJSONLen = 0;
 
     if (reqJSON == NULL) {
         return NULL;
@@ -294,24 +1158,25 @@ char * NoteRequestResponseJSON(const char *reqJSON)
 
     _LockNote();
 
-    // Manually tokenize the string to search for multiple embedded
-    // commands (cannot use strtok)
-    for (;;) {
-        const char *endPtr;
-        const char * const newlinePtr = strchr(reqJSON, '\n');
+    if (reqJSON[0] == '\0') {
+        NOTE_C_LOG_ERROR(ERRSTR("request: jsonbuf zero length", c_bad));
+    }
+
+    // Manually tokenize the string to send each of the newline-delimited
+    // requests and commands in turn (cannot use strtok), holding the lock and
+    // the transaction window for the whole pipeline
+    for (const char *line = reqJSON ; line[0] != '\0' ;) {
+        char *allocatedJSON = NULL; // required to free the string if it is not newline-terminated
+        const char *endPtr = strchr(line, '\n');
+        const char *nextLine;
 
         // If string is not newline-terminated, then allocate a new
         // string and terminate it
-        if (NULL == newlinePtr) {
+        if (NULL == endPtr) {
             // All JSON strings should be newline-terminated to meet the
             // specification, however this is required to ensure backward
             // compatibility with the previous implementation.
-            const size_t allocLen = strlen(reqJSON);
-            if (0 == allocLen) {
-                NOTE_C_LOG_ERROR(ERRSTR("request: jsonbuf zero length", c_bad));
-                break;
-            }
-
+            const size_t allocLen = strlen(line);
             NOTE_C_LOG_WARN(ERRSTR("Memory allocation due to malformed request (not newline-terminated)", c_bad));
             allocatedJSON = _Malloc(allocLen + 2);  // +2 for newline and null-terminator
             if (allocatedJSON == NULL) {
@@ -319,88 +1184,70 @@ char * NoteRequestResponseJSON(const char *reqJSON)
                 break;
             }
 
-            memcpy(allocatedJSON, reqJSON, allocLen);
+            memcpy(allocatedJSON, line, allocLen);
             allocatedJSON[allocLen] = '\n';
             allocatedJSON[allocLen + 1] = '\0';
-            reqJSON = allocatedJSON;
+            nextLine = &line[allocLen];
+            line = allocatedJSON;
             endPtr = &allocatedJSON[allocLen];
         } else {
-            isCmdPipeline = !(strlen(newlinePtr) == 1);
-            endPtr = newlinePtr;
+            nextLine = (endPtr + 1);
         }
-        const size_t reqLen = ((endPtr - reqJSON) + 1);
+        const size_t reqLen = ((endPtr - line) + 1);
 
         bool isCmd = false;
-        if (strstr(reqJSON, "\"cmd\":") != NULL) {
-            // Only call `JParse()` after verifying the provided request
+        if (_strnContains(line, (size_t)(endPtr - line), "\"cmd\":")) {
+            // Only scan the request after verifying the provided request
             // appears to contain a command (i.e. we find `"cmd":`).
-            J *jsonObj = JParse(reqJSON);
-            if (!jsonObj) {
-                // Invalid JSON.
-                if (NULL == newlinePtr) {
-                    _Free((void *)reqJSON);
+            const int found = _noteJSONScanKey(line, (size_t)(endPtr - line), "cmd", NULL, NULL);
+            if (found < 0) {
+                // Invalid JSON, skipped without disturbing the rest of the
+                // pipeline
+                NOTE_C_LOG_ERROR(ERRSTR("request: invalid JSON", c_bad));
+                if (allocatedJSON) {
+                    _Free(allocatedJSON);
                 }
-                break;
+                line = nextLine;
+                continue;
             }
-            isCmd = JIsPresent(jsonObj, "cmd");
-            JDelete(jsonObj);
+            isCmd = (found > 0);
         }
 
+        bool appended = true;
         if (!isCmd) {
-            const char *errstr = _Transaction(reqJSON, reqLen, &rspJSON, transactionTimeoutMs);
+            char *lineRsp = NULL;
+            const char *errstr = _Transaction(line, reqLen, &lineRsp, transactionTimeoutMs);
             if (errstr != NULL) {
                 NOTE_C_LOG_ERROR(errstr);
-
-                // Extract ID from the request JSON, if present
-                uint32_t id = 0;
-                J *req = JParse(reqJSON);
-                if (req != NULL) {
-                    id = JGetInt(req, "id");
-                    JDelete(req);
-                }
-
-                // Use _errDoc() to create a well-formed JSON error string
-                J *errdoc = _errDoc(id, errstr);
-                if (errdoc != NULL) {
-                    char *errdocJSON = JPrintUnformatted(errdoc);
-                    JDelete(errdoc);
-                    if (errdocJSON != NULL) {
-                        uint32_t errdocJSONLen = strlen(errdocJSON);
-                        rspJSON = (char *) _Malloc(errdocJSONLen+2);
-                        if (rspJSON != NULL) {
-                            memcpy(rspJSON, errdocJSON, errdocJSONLen);
-                            rspJSON[errdocJSONLen++] = '\n';
-                            rspJSON[errdocJSONLen] = '\0';
-                        }
-                        _Free((void *)errdocJSON);
-                    }
+                if (lineRsp != NULL) {
+                    _Free(lineRsp);
                 }
+                lineRsp = _noteErrDocJSON(line, (size_t)(endPtr - line), errstr);
             }
-            if (allocatedJSON) {
-                _Free((void *)allocatedJSON);
-                allocatedJSON = NULL;
+            if (lineRsp != NULL) {
+                appended = _noteAppendResponseJSON(&rspJSON, &rspJSONLen, lineRsp);
             }
-            break;
         } else {
             // If it's a command, the Notecard will not respond, so we pass
             // NULL for the response parameter.
-            const char *errstr = _Transaction(reqJSON, reqLen, NULL, transactionTimeoutMs);
-            reqJSON = (endPtr + 1);  // Move to the next command in the pipeline
+            const char *errstr = _Transaction(line, reqLen, NULL, transactionTimeoutMs);
             if (errstr != NULL) {
                 NOTE_C_LOG_ERROR(errstr);
             }
         }
 
         // Clean up if we allocated a new string
-        (void)isCmdPipeline;
         if (allocatedJSON) {
-            _Free((void *)allocatedJSON);
-            break;
+            _Free(allocatedJSON);
         }
-        if (!isCmdPipeline) {
+
+        // Stop rather than send requests whose responses can't be returned
+        if (!appended) {
+            NOTE_C_LOG_ERROR(ERRSTR("response: jsonbuf malloc failed", c_mem));
             break;
         }
-    } // for(;;)
+        line = nextLine;
+    }
 
     _UnlockNote();
     _TransactionStop();
@@ -408,74 +1255,510 @@ char * NoteRequestResponseJSON(const char *reqJSON)
     return rspJSON;
 }
 
-J *NoteTransaction(J *req)
-{
-    return _noteTransactionShouldLock(req, true);
-}
-
-/**************************************************************************/
-/*!
-  @brief Same as `NoteTransaction`, but takes an additional parameter that
-  indicates if the Notecard should be locked.
-  @param   req
-  The `J` cJSON request object.
-  @param   lockNotecard
-  Set to `true` if the Notecard should be locked and `false` otherwise.
-  @returns a `J` cJSON object with the response, or NULL if there is
-  insufficient memory.
-*/
-/**************************************************************************/
-J *_noteTransactionShouldLock(J *req, bool lockNotecard)
+J *NoteRequestBatch(J *reqArray)
 {
-    // Validate in case of memory failure of the requestor
-    if (req == NULL) {
-        NOTE_C_LOG_ERROR(ERRSTR("NULL request", c_bad));
+    // Exit if null request array. This allows safe execution of the form
+    // NoteRequestBatch(JCreateArray())
+    if (reqArray == NULL) {
         return NULL;
     }
-
-    // Serialize the JSON request
-    char *json = JPrintUnformatted(req); // `json` allocated, must be freed
-    if (json == NULL) {
-        NOTE_C_LOG_ERROR(ERRSTR("failed to serialize JSON request", c_mem));
+    if (!JIsArray(reqArray)) {
+        NOTE_C_LOG_ERROR(ERRSTR("batch requests must be provided as an array", c_bad));
+        JDelete(reqArray);
         return NULL;
     }
 
-    // Determine the request or command type
-    const char * const reqApi = JGetString(req, "req");
-    const bool reqFound = reqApi[0];  // test for non-empty string
-    const char * const cmdApi = JGetString(req, "cmd");
-    const bool cmdFound = cmdApi[0];  // test for non-empty string
-
-    // If neither `"req"` nor `"cmd"` are found, then we have an error
-    // condition. If both are present, then we have undefined behavior.
-    if (!reqFound && !cmdFound) {
-        _Free(json);
-        NOTE_C_LOG_ERROR(ERRSTR("neither req nor cmd found in API invocation (invalid JSON)", c_bad));
-        return NULL;
-    } else if (reqFound && cmdFound) {
-        _Free(json);
-        NOTE_C_LOG_ERROR(ERRSTR("both req and cmd present in API invocation (undefined behavior)", c_bad));
+    J *rspArray = JCreateArray();
+    if (rspArray == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("failed to allocate batch response array", c_mem));
+        JDelete(reqArray);
         return NULL;
     }
 
-    // Extract the ID of the request so that errors can be returned with the same ID
-    const uint32_t id = JGetInt(req, "id");
+    // Open the transaction window and take the Notecard lock exactly once, so
+    // that the Notecard is only woken (CTX/RTX) and claimed once per batch,
+    // rather than once per request.
+    const bool transactionStarted = _TransactionStart(CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000);
+    if (transactionStarted) {
+        _LockNote();
+    }
 
-    // Ensure the Notecard is ready
-    if (!_TransactionStart(CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000)) {
-        _Free(json);
-        const char *errStr = ERRSTR("Notecard not ready (CTX/RTX) {io}", c_ioerr);
-        if (cmdFound) {
-            NOTE_C_LOG_ERROR(errStr);
-            return NULL;
-        }
-        return _errDoc(id, errStr);
+    for (J *req = reqArray->child ; req != NULL ; req = req->next) {
+        J *rsp = NULL;
+        if (!transactionStarted) {
+            rsp = _errDoc(JGetInt(req, "id"), ERRSTR("Notecard not ready (CTX/RTX) {io}", c_ioerr));
+        } else {
+            rsp = _noteTransactionShouldLockAndStart(req, false, false);
+            if (rsp == NULL) {
+                // Malformed requests (e.g. missing "req" and "cmd") still
+                // occupy a slot, so responses stay aligned with requests.
+                rsp = _errDoc(JGetInt(req, "id"), ERRSTR("invalid request in batch {bad}", c_bad));
+            }
+        }
+        if (rsp == NULL) {
+            // Keep the responses aligned with the requests, or if not even
+            // that is possible, fail the batch as a whole
+            rsp = _errDoc(JGetInt(req, "id"), ERRSTR("failed to allocate batch response {mem}", c_mem));
+            if (rsp == NULL) {
+                NOTE_C_LOG_ERROR(ERRSTR("failed to allocate batch response", c_mem));
+                JDelete(rspArray);
+                rspArray = NULL;
+                break;
+            }
+        }
+        JAddItemToArray(rspArray, rsp);
+    }
+
+    if (transactionStarted) {
+        _UnlockNote();
+        _TransactionStop();
+    }
+
+    // Free the requests and exit
+    JDelete(reqArray);
+    return rspArray;
+}
+
+/*!
+ @internal
+
+ @brief Serialize a request into a caller-supplied buffer, without using the
+        heap, and add the CRC field when applicable.
+
+ @param req The request to serialize.
+ @param buf The buffer to serialize into.
+ @param bufLen The size of the buffer. Two bytes are always held back for the
+        terminating newline and null-terminator.
+ @param addCrc `true` if a CRC field should be appended.
+ @param seqno The sequence number to include as a part of the CRC.
+ @param len [out] The length of the serialized request.
+ @param crcAdded [out] `true` if the CRC field was appended.
+
+ @returns An error string on failure or NULL on success.
+ */
+NOTE_C_STATIC const char * _noteSerializeBuffered(J *req, char *buf, size_t bufLen, bool addCrc, uint16_t seqno, size_t *len, bool *crcAdded)
+{
+    const size_t printLen = (bufLen - 2);
+    if (!JPrintPreallocated(req, buf, (printLen > INT_MAX ? INT_MAX : (int)printLen), false)) {
+        return ERRSTR("request does not fit in scratch buffer {mem}", c_mem);
+    }
+    *len = strlen(buf);
+    *crcAdded = false;
+
+#ifndef NOTE_C_LOW_MEM
+    if (addCrc) {
+        const size_t crcLen = _crcAppend(buf, *len, printLen, seqno);
+        if (crcLen) {
+            *len = crcLen;
+            *crcAdded = true;
+        }
+    }
+#else
+    (void)addCrc;
+    (void)seqno;
+#endif // !NOTE_C_LOW_MEM
+
+    return NULL;
+}
+
+const char *NoteTransactionBuffered(J *req, uint8_t *scratch, size_t scratchLen)
+{
+    char * const json = (char *)scratch;
+
+    // Validate the caller-supplied request and buffer. The smallest useful
+    // buffer must hold "{}", a newline and the null-terminator.
+    if (req == NULL || scratch == NULL) {
+        const char *errStr = ERRSTR("NULL request or scratch buffer", c_bad);
+        NOTE_C_LOG_ERROR(errStr);
+        return errStr;
+    }
+    if (scratchLen < 4) {
+        const char *errStr = ERRSTR("scratch buffer too small {mem}", c_mem);
+        NOTE_C_LOG_ERROR(errStr);
+        return errStr;
+    }
+#if SIZE_MAX > UINT32_MAX
+    if (scratchLen > UINT32_MAX) {
+        scratchLen = UINT32_MAX;
+    }
+#endif
+
+    // Determine the request or command type
+    const bool reqFound = JGetString(req, "req")[0];
+    const bool cmdFound = JGetString(req, "cmd")[0];
+    if (reqFound == cmdFound) {
+        const char *errStr = ERRSTR("exactly one of req or cmd must be present in API invocation", c_bad);
+        NOTE_C_LOG_ERROR(errStr);
+        return errStr;
+    }
+
+    // Ensure the Notecard is ready
+    if (!_TransactionStart(CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000)) {
+        const char *errStr = ERRSTR("Notecard not ready (CTX/RTX) {io}", c_ioerr);
+        NOTE_C_LOG_ERROR(errStr);
+        return errStr;
+    }
+
+    const _noteApiDescriptor *api = _noteApiLookup(JGetString(req, (reqFound ? c_req : c_cmd)));
+    const uint32_t transactionTimeoutMs = _noteTransaction_calculateTimeoutMs(req, api->flags);
+
+    _LockNote();
+    _Trace(NOTE_C_TRACE_TXN_START, _noteApiIndex(api));
+
+#ifndef NOTE_C_LOW_MEM
+    const uint16_t transactionSeqNo = seqNo;
+#else
+    const uint16_t transactionSeqNo = 0;
+#endif // !NOTE_C_LOW_MEM
+    bool crcAddedToRequest = false;
+
+    // If a reset of the I/O interface is required for any reason, do it now.
+    if (resetRequired) {
+        NOTE_C_LOG_DEBUG("Resetting Notecard I/O Interface...");
+        if ((resetRequired = !_Reset())) {
+            _UnlockNote();
+            _TransactionStop();
+            const char *errStr = ERRSTR("failed to reset Notecard interface {io}", c_iobad);
+            NOTE_C_LOG_ERROR(errStr);
+            return errStr;
+        }
+    }
+
+    // The request and the response share the scratch buffer, so the request
+    // is re-serialized (deterministically, with the same sequence number) on
+    // every retry rather than being kept in a second buffer.
+    const char *errStr = NULL;
+    bool isHeartbeat = false;
+    _noteRetry retry;
+    _noteRetryStart(&retry);
+    for (;;) {
+        errStr = NULL;
+
+        // Heartbeat responses have no request
+        if (!isHeartbeat) {
+            size_t jsonLen = 0;
+            errStr = _noteSerializeBuffered(req, json, scratchLen, reqFound, transactionSeqNo, &jsonLen, &crcAddedToRequest);
+            if (errStr != NULL) {
+                NOTE_C_LOG_ERROR(errStr);
+                break;  // Fatal error, do not retry
+            }
+
+            // Trace request unless suppressed
+            if (suppressShowTransactions == 0) {
+                NOTE_C_LOG_INFO(json);
+            }
+
+            // The Notecard expects a newline-terminated request
+            json[jsonLen++] = '\n';
+            errStr = _ChunkedTransmit(scratch, (uint32_t)jsonLen, true);
+            if (errStr != NULL) {
+                NOTE_C_LOG_WARN(ERRSTR("retrying... transaction failure", c_iobad));
+                resetRequired = !_Reset();
+                if (_noteRetryWait(&retry, RETRY_CLASS_IO)) {
+                    continue;  // I/O error, retry
+                }
+                break;
+            }
+            if (cmdFound) {
+                NOTE_C_LOG_DEBUG("Command successfully sent to Notecard");
+                break;  // No response expected and no further ability to retry.
+            }
+        }
+
+        // Receive the response into the scratch buffer, reserving space for
+        // the null-terminator. A zero `available` primes the I2C interface.
+        uint32_t rspLen = (uint32_t)(scratchLen - 1);
+        uint32_t available = 0;
+        errStr = _ChunkedReceive(scratch, &rspLen, true, transactionTimeoutMs, &available);
+        if (errStr != NULL) {
+            NOTE_C_LOG_WARN(ERRSTR("retrying... transaction failure", c_iobad));
+            resetRequired = !_Reset();
+            if (_noteRetryWait(&retry, RETRY_CLASS_IO)) {
+                continue;  // I/O error, retry
+            }
+            break;
+        }
+        if (available) {
+            // The remainder of the response is still pending on the Notecard,
+            // so the interface must be resynchronized before further use.
+            errStr = ERRSTR("response does not fit in scratch buffer {mem}", c_mem);
+            NOTE_C_LOG_ERROR(errStr);
+            break;  // The caller must supply a larger buffer
+        }
+
+        // Trim the trailing newline (and carriage return), then terminate
+        while (rspLen > 0 && json[rspLen - 1] <= ' ') {
+            rspLen--;
+        }
+        json[rspLen] = '\0';
+
+        // Inspect the Notecard Response
+        if (rspLen < 2 || json[0] != '{' || json[rspLen - 1] != '}') {
+            errStr = ERRSTR("corrupt response {io}", c_ioerr);
+            if (!_noteResendAllowed(api, crcAddedToRequest)) {
+                break;
+            }
+            NOTE_C_LOG_WARN(ERRSTR("retrying... corrupt response", c_iobad));
+            if (_noteRetryWait(&retry, RETRY_CLASS_IO)) {
+                continue;  // I/O error, retry
+            }
+            break;
+        }
+
+#ifndef NOTE_C_LOW_MEM
+        // If we sent a CRC in the request, examine the response JSON to see if
+        // it has a CRC error.  Note that the CRC is stripped from the
+        // response as a side-effect of this method.
+        if (crcAddedToRequest && _crcError(json, transactionSeqNo)) {
+            errStr = ERRSTR("CRC error {io}", c_iobad);
+            NOTE_C_LOG_WARN(ERRSTR("retrying... CRC error", c_iobad));
+            if (_noteRetryWait(&retry, RETRY_CLASS_CRC)) {
+                continue;
+            }
+            break;
+        }
+#else
+        (void)crcAddedToRequest;
+#endif // !NOTE_C_LOW_MEM
+
+        // Error detection / classification, performed on the raw response
+        // text because parsing it would require the heap
+        const char *err = NULL;
+        size_t errLen = 0;
+        const int rspStatus = _noteResponseClassify(json, rspLen, &err, &errLen);
+        isHeartbeat = false;
+        if (rspStatus == RSP_HEARTBEAT) {
+            // Heartbeat responses are not traditional errors, log and resume
+            // waiting. The response is discarded, so the status is terminated
+            // in place.
+            const char *status = "";
+            size_t statusLen = 0;
+            if (_noteJSONScanKey(json, rspLen, c_status, &status, &statusLen) > 0 && status[0] == '"') {
+                json[(status - json) + statusLen - 1] = '\0';
+                status++;
+            } else {
+                status = "";
+            }
+            NOTE_C_LOG_DEBUG(ERRSTR(status, c_heartbeat));
+            _StatsAdd(heartbeats, 1);
+            _Trace(NOTE_C_TRACE_HEARTBEAT, 0);
+#ifdef NOTE_C_HEARTBEAT_CALLBACK
+            if (_noteHeartbeat(status)) {
+                errStr = ERRSTR("host abandoned transaction {heartbeat}", c_heartbeat);
+                NoteResetRequired();
+                break;
+            }
+#else
+            (void)status; // avoid unused variable warning when NOTE_C_LOW_MEM defined
+#endif
+            isHeartbeat = true;
+            continue;  // Heartbeats do not count against retry limit
+        }
+        if (rspStatus == RSP_RETRY_IO || rspStatus == RSP_CORRUPT) {
+            NOTE_C_LOG_ERROR(json);
+            errStr = ERRSTR("corrupt response {io}", c_ioerr);
+            if (rspStatus == RSP_CORRUPT && !_noteResendAllowed(api, crcAddedToRequest)) {
+                break;
+            }
+            NOTE_C_LOG_WARN(ERRSTR("retrying... corrupt response", c_iobad));
+            if (_noteRetryWait(&retry, RETRY_CLASS_IO)) {
+                continue;
+            }
+            break;
+        }
+        if (rspStatus == RSP_BADBIN) {
+            NOTE_C_LOG_ERROR(json);
+            if (_noteRetryWait(&retry, RETRY_CLASS_BADBIN)) {
+                continue;
+            }
+            NOTE_C_LOG_DEBUG("{bad-bin} errors not eligible for retry");
+        }
+
+        // Other Notecard errors are returned to the caller in the response
+        break;
+    } // end of retry loop
+    _StatsRecord(req, NULL, cmdFound, &retry, (errStr != NULL));
+    _Trace(NOTE_C_TRACE_TXN_STOP, (errStr != NULL));
+
+#ifndef NOTE_C_LOW_MEM
+    // Request processing complete, regardless of success or error.
+    // Now, advance the request sequence number.
+    seqNo++;
+#endif // !NOTE_C_LOW_MEM
+
+    if (errStr != NULL) {
+        NoteResetRequired(); // queue up a reset
+    } else if (cmdFound) {
+        // Report an empty object when no response is expected
+        strlcpy(json, "{}", scratchLen);
+    } else if (suppressShowTransactions == 0) {
+        NOTE_C_LOG_INFO(json);
+    }
+
+    _UnlockNote();
+    _TransactionStop();
+
+    return errStr;
+}
+
+J *NoteTransaction(J *req)
+{
+    return _noteTransactionShouldLock(req, true);
+}
+
+J *NoteTransactionWithPriority(J *req, uint8_t priority, uint32_t timeoutMs)
+{
+    // Validate in case of memory failure of the requestor
+    if (req == NULL) {
+        return NULL;
+    }
+
+    if (!_noteLockNotePriority(priority, timeoutMs)) {
+        const char *errStr = ERRSTR("timed out waiting for the Notecard {busy}", c_busy);
+        NOTE_C_LOG_WARN(errStr);
+        if (JGetString(req, c_cmd)[0]) {
+            return NULL;
+        }
+        return _errDoc(JGetInt(req, "id"), errStr);
+    }
+    J *rsp = _noteTransactionShouldLock(req, false);
+    _UnlockNote();
+    return rsp;
+}
+
+/**************************************************************************/
+/*!
+  @brief Same as `NoteTransaction`, but takes an additional parameter that
+  indicates if the Notecard should be locked.
+  @param   req
+  The `J` cJSON request object.
+  @param   lockNotecard
+  Set to `true` if the Notecard should be locked and `false` otherwise.
+  @returns a `J` cJSON object with the response, or NULL if there is
+  insufficient memory.
+*/
+/**************************************************************************/
+J *_noteTransactionShouldLock(J *req, bool lockNotecard)
+{
+    return _noteTransactionShouldLockAndStart(req, lockNotecard, true);
+}
+
+// State shared with the sink while a request is streamed to the Notecard
+typedef struct {
+    bool started;
+    bool hasFields;
+    uint32_t crc;
+    const char *err;
+} _noteStream;
+
+/*!
+ @internal
+
+ @brief Transmit one segment of a streamed request.
+
+ @param context The `_noteStream` state of the request.
+ @param data The segment to transmit.
+ @param length The length of the segment.
+
+ @returns `true` if the segment was transmitted and `false` otherwise.
+ */
+NOTE_C_STATIC Jbool _noteStreamTransmit(void *context, const char *data, size_t length)
+{
+    _noteStream *stream = (_noteStream *)context;
+
+#ifndef NOTE_C_LOW_MEM
+    // Accumulate the CRC as the bytes go out
+    stream->crc = _crc32Update(stream->crc, data, length);
+    stream->hasFields = (stream->hasFields || memchr(data, ':', length) != NULL);
+#endif // !NOTE_C_LOW_MEM
+
+    // Pause between segments so as not to overwhelm the Notecard's interrupt
+    // buffers, just as the chunked transmit functions do within a request.
+    // Serial is paced by the transport, which knows how much the Notecard has
+    // yet to drain.
+    if (stream->started && NoteGetActiveInterface() == NOTE_C_INTERFACE_I2C) {
+        _DelayMs(CARD_REQUEST_I2C_SEGMENT_DELAY_MS);
+    }
+    stream->started = true;
+
+    stream->err = _ChunkedTransmit((const uint8_t *)data, (uint32_t)length, true);
+    return (stream->err == NULL);
+}
+
+/*!
+ @internal
+
+ @brief Serialize a request straight into the active transport, one segment at
+        a time, appending the CRC field and newline to the final segment.
+
+ @param req The request to stream.
+ @param addCrc `true` if a CRC field should be appended.
+ @param seqno The sequence number to include as a part of the CRC.
+ @param crcAdded [out] `true` if the CRC field was appended.
+
+ @returns An error string on failure or NULL on success.
+ */
+NOTE_C_STATIC const char * _noteStreamRequest(J *req, bool addCrc, uint16_t seqno, bool *crcAdded)
+{
+    _noteStream stream = { false, false, 0, NULL };
+    *crcAdded = false;
+
+    char *segment = (char *)_Malloc(STREAM_SEGMENT_LEN);
+    if (segment == NULL) {
+        return ERRSTR("failed to allocate request segment", c_mem);
+    }
+
+    // Hold back room in the final segment for the CRC field and newline
+#ifndef NOTE_C_LOW_MEM
+    const int printLen = (STREAM_SEGMENT_LEN - CRC_FIELD_LENGTH - 1);
+#else
+    const int printLen = (STREAM_SEGMENT_LEN - 1);
+#endif // !NOTE_C_LOW_MEM
+    const int tailLen = JPrintToSink(req, segment, printLen, false, _noteStreamTransmit, &stream);
+    if (tailLen < 0) {
+        _Free(segment);
+        return ((stream.err != NULL) ? stream.err : ERRSTR("failed to serialize JSON request", c_mem));
+    }
+    size_t segmentLen = (size_t)tailLen;
+
+#ifndef NOTE_C_LOW_MEM
+    if (addCrc) {
+        const uint32_t crc = _crc32Update(stream.crc, segment, segmentLen);
+        const bool isEmptyObject = !(stream.hasFields || memchr(segment, ':', segmentLen) != NULL);
+        const size_t crcLen = _crcAppendField(segment, segmentLen, STREAM_SEGMENT_LEN, seqno, crc, isEmptyObject);
+        if (crcLen) {
+            segmentLen = crcLen;
+            *crcAdded = true;
+        }
     }
+#else
+    (void)addCrc;
+    (void)seqno;
+#endif // !NOTE_C_LOW_MEM
+
+    // The Notecard expects a newline-terminated request
+    segment[segmentLen++] = '\n';
+    _noteStreamTransmit(&stream, segment, segmentLen);
+    _Free(segment);
+
+    return stream.err;
+}
+
+/*!
+ @internal
+
+ @brief Inject the user agent object only when we're doing a `hub.set` and
+        specifying the product UID together.
+
+ The goal is to only piggyback user agent data when the host is initializing
+ the Notecard, as opposed to every time the host does a `hub.set` to change
+ mode.
 
-    // Inject the user agent object only when we're doing a `hub.set` and
-    // specifying the product UID together. The goal is to only piggyback
-    // user agent data when the host is initializing the Notecard, as opposed
-    // to every time the host does a `hub.set` to change mode.
+ @param req The request.
+ @param reqFound `true` if the request is a "req" and `false` for a "cmd".
+ */
+static void _noteAddUserAgent(J *req, bool reqFound)
+{
 #ifndef NOTE_DISABLE_USER_AGENT
     if (!JIsPresent(req, "body") && JContainsString(req, (reqFound ? "req" : "cmd"), "hub.set") && JIsPresent(req, "product")) {
         J *body = NoteUserAgent();
@@ -486,20 +1769,222 @@ J *_noteTransactionShouldLock(J *req, bool lockNotecard)
             NOTE_C_LOG_ERROR(ERRSTR("Failed to add user-agent to request", c_mem));
         }
     }
+#else
+    (void)req;
+    (void)reqFound;
 #endif
+}
 
-    // Calculate the transaction timeout based on the parameters in the request.
-    const uint32_t transactionTimeoutMs = _noteTransaction_calculateTimeoutMs(req, reqFound);
-
-    // Take the lock on the Notecard.  This is required to ensure that we don't
-    // have multiple threads trying to access the Notecard at the same time.
-    if (lockNotecard) {
-        _LockNote();
+/**************************************************************************/
+/*!
+  @brief Inspect the response to a request, applying the CRC, heartbeat and
+  error classification rules shared by the transaction paths.
+  @param   rspJsonStr
+  The raw response. Any CRC is stripped from it as a side-effect.
+  @param   crcAdded
+  `true` if a CRC was sent with the request.
+  @param   seqno
+  The sequence number sent with the request.
+  @param   rsp [out]
+  The parsed response, or NULL if it could not be parsed.
+  @param   errStr [out]
+  The error that caused a retry or abandoned the transaction, else untouched.
+  @param   isHeartbeat [out]
+  Set to `true` if the response is a heartbeat, and `false` otherwise. Left
+  untouched when the CRC check fails.
+  @returns `RSP_COMPLETE` when the transaction is done. `RSP_BADBIN` when the
+  response is a `{bad-bin}` error, which the caller either retries according
+  to the retry policy or treats as complete. `RSP_CORRUPT` when the response
+  can't be parsed, which the caller retries only if `_noteResendAllowed`
+  agrees. Otherwise one of `RSP_RETRY_IO`, `RSP_RETRY_CRC`, `RSP_HEARTBEAT` or
+  `RSP_ABANDONED`, and the caller should free `rspJsonStr`.
+*/
+/**************************************************************************/
+NOTE_C_STATIC int _noteTransactionResponse(char *rspJsonStr, bool crcAdded, uint16_t seqno, J **rsp, const char **errStr, bool *isHeartbeat)
+{
+#ifndef NOTE_C_LOW_MEM
+    // If we sent a CRC in the request, examine the response JSON to see if
+    // it has a CRC error.  Note that the CRC is stripped from the
+    // rspJsonStr as a side-effect of this method.
+    if (crcAdded && _crcError(rspJsonStr, seqno)) {
+        *errStr = ERRSTR("CRC error {io}", c_iobad);
+        NOTE_C_LOG_WARN(ERRSTR("retrying... CRC error", c_iobad));
+        return RSP_RETRY_CRC;
     }
+#else
+    (void)crcAdded;
+    (void)seqno;
+#endif // !NOTE_C_LOW_MEM
 
-#ifndef NOTE_C_LOW_MEM
-    /*
-    * Add a CRC value, so the request may be retried if it is received
+    // Error detection / classification, performed on the raw response text
+    // so that no tree is built for responses that are retried or discarded
+    const char *err = NULL;
+    size_t errLen = 0;
+    int rspStatus = _noteResponseClassify(rspJsonStr, strlen(rspJsonStr), &err, &errLen);
+    *rsp = NULL;
+    *isHeartbeat = (rspStatus == RSP_HEARTBEAT);
+
+    // Error handling
+    if (*isHeartbeat) {
+        // Heartbeat responses are not traditional errors, log and resume
+        // waiting. The response is discarded, so the status is terminated in
+        // place.
+        const char *status = "";
+        size_t statusLen = 0;
+        if (_noteJSONScanKey(rspJsonStr, strlen(rspJsonStr), c_status, &status, &statusLen) > 0 && status[0] == '"') {
+            rspJsonStr[(status - rspJsonStr) + statusLen - 1] = '\0';
+            status++;
+        } else {
+            status = "";
+        }
+        NOTE_C_LOG_DEBUG(ERRSTR(status, c_heartbeat));
+        _StatsAdd(heartbeats, 1);
+        _Trace(NOTE_C_TRACE_HEARTBEAT, 0);
+#ifdef NOTE_C_HEARTBEAT_CALLBACK
+        if (_noteHeartbeat(status)) {
+            *errStr = ERRSTR("host abandoned transaction {heartbeat}", c_heartbeat);
+            NoteResetRequired();
+            return RSP_ABANDONED;
+        }
+#else
+        (void)status; // avoid unused variable warning when NOTE_C_LOW_MEM defined
+#endif
+        return RSP_HEARTBEAT;
+    }
+
+    // Only a response that is returned to the caller is parsed
+    if (rspStatus != RSP_RETRY_IO && rspStatus != RSP_CORRUPT) {
+        *rsp = JParse(rspJsonStr);
+    }
+    if (*rsp == NULL) {
+        if (err == NULL) {
+            // Failed to parse response as JSON
+#ifndef NOTE_C_LOW_MEM
+            _DebugWithLevel(NOTE_C_LOG_LEVEL_ERROR, "[ERROR] ");
+            _DebugWithLevel(NOTE_C_LOG_LEVEL_ERROR, "invalid JSON {io}: ");
+            _DebugWithLevel(NOTE_C_LOG_LEVEL_ERROR, rspJsonStr);
+#else
+            NOTE_C_LOG_ERROR(c_ioerr);
+#endif // !NOTE_C_LOW_MEM
+        } else {
+            // The response is discarded, so the error is terminated in place
+            rspJsonStr[(err - rspJsonStr) + errLen] = '\0';
+            NOTE_C_LOG_ERROR(err);
+        }
+        *errStr = ERRSTR("corrupt response {io}", c_ioerr);
+        if (rspStatus != RSP_RETRY_IO) {
+            // Whether a corrupt response may be retried is up to the caller
+            return RSP_CORRUPT;
+        }
+        NOTE_C_LOG_WARN(ERRSTR("retrying... corrupt response", c_iobad));
+        return RSP_RETRY_IO;
+    }
+    if (rspStatus == RSP_BADBIN) {
+        NOTE_C_LOG_ERROR(JGetString(*rsp, c_err));
+    }
+
+    return rspStatus;
+}
+
+/**************************************************************************/
+/*!
+  @brief Decide how a transaction proceeds once its response has been
+  inspected by `_noteTransactionResponse`, applying the retry policy shared by
+  the transaction paths.
+  @param   rspStatus
+  The status returned by `_noteTransactionResponse`.
+  @param   retry
+  The retry state of the transaction.
+  @param   api
+  The descriptor of the API of the request.
+  @param   crcAdded
+  `true` if a CRC was sent with the request.
+  @param   delayMs [out]
+  The delay to observe before resending. When the retries are exhausted this
+  is the delay the blocking paths still observe to let the Notecard settle.
+  @returns `RSP_ACTION_DONE` when the response is to be returned,
+  `RSP_ACTION_FAIL` when the transaction failed with the error set by
+  `_noteTransactionResponse`, `RSP_ACTION_RESEND` when the request is to be
+  sent again after `delayMs`, or `RSP_ACTION_RECEIVE` when the response is
+  still to come.
+*/
+/**************************************************************************/
+static int _noteResponseAction(int rspStatus, _noteRetry *retry, const _noteApiDescriptor *api, bool crcAdded, uint32_t *delayMs)
+{
+    *delayMs = 0;
+    switch (rspStatus) {
+    case RSP_COMPLETE:
+        return RSP_ACTION_DONE;
+    case RSP_HEARTBEAT:
+        // Heartbeats do not count against retry limit
+        return RSP_ACTION_RECEIVE;
+    case RSP_ABANDONED:
+        return RSP_ACTION_FAIL;
+    case RSP_BADBIN:
+        if (!_noteRetryAllowed(retry, RETRY_CLASS_BADBIN, delayMs)) {
+            NOTE_C_LOG_DEBUG("{bad-bin} errors not eligible for retry");
+            return RSP_ACTION_DONE;
+        }
+        return RSP_ACTION_RESEND;
+    case RSP_CORRUPT:
+        if (!_noteResendAllowed(api, crcAdded)) {
+            return RSP_ACTION_FAIL;
+        }
+        NOTE_C_LOG_WARN(ERRSTR("retrying... corrupt response", c_iobad));
+        break;
+    default:
+        break;
+    }
+    if (_noteRetryAllowed(retry, ((rspStatus == RSP_RETRY_CRC) ? RETRY_CLASS_CRC : RETRY_CLASS_IO), delayMs)) {
+        return RSP_ACTION_RESEND;
+    }
+    return RSP_ACTION_FAIL;
+}
+
+/**************************************************************************/
+/*!
+  @brief Perform a transaction whose request has already been validated and,
+  unless it is to be streamed, serialized. This is the shared core of
+  `_noteTransactionShouldLockAndStart` and the request templates.
+  @param   req
+  The `J` cJSON request object, which is only used when `json` is NULL.
+  @param   json
+  The serialized request, which is freed, or NULL to stream `req` to the
+  Notecard as it is serialized.
+  @param   cmdFound
+  Set to `true` if the request is a command (i.e. "cmd") rather than a request.
+  @param   id
+  The "id" of the request, returned with any error.
+  @param   transactionTimeoutMs
+  The time allowed for the Notecard to respond.
+  @param   api
+  The descriptor of the API of the request.
+  @param   lockNotecard
+  Set to `true` if the Notecard should be locked and `false` otherwise.
+  @param   startTransaction
+  Set to `true` if the caller opened the transaction window, which is closed
+  once the transaction is complete.
+  @returns a `J` cJSON object with the response, or NULL if there is
+  insufficient memory.
+*/
+/**************************************************************************/
+static J *_noteTransactionSerialized(J *req, char *json, bool cmdFound, uint32_t id, uint32_t transactionTimeoutMs, const _noteApiDescriptor *api, bool lockNotecard, bool startTransaction)
+{
+#ifndef NOTE_C_LOW_MEM
+    const bool reqFound = !cmdFound;
+#endif // !NOTE_C_LOW_MEM
+    const bool streamRequest = (json == NULL);
+
+    // Take the lock on the Notecard.  This is required to ensure that we don't
+    // have multiple threads trying to access the Notecard at the same time.
+    if (lockNotecard) {
+        _LockNote();
+    }
+    _Trace(NOTE_C_TRACE_TXN_START, _noteApiIndex(api));
+
+#ifndef NOTE_C_LOW_MEM
+    /*
+    * Add a CRC value, so the request may be retried if it is received
     * in a corrupted state.
     *
     * NOTE: This can only performed on requests, because commands do not have a
@@ -518,12 +2003,1103 @@ J *_noteTransactionShouldLock(J *req, bool lockNotecard)
     */
     const uint16_t transactionSeqNo = seqNo;
     bool crcAddedToRequest = false;
+    if (reqFound && !streamRequest) {
+        char *newJson = _crcAdd(json, transactionSeqNo);
+        if (newJson != NULL) {
+            _Free(json);
+            json = newJson;
+            crcAddedToRequest = true;
+        }
+    }
+#endif // !NOTE_C_LOW_MEM
+
+    // If a reset of the I/O interface is required for any reason, do it now.
+    if (resetRequired) {
+        NOTE_C_LOG_DEBUG("Resetting Notecard I/O Interface...");
+        if ((resetRequired = !_Reset())) {
+            if (lockNotecard) {
+                _UnlockNote();
+            }
+            _Free(json);
+            if (startTransaction) {
+                _TransactionStop();
+            }
+            const char *errStr = ERRSTR("failed to reset Notecard interface {io}", c_iobad);
+            if (cmdFound) {
+                NOTE_C_LOG_ERROR(errStr);
+                return NULL;
+            }
+            return _errDoc(id, errStr);
+        }
+    }
+
+    // Let the transport size its receive buffer for the expected response
+    cardResponseSizeHint = api->rspSize;
+
+    // If we're performing retries, this is where we come back to
+    // after a failed transaction.
+    const char *errStr = NULL;
+    char *rspJsonStr = NULL;
+    J *rsp = NULL;
+    bool isHeartbeat = false;
+    _noteRetry retry;
+    _noteRetryStart(&retry);
+    for (;;) {
+        // free on retry
+        if (rsp != NULL) {
+            JDelete(rsp);
+        }
+
+        // reset variables
+        errStr = NULL;
+        rspJsonStr = NULL;
+        rsp = NULL;
+
+        if (streamRequest) {
+            // Heartbeat responses have no request
+            if (!isHeartbeat) {
+#ifndef NOTE_C_LOW_MEM
+                errStr = _noteStreamRequest(req, reqFound, transactionSeqNo, &crcAddedToRequest);
+#else
+                bool crcAddedToRequest = false;
+                errStr = _noteStreamRequest(req, false, 0, &crcAddedToRequest);
+#endif // !NOTE_C_LOW_MEM
+            }
+
+            // With the request already sent, only the response remains
+            if (errStr == NULL && !cmdFound) {
+                errStr = _Transaction("", 0, &rspJsonStr, transactionTimeoutMs);
+            }
+        } else {
+            // Trace request unless suppressed
+            if (!isHeartbeat && suppressShowTransactions == 0) {
+                NOTE_C_LOG_INFO(json);
+            }
+
+            // In-place replacement of NULL-terminator with a newline character.
+            // The Notecard expects a newline-terminated string to understand the
+            // end of the request.
+            const size_t jsonLen = strlen(json);
+            json[jsonLen] = '\n';
+
+            size_t jsonTxLen;
+            if (isHeartbeat) {
+                // Heartbeat responses have no request
+                jsonTxLen = 0;
+            } else {
+                jsonTxLen = (jsonLen + 1);
+            }
+
+            // Perform the transaction
+            if (cmdFound) {
+                errStr = _Transaction(json, jsonTxLen, NULL, transactionTimeoutMs);
+                // break;  // No response expected for commands and no ability to retry.
+            } else {
+                errStr = _Transaction(json, jsonTxLen, &rspJsonStr, transactionTimeoutMs);
+            }
+
+            // Restore NULL-terminator
+            json[jsonLen] = '\0';
+        }
+
+        ////////////////////////
+        // Request retry logic
+        ////////////////////////
+
+        // Handle transaction errors
+        if (errStr != NULL) {
+            _Free(rspJsonStr);
+            // If there's an I/O error on the transaction, retry
+            if (NoteErrorContains(errStr, c_ioerr)) {
+                NOTE_C_LOG_WARN(ERRSTR("retrying... transaction failure", c_iobad));
+                resetRequired = !_Reset();
+                if (_noteRetryWait(&retry, RETRY_CLASS_IO)) {
+                    continue;  // I/O error, retry
+                }
+                break;
+            } else {
+                NOTE_C_LOG_DEBUG(ERRSTR("transaction failure", c_bad));
+                break;  // Fatal error, do not retry
+            }
+        } else if (cmdFound) {
+            NOTE_C_LOG_DEBUG("Command successfully sent to Notecard");
+            break;  // No response expected and no further ability to retry.
+        }
+
+        // Inspect the Notecard Response
+        if (rspJsonStr == NULL) {
+            // If the response is NULL, then we have a timeout or other error
+            errStr = ERRSTR("response expected, but response is NULL {io}", c_ioerr);
+            NOTE_C_LOG_WARN(ERRSTR("retrying... no response", c_iobad));
+            if (_noteRetryWait(&retry, RETRY_CLASS_IO)) {
+                continue;  // I/O error, retry
+            }
+            break;
+        }
+
+        // Inspect the Notecard response
+#ifndef NOTE_C_LOW_MEM
+        const int rspStatus = _noteTransactionResponse(rspJsonStr, crcAddedToRequest, transactionSeqNo, &rsp, &errStr, &isHeartbeat);
+#else
+        const int rspStatus = _noteTransactionResponse(rspJsonStr, false, 0, &rsp, &errStr, &isHeartbeat);
+        const bool crcAddedToRequest = false;
+#endif // !NOTE_C_LOW_MEM
+        uint32_t delayMs = 0;
+        const int action = _noteResponseAction(rspStatus, &retry, api, crcAddedToRequest, &delayMs);
+
+        // Pace the final failure too, so that the Notecard settles before the
+        // interface reset queued by the failed transaction
+        if (delayMs > 0) {
+            _DelayMs(delayMs);
+        }
+        if (action == RSP_ACTION_DONE) {
+            break;
+        }
+        _Free(rspJsonStr);
+        if (action == RSP_ACTION_FAIL) {
+            break;
+        }
+    } // end of retry loop
+    cardResponseSizeHint = 0;
+    _StatsRecord(req, json, cmdFound, &retry, (errStr != NULL));
+    _Trace(NOTE_C_TRACE_TXN_STOP, (errStr != NULL));
+
+    // Free the original serialized JSON request
+    _Free(json);
+
+#ifndef NOTE_C_LOW_MEM
+    // Request processing complete, regardless of success or error.
+    // Now, advance the request sequence number.
+    seqNo++;
+#endif // !NOTE_C_LOW_MEM
+
+    // Return an empty object (with no err field) when no response is expected
+    if (cmdFound) {
+        if (lockNotecard) {
+            _UnlockNote();
+        }
+        if (startTransaction) {
+            _TransactionStop();
+        }
+        return JCreateObject();
+    }
+
+    // Handle error condition
+    if (errStr != NULL) {
+        if (rsp != NULL) {
+            JDelete(rsp);
+            rsp = NULL;
+        }
+        NoteResetRequired(); // queue up a reset
+        J *errRsp = _errDoc(id, errStr);
+        if (lockNotecard) {
+            _UnlockNote();
+        }
+        if (startTransaction) {
+            _TransactionStop();
+        }
+        return errRsp;
+    }
+
+    // Log and discard the response JSON
+    if (suppressShowTransactions == 0) {
+        NOTE_C_LOG_INFO(rspJsonStr);
+    }
+    _Free(rspJsonStr);
+
+    // Release the Notecard lock
+    if (lockNotecard) {
+        _UnlockNote();
+    }
+
+    // Inform the Notecard that the transaction is complete.
+    // This allows the Notecard (ESP) to drop into low power mode.
+    if (startTransaction) {
+        _TransactionStop();
+    }
+
+    // Done
+    return rsp;
+}
+
+/**************************************************************************/
+/*!
+  @brief Same as `_noteTransactionShouldLock`, but takes an additional
+  parameter that indicates if the transaction window (i.e. the
+  `_TransactionStart`/`_TransactionStop` hooks) should be managed.
+  @param   req
+  The `J` cJSON request object.
+  @param   lockNotecard
+  Set to `true` if the Notecard should be locked and `false` otherwise.
+  @param   startTransaction
+  Set to `true` to open and close the transaction window around this request,
+  or `false` if the caller already holds it open (e.g. `NoteRequestBatch`).
+  @returns a `J` cJSON object with the response, or NULL if there is
+  insufficient memory.
+*/
+/**************************************************************************/
+J *_noteTransactionShouldLockAndStart(J *req, bool lockNotecard, bool startTransaction)
+{
+    // Validate in case of memory failure of the requestor
+    if (req == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("NULL request", c_bad));
+        return NULL;
+    }
+
+    // Serialize the JSON request, unless it will be streamed to the Notecard
+    // as it is serialized
+    char *json = NULL;
+    if (!streamRequests && (json = JPrintUnformatted(req)) == NULL) { // `json` allocated, must be freed
+        NOTE_C_LOG_ERROR(ERRSTR("failed to serialize JSON request", c_mem));
+        return NULL;
+    }
+
+    // Determine the request or command type
+    const char * const reqApi = JGetString(req, "req");
+    const bool reqFound = reqApi[0];  // test for non-empty string
+    const char * const cmdApi = JGetString(req, "cmd");
+    const bool cmdFound = cmdApi[0];  // test for non-empty string
+
+    // If neither `"req"` nor `"cmd"` are found, then we have an error
+    // condition. If both are present, then we have undefined behavior.
+    if (!reqFound && !cmdFound) {
+        _Free(json);
+        NOTE_C_LOG_ERROR(ERRSTR("neither req nor cmd found in API invocation (invalid JSON)", c_bad));
+        return NULL;
+    } else if (reqFound && cmdFound) {
+        _Free(json);
+        NOTE_C_LOG_ERROR(ERRSTR("both req and cmd present in API invocation (undefined behavior)", c_bad));
+        return NULL;
+    }
+
+    // Extract the ID of the request so that errors can be returned with the same ID
+    const uint32_t id = JGetInt(req, "id");
+
+    // Ensure the Notecard is ready
+    if (startTransaction && !_TransactionStart(CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000)) {
+        _Free(json);
+        const char *errStr = ERRSTR("Notecard not ready (CTX/RTX) {io}", c_ioerr);
+        if (cmdFound) {
+            NOTE_C_LOG_ERROR(errStr);
+            return NULL;
+        }
+        return _errDoc(id, errStr);
+    }
+
+    _noteAddUserAgent(req, reqFound);
+
+    // Calculate the transaction timeout based on the API and the parameters in
+    // the request.
+    const _noteApiDescriptor *api = _noteApiLookup(JGetString(req, (reqFound ? c_req : c_cmd)));
+    const uint32_t transactionTimeoutMs = _noteTransaction_calculateTimeoutMs(req, api->flags);
+
+    return _noteTransactionSerialized(req, json, cmdFound, id, transactionTimeoutMs, api, lockNotecard, startTransaction);
+}
+
+// A slot of a request template, whose placeholder is replaced when sent
+typedef struct {
+    size_t offset;          // Offset of the placeholder in the skeleton
+    size_t placeholderLen;  // Length of the placeholder, including its quotes
+    char *value;            // Serialized value, or NULL until it is set
+    size_t valueLen;
+    size_t valueAlloc;
+} _noteTemplateSlot;
+
+struct NoteRequestTemplate {
+    char *skeleton;         // Serialized request, including the placeholders
+    size_t skeletonLen;
+    _noteTemplateSlot *slots;
+    uint32_t slotCount;
+    uint32_t id;
+    uint32_t timeoutMs;
+    const _noteApiDescriptor *api;
+    bool isCmd;
+};
+
+/*!
+ @internal
+
+ @brief Find the next slot placeholder (i.e. a `"{{name}}"` string value) in
+        the skeleton of a request template.
+
+ @param p The position in the skeleton to search from.
+ @param placeholderLen [out] The length of the placeholder, including its
+        quotes.
+
+ @returns The position of the opening quote of the placeholder, or NULL if
+          there are no more placeholders.
+ */
+static const char * _noteTemplateNextSlot(const char *p, size_t *placeholderLen)
+{
+    while ((p = strstr(p, "\"{{")) != NULL) {
+        const char * const name = (p + 3);
+        size_t nameLen = 0;
+        while (name[nameLen] != '\0' && name[nameLen] != '}' && name[nameLen] != '"' && name[nameLen] != '\\') {
+            nameLen++;
+        }
+
+        // Skip placeholders used as keys, or embedded within another string
+        if (nameLen > 0 && p[-1] != '\\' && name[nameLen] == '}' && name[nameLen + 1] == '}'
+                && name[nameLen + 2] == '"' && name[nameLen + 3] != ':') {
+            *placeholderLen = (nameLen + 6);
+            return p;
+        }
+        p = name;
+    }
+    return NULL;
+}
+
+/*!
+ @internal
+
+ @brief Find a slot of a request template by name.
+
+ @param tmpl The request template.
+ @param slot The name of the slot.
+ @param slotLen The length of the name of the slot.
+
+ @returns The slot, or NULL if there's no such slot.
+ */
+static _noteTemplateSlot * _noteTemplateFindSlot(NoteRequestTemplate *tmpl, const char *slot, size_t slotLen)
+{
+    for (uint32_t i = 0 ; i < tmpl->slotCount ; ++i) {
+        _noteTemplateSlot * const s = &tmpl->slots[i];
+        if (s->placeholderLen == (slotLen + 6) && memcmp(&tmpl->skeleton[s->offset + 3], slot, slotLen) == 0) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+/*!
+ @internal
+
+ @brief Set the serialized value of a slot of a request template.
+
+ @param tmpl The request template.
+ @param slot The name of the slot.
+ @param value The serialized value, or NULL if it is to be written by the
+        caller into the returned buffer.
+ @param valueLen The length of the serialized value.
+
+ @returns The null-terminated value of the slot, or NULL if there's no such
+          slot or there is insufficient memory.
+ */
+static char * _noteTemplateSetValue(NoteRequestTemplate *tmpl, const char *slot, const char *value, size_t valueLen)
+{
+    if (tmpl == NULL || slot == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("NULL request template", c_bad));
+        return NULL;
+    }
+
+    _noteTemplateSlot * const s = _noteTemplateFindSlot(tmpl, slot, strlen(slot));
+    if (s == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("no such request template slot", c_bad));
+        return NULL;
+    }
+
+    // Values are only reallocated when they grow
+    if (s->valueAlloc < (valueLen + 1)) {
+        char * const newValue = (char *)_Malloc(valueLen + 1);
+        if (newValue == NULL) {
+            NOTE_C_LOG_ERROR(ERRSTR("insufficient memory for request template value", c_mem));
+            return NULL;
+        }
+        _Free(s->value);
+        s->value = newValue;
+        s->valueAlloc = (valueLen + 1);
+    }
+    if (value != NULL) {
+        memcpy(s->value, value, valueLen);
+    }
+    s->value[valueLen] = '\0';
+    s->valueLen = valueLen;
+    return s->value;
+}
+
+/*!
+ @internal
+
+ @brief Stamp the slot values into the skeleton of a request template, and
+        perform the resulting transaction.
+
+ @param tmpl The request template.
+
+ @returns A `J` cJSON object with the response, or NULL if the request could
+          not be sent.
+ */
+static J * _noteTemplateTransaction(NoteRequestTemplate *tmpl)
+{
+    if (tmpl == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("NULL request template", c_bad));
+        return NULL;
+    }
+
+    size_t jsonLen = tmpl->skeletonLen;
+    for (uint32_t i = 0 ; i < tmpl->slotCount ; ++i) {
+        if (tmpl->slots[i].value == NULL) {
+            NOTE_C_LOG_ERROR(ERRSTR("request template slot not set", c_bad));
+            return NULL;
+        }
+        jsonLen = ((jsonLen - tmpl->slots[i].placeholderLen) + tmpl->slots[i].valueLen);
+    }
+
+    // Copy the skeleton, replacing each placeholder with its value
+    char * const json = (char *)_Malloc(jsonLen + 1);  // freed by the transaction
+    if (json == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("insufficient memory for request template", c_mem));
+        return NULL;
+    }
+    size_t skeletonOffset = 0;
+    char *p = json;
+    for (uint32_t i = 0 ; i < tmpl->slotCount ; ++i) {
+        const _noteTemplateSlot * const s = &tmpl->slots[i];
+        memcpy(p, &tmpl->skeleton[skeletonOffset], (s->offset - skeletonOffset));
+        p += (s->offset - skeletonOffset);
+        memcpy(p, s->value, s->valueLen);
+        p += s->valueLen;
+        skeletonOffset = (s->offset + s->placeholderLen);
+    }
+    memcpy(p, &tmpl->skeleton[skeletonOffset], ((tmpl->skeletonLen - skeletonOffset) + 1));
+
+    // Ensure the Notecard is ready
+    if (!_TransactionStart(CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000)) {
+        _Free(json);
+        const char *errStr = ERRSTR("Notecard not ready (CTX/RTX) {io}", c_ioerr);
+        if (tmpl->isCmd) {
+            NOTE_C_LOG_ERROR(errStr);
+            return NULL;
+        }
+        return _errDoc(tmpl->id, errStr);
+    }
+
+    return _noteTransactionSerialized(NULL, json, tmpl->isCmd, tmpl->id, tmpl->timeoutMs, tmpl->api, true, true);
+}
+
+NoteRequestTemplate * NoteRequestTemplateNew(J *req)
+{
+    if (req == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("NULL request", c_bad));
+        return NULL;
+    }
+
+    // Determine the request or command type
+    const bool reqFound = JGetString(req, "req")[0];
+    const bool cmdFound = JGetString(req, "cmd")[0];
+    if (reqFound == cmdFound) {
+        NOTE_C_LOG_ERROR(ERRSTR("request template must have exactly one of req or cmd", c_bad));
+        JDelete(req);
+        return NULL;
+    }
+
+    NoteRequestTemplate * const tmpl = (NoteRequestTemplate *)_Malloc(sizeof(NoteRequestTemplate));
+    if (tmpl == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("insufficient memory for request template", c_mem));
+        JDelete(req);
+        return NULL;
+    }
+    memset(tmpl, 0, sizeof(NoteRequestTemplate));
+    tmpl->isCmd = cmdFound;
+    tmpl->id = JGetInt(req, "id");
+    tmpl->api = _noteApiLookup(JGetString(req, (reqFound ? c_req : c_cmd)));
+    tmpl->timeoutMs = _noteTransaction_calculateTimeoutMs(req, tmpl->api->flags);
+    tmpl->skeleton = JPrintUnformatted(req);
+    JDelete(req);
+    if (tmpl->skeleton == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("failed to serialize JSON request", c_mem));
+        _Free(tmpl);
+        return NULL;
+    }
+    tmpl->skeletonLen = strlen(tmpl->skeleton);
+
+    // Locate the slots
+    size_t placeholderLen = 0;
+    for (const char *p = tmpl->skeleton ; (p = _noteTemplateNextSlot(p, &placeholderLen)) != NULL ; p += placeholderLen) {
+        tmpl->slotCount++;
+    }
+    if (tmpl->slotCount > 0) {
+        tmpl->slots = (_noteTemplateSlot *)_Malloc(tmpl->slotCount * sizeof(_noteTemplateSlot));
+        if (tmpl->slots == NULL) {
+            NOTE_C_LOG_ERROR(ERRSTR("insufficient memory for request template", c_mem));
+            NoteRequestTemplateDelete(tmpl);
+            return NULL;
+        }
+        memset(tmpl->slots, 0, tmpl->slotCount * sizeof(_noteTemplateSlot));
+        uint32_t i = 0;
+        for (const char *p = tmpl->skeleton ; (p = _noteTemplateNextSlot(p, &placeholderLen)) != NULL ; p += placeholderLen) {
+            if (_noteTemplateFindSlot(tmpl, (p + 3), (placeholderLen - 6)) != NULL) {
+                NOTE_C_LOG_ERROR(ERRSTR("duplicate request template slot", c_bad));
+                NoteRequestTemplateDelete(tmpl);
+                return NULL;
+            }
+            tmpl->slots[i].offset = (size_t)(p - tmpl->skeleton);
+            tmpl->slots[i].placeholderLen = placeholderLen;
+            i++;
+        }
+    }
+
+    return tmpl;
+}
+
+void NoteRequestTemplateDelete(NoteRequestTemplate *tmpl)
+{
+    if (tmpl == NULL) {
+        return;
+    }
+    for (uint32_t i = 0 ; i < tmpl->slotCount && tmpl->slots != NULL ; ++i) {
+        _Free(tmpl->slots[i].value);
+    }
+    _Free(tmpl->slots);
+    _Free(tmpl->skeleton);
+    _Free(tmpl);
+}
+
+bool NoteRequestTemplateSetInt(NoteRequestTemplate *tmpl, const char *slot, JINTEGER value)
+{
+    char buf[JNTOA_MAX];
+    JItoA(value, buf);
+    return (_noteTemplateSetValue(tmpl, slot, buf, strlen(buf)) != NULL);
+}
+
+bool NoteRequestTemplateSetNumber(NoteRequestTemplate *tmpl, const char *slot, JNUMBER value)
+{
+    // Numbers are formatted exactly as `JPrintUnformatted` formats them
+    char buf[JNTOA_MAX];
+    if ((value * 0) != 0) {
+        strlcpy(buf, "null", sizeof(buf));
+    } else if (value > (JNUMBER)JINTEGER_MIN && value < (JNUMBER)JINTEGER_MAX && value == (JNUMBER)(JINTEGER)value) {
+        JItoA((JINTEGER)value, buf);
+    } else {
+        JNtoA(value, buf, -1);
+    }
+    return (_noteTemplateSetValue(tmpl, slot, buf, strlen(buf)) != NULL);
+}
+
+bool NoteRequestTemplateSetString(NoteRequestTemplate *tmpl, const char *slot, const char *value)
+{
+    if (value == NULL) {
+        value = "";
+    }
+
+    // Measure the string once it is quoted and escaped
+    size_t valueLen = 2;
+    for (const unsigned char *c = (const unsigned char *)value ; *c != '\0' ; ++c) {
+        if (*c == '"' || *c == '\\' || *c == '\b' || *c == '\f' || *c == '\n' || *c == '\r' || *c == '\t') {
+            valueLen += 2;
+        } else if (*c < 32) {
+            valueLen += 6;
+        } else {
+            valueLen += 1;
+        }
+    }
+
+    // Reserve the slot value, then quote and escape the string into it
+    char *out = _noteTemplateSetValue(tmpl, slot, NULL, valueLen);
+    if (out == NULL) {
+        return false;
+    }
+    *out++ = '"';
+    for (const unsigned char *c = (const unsigned char *)value ; *c != '\0' ; ++c) {
+        static const char hex[] = "0123456789abcdef";
+        switch (*c) {
+        case '"':
+        case '\\':
+            *out++ = '\\';
+            *out++ = (char)*c;
+            break;
+        case '\b':
+            *out++ = '\\';
+            *out++ = 'b';
+            break;
+        case '\f':
+            *out++ = '\\';
+            *out++ = 'f';
+            break;
+        case '\n':
+            *out++ = '\\';
+            *out++ = 'n';
+            break;
+        case '\r':
+            *out++ = '\\';
+            *out++ = 'r';
+            break;
+        case '\t':
+            *out++ = '\\';
+            *out++ = 't';
+            break;
+        default:
+            if (*c < 32) {
+                *out++ = '\\';
+                *out++ = 'u';
+                *out++ = '0';
+                *out++ = '0';
+                *out++ = hex[*c >> 4];
+                *out++ = hex[*c & 0xF];
+            } else {
+                *out++ = (char)*c;
+            }
+            break;
+        }
+    }
+    *out = '"';
+
+    return true;
+}
+
+J * NoteRequestTemplateResponse(NoteRequestTemplate *tmpl)
+{
+    return _noteTemplateTransaction(tmpl);
+}
+
+bool NoteRequestTemplateSend(NoteRequestTemplate *tmpl)
+{
+    J *rsp = _noteTemplateTransaction(tmpl);
+    if (rsp == NULL) {
+        return false;
+    }
+
+    // Check for a transaction error, and exit
+    bool success = JIsNullString(rsp, c_err);
+    JDelete(rsp);
+
+    return success;
+}
+
+// States of the non-blocking transaction driven by NoteTransactionPoll()
+#define TXN_STATE_IDLE          0
+#define TXN_STATE_TRANSMIT      1
+#define TXN_STATE_RECEIVE       2
+#define TXN_STATE_RETRY         3
+#define TXN_STATE_COMPLETE      4
+
+typedef struct {
+    J *rsp;                 // Response (or error document) once complete
+    const _noteApiDescriptor *api;
+    char *json;             // Serialized request
+    uint8_t *rspBuf;        // Response received so far
+    size_t jsonLen;
+    size_t jsonSent;
+    uint32_t rspLen;
+    uint32_t rspAllocLen;
+    uint32_t id;
+    uint32_t timeoutMs;     // Time allowed for the response to start arriving
+    uint32_t rxStartMs;     // Start of the wait for the next response byte
+    uint32_t waitStartMs;
+    uint32_t waitMs;
+    _noteRetry retry;
+    uint16_t seqno;
+    uint8_t state;
+    bool isCmd;
+    bool isHeartbeat;
+    bool crcAdded;
+} _noteAsyncTransaction;
+
+static _noteAsyncTransaction asyncTxn;
+
+/*!
+ @internal
+
+ @brief Start a non-blocking wait, checked by `_noteAsyncWaiting`.
+
+ @param ms The length of the wait, in milliseconds.
+ */
+static void _noteAsyncWait(uint32_t ms)
+{
+    asyncTxn.waitStartMs = _GetMs();
+    asyncTxn.waitMs = ms;
+}
+
+/*!
+ @internal
+
+ @brief Determine whether the wait started by `_noteAsyncWait` is still running.
+
+ @returns `true` if the wait has not yet elapsed.
+ */
+static bool _noteAsyncWaiting(void)
+{
+    return ((_GetMs() - asyncTxn.waitStartMs) < asyncTxn.waitMs);
+}
+
+/*!
+ @internal
+
+ @brief Complete the non-blocking transaction, producing its response and
+        releasing the Notecard.
+
+ @param errStr The error that ended the transaction, or NULL on success.
+ */
+static void _noteAsyncFinish(const char *errStr)
+{
+    _StatsRecord(NULL, asyncTxn.json, asyncTxn.isCmd, &asyncTxn.retry, (errStr != NULL));
+    _Trace(NOTE_C_TRACE_TXN_STOP, (errStr != NULL));
+    _Free(asyncTxn.json);
+    asyncTxn.json = NULL;
+    _Free(asyncTxn.rspBuf);
+    asyncTxn.rspBuf = NULL;
+
+#ifndef NOTE_C_LOW_MEM
+    // Request processing complete, regardless of success or error.
+    // Now, advance the request sequence number.
+    seqNo++;
+#endif // !NOTE_C_LOW_MEM
+
+    if (asyncTxn.isCmd) {
+        // Return an empty object (with no err field) when no response is expected
+        JDelete(asyncTxn.rsp);
+        asyncTxn.rsp = JCreateObject();
+    } else if (errStr != NULL) {
+        JDelete(asyncTxn.rsp);
+        NoteResetRequired(); // queue up a reset
+        asyncTxn.rsp = _errDoc(asyncTxn.id, errStr);
+    }
+
+    _UnlockNote();
+    _TransactionStop();
+    asyncTxn.state = TXN_STATE_COMPLETE;
+}
+
+/*!
+ @internal
+
+ @brief Schedule another attempt at the non-blocking transaction, or complete
+        it with an error once the retries are exhausted.
+
+ @param errStr The error that caused the retry.
+ @param errClass The class of the error (i.e. `RETRY_CLASS_*`).
+ */
+static void _noteAsyncRetry(const char *errStr, int errClass)
+{
+    uint32_t delayMs = 0;
+    if (!_noteRetryAllowed(&asyncTxn.retry, errClass, &delayMs)) {
+        _noteAsyncFinish(errStr);
+        return;
+    }
+    asyncTxn.state = TXN_STATE_RETRY;
+    _noteAsyncWait(delayMs);
+}
+
+/*!
+ @internal
+
+ @brief Handle an error returned by the transport, retrying I/O errors.
+
+ @param errStr The error returned by the transport.
+ */
+static void _noteAsyncTransportError(const char *errStr)
+{
+    if (NoteErrorContains(errStr, c_ioerr)) {
+        NOTE_C_LOG_WARN(ERRSTR("retrying... transaction failure", c_iobad));
+        resetRequired = !_Reset();
+        _noteAsyncRetry(errStr, RETRY_CLASS_IO);
+    } else {
+        NOTE_C_LOG_DEBUG(ERRSTR("transaction failure", c_bad));
+        _noteAsyncFinish(errStr);
+    }
+}
+
+/*!
+ @internal
+
+ @brief Read whatever part of the response the Notecard has already sent,
+        without waiting for more to arrive.
+
+ @param buffer The buffer to receive into.
+ @param size (in/out)
+        - (in) The space left in the buffer.
+        - (out) The number of bytes received.
+ @param eop [out] Set to `true` once the newline ending the response has been
+        received.
+
+ @returns A c-string with an error, or `NULL` if no error ocurred.
+ */
+static const char * _noteAsyncReceive(uint8_t *buffer, uint32_t *size, bool *eop)
+{
+    uint32_t received = 0;
+    const char *err = NULL;
+    const int iface = NoteGetActiveInterface();
+
+    if (iface == NOTE_C_INTERFACE_SERIAL) {
+        while (received < *size && _SerialAvailable()) {
+            const char ch = _SerialReceive();
+            buffer[received++] = ch;
+            if (ch == '\n') {
+                *eop = true;
+                break;
+            }
+        }
+    } else if (iface == NOTE_C_INTERFACE_I2C) {
+        // Query the amount of data the Notecard has queued, then read as much
+        // of it as fits
+        uint32_t available = 0;
+        _LockI2C();
+        err = _I2CReceive(_I2CAddress(), buffer, 0, &available);
+        while (err == NULL && available > 0 && received < *size) {
+            uint32_t chunk = (*size - received);
+            chunk = (chunk > available) ? available : chunk;
+            chunk = (chunk > 0xFFFF) ? 0xFFFF : chunk;
+            chunk = (chunk > _I2CMax()) ? _I2CMax() : chunk;
+            err = _I2CReceive(_I2CAddress(), (buffer + received), (uint16_t)chunk, &available);
+            if (err == NULL) {
+                received += chunk;
+            }
+        }
+        _UnlockI2C();
+
+        // The response is complete when it ends in a newline and nothing
+        // further is pending
+        *eop = (err == NULL && available == 0 && received > 0 && buffer[received - 1] == '\n');
+    } else {
+        err = "a valid interface must be selected";
+    }
+
+    *size = received;
+    return err;
+}
+
+/*!
+ @internal
+
+ @brief Transmit the next piece of the request.
+
+ A piece is a serial segment or an I2C chunk, and the pause the blocking
+ transmit functions take after each one is instead taken as a non-blocking
+ wait before the next.
+
+ @returns `true` if the state machine may continue to the next state, or
+          `false` if it must wait.
+ */
+static bool _noteAsyncTransmit(void)
+{
+    if (_noteAsyncWaiting()) {
+        return false;
+    }
+
+    // Heartbeat responses have no request
+    if (asyncTxn.isHeartbeat) {
+        asyncTxn.state = TXN_STATE_RECEIVE;
+        asyncTxn.rspLen = 0;
+        asyncTxn.rxStartMs = _GetMs();
+        return true;
+    }
+
+    // Trace request unless suppressed
+    if (asyncTxn.jsonSent == 0 && suppressShowTransactions == 0) {
+        NOTE_C_LOG_INFO(asyncTxn.json);
+    }
+
+    // The request is sent with the newline the Notecard expects in place of
+    // its NULL-terminator
+    const size_t txLen = (asyncTxn.jsonLen + 1);
+    const bool i2c = (NoteGetActiveInterface() == NOTE_C_INTERFACE_I2C);
+    const size_t maxStep = (i2c ? _I2CMax() : _serialPacingSegmentLen());
+    const size_t step = ((txLen - asyncTxn.jsonSent) < maxStep) ? (txLen - asyncTxn.jsonSent) : maxStep;
+
+    asyncTxn.json[asyncTxn.jsonLen] = '\n';
+    const char *err = _ChunkedTransmit((const uint8_t *)(asyncTxn.json + asyncTxn.jsonSent), (uint32_t)step, false);
+    asyncTxn.json[asyncTxn.jsonLen] = '\0';
+    if (err != NULL) {
+        _noteAsyncTransportError(err);
+        return true;
+    }
+    const size_t sentBefore = asyncTxn.jsonSent;
+    asyncTxn.jsonSent += step;
+    if (!i2c) {
+        _serialPacingSent((uint32_t)step);
+    }
+
+    // Pause between pieces so as not to overwhelm the Notecard
+    if (asyncTxn.jsonSent < txLen) {
+        if (!i2c) {
+            const size_t nextStep = (((txLen - asyncTxn.jsonSent) < maxStep) ? (txLen - asyncTxn.jsonSent) : maxStep);
+            _noteAsyncWait(_serialPacingDelayMs((uint32_t)nextStep));
+        } else if ((sentBefore / CARD_REQUEST_I2C_SEGMENT_MAX_LEN) != (asyncTxn.jsonSent / CARD_REQUEST_I2C_SEGMENT_MAX_LEN)) {
+            _noteAsyncWait(CARD_REQUEST_I2C_SEGMENT_DELAY_MS + CARD_REQUEST_I2C_CHUNK_DELAY_MS);
+        } else {
+            _noteAsyncWait(CARD_REQUEST_I2C_CHUNK_DELAY_MS);
+        }
+        return false;
+    }
+
+    // No response expected for commands and no ability to retry
+    if (asyncTxn.isCmd) {
+        NOTE_C_LOG_DEBUG("Command successfully sent to Notecard");
+        _noteAsyncFinish(NULL);
+        return true;
+    }
+
+    asyncTxn.state = TXN_STATE_RECEIVE;
+    asyncTxn.rspLen = 0;
+    asyncTxn.rxStartMs = _GetMs();
+    return true;
+}
+
+/*!
+ @internal
+
+ @brief Receive whatever part of the response has arrived, and inspect it once
+        it is complete.
+
+ @returns `true` if the state machine may continue to the next state, or
+          `false` if it must wait.
+ */
+static bool _noteAsyncResponse(void)
+{
+    if (_noteAsyncWaiting()) {
+        return false;
+    }
+
+    bool eop = false;
+    for (;;) {
+        // Grow the buffer just as the blocking transports do
+        if (asyncTxn.rspLen == asyncTxn.rspAllocLen) {
+            const char *err = _noteResponseBufGrow(&asyncTxn.rspBuf, asyncTxn.rspLen, &asyncTxn.rspAllocLen, 1, asyncTxn.api->rspSize);
+            if (err != NULL) {
+                _noteAsyncFinish(err);
+                return true;
+            }
+        }
+
+        uint32_t received = (asyncTxn.rspAllocLen - asyncTxn.rspLen);
+        const char *err = _noteAsyncReceive((asyncTxn.rspBuf + asyncTxn.rspLen), &received, &eop);
+        if (err != NULL) {
+            NOTE_C_LOG_ERROR(err);
+            _noteAsyncTransportError(err);
+            return true;
+        }
+        if (received > 0 && asyncTxn.rspLen == 0) {
+            // The Notecard only responds once it has read everything sent
+            _serialPacingReset();
+        }
+        asyncTxn.rspLen += received;
+        if (received > 0) {
+            asyncTxn.rxStartMs = _GetMs();
+        }
+        if (eop || received == 0) {
+            break;
+        }
+    }
+
+    if (!eop) {
+        // Once any of the response has arrived, the rest must follow promptly
+        const uint32_t timeoutMs = ((asyncTxn.rspLen > 0) ? (CARD_INTRA_TRANSACTION_TIMEOUT_SEC * 1000) : asyncTxn.timeoutMs);
+        if (timeoutMs && (_GetMs() - asyncTxn.rxStartMs) >= timeoutMs) {
+            if (asyncTxn.rspLen > 0) {
+                NOTE_C_LOG_ERROR(ERRSTR("received only partial reply before timeout", c_iobad));
+                _noteAsyncTransportError(ERRSTR("timeout: transaction incomplete {io}", c_iotimeout));
+            } else {
+                NOTE_C_LOG_DEBUG(ERRSTR("reply to request didn't arrive from module in time", c_iotimeout));
+                _noteAsyncTransportError(ERRSTR("transaction timeout {io}", c_iotimeout));
+            }
+            return true;
+        }
+
+        // Don't flood the I2C bus with queries while the Notecard is busy
+        if (NoteGetActiveInterface() == NOTE_C_INTERFACE_I2C) {
+            _noteAsyncWait(I2C_QUERY_DELAY_MS);
+        }
+        return false;
+    }
+
+    // Inspect the Notecard response
+    char *rspJsonStr = (char *)asyncTxn.rspBuf;
+    rspJsonStr[asyncTxn.rspLen] = '\0';
+    asyncTxn.rspBuf = NULL;
+    asyncTxn.rspLen = 0;
+    asyncTxn.rspAllocLen = 0;
+
+    const char *errStr = NULL;
+    const int rspStatus = _noteTransactionResponse(rspJsonStr, asyncTxn.crcAdded, asyncTxn.seqno, &asyncTxn.rsp, &errStr, &asyncTxn.isHeartbeat);
+    uint32_t delayMs = 0;
+    const int action = _noteResponseAction(rspStatus, &asyncTxn.retry, asyncTxn.api, asyncTxn.crcAdded, &delayMs);
+    if (action == RSP_ACTION_DONE) {
+        if (suppressShowTransactions == 0) {
+            NOTE_C_LOG_INFO(rspJsonStr);
+        }
+        _Free(rspJsonStr);
+        _noteAsyncFinish(NULL);
+        return true;
+    }
+
+    _Free(rspJsonStr);
+    JDelete(asyncTxn.rsp);
+    asyncTxn.rsp = NULL;
+    if (action == RSP_ACTION_RECEIVE) {
+        asyncTxn.state = TXN_STATE_TRANSMIT;
+    } else if (action == RSP_ACTION_RESEND) {
+        asyncTxn.state = TXN_STATE_RETRY;
+        _noteAsyncWait(delayMs);
+    } else {
+        _noteAsyncFinish(errStr);
+    }
+    return true;
+}
+
+bool NoteTransactionBegin(J *req)
+{
+    // Validate in case of memory failure of the requestor
+    if (req == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("NULL request", c_bad));
+        return false;
+    }
+    if (asyncTxn.state != TXN_STATE_IDLE) {
+        NOTE_C_LOG_ERROR(ERRSTR("a transaction is already in progress", c_bad));
+        return false;
+    }
+
+    // Determine the request or command type
+    const bool reqFound = JGetString(req, "req")[0];
+    const bool cmdFound = JGetString(req, "cmd")[0];
+    if (!reqFound && !cmdFound) {
+        NOTE_C_LOG_ERROR(ERRSTR("neither req nor cmd found in API invocation (invalid JSON)", c_bad));
+        return false;
+    } else if (reqFound && cmdFound) {
+        NOTE_C_LOG_ERROR(ERRSTR("both req and cmd present in API invocation (undefined behavior)", c_bad));
+        return false;
+    }
+
+    _noteAddUserAgent(req, reqFound);
+
+    // Serialize the JSON request up front, so the request is no longer needed
+    char *json = JPrintUnformatted(req);
+    if (json == NULL) {
+        NOTE_C_LOG_ERROR(ERRSTR("failed to serialize JSON request", c_mem));
+        return false;
+    }
+
+    memset(&asyncTxn, 0, sizeof(asyncTxn));
+    asyncTxn.state = TXN_STATE_COMPLETE;
+    asyncTxn.isCmd = cmdFound;
+    asyncTxn.id = JGetInt(req, "id");
+    asyncTxn.api = _noteApiLookup(JGetString(req, (reqFound ? c_req : c_cmd)));
+    asyncTxn.timeoutMs = _noteTransaction_calculateTimeoutMs(req, asyncTxn.api->flags);
+
+    // Ensure the Notecard is ready
+    if (!_TransactionStart(CARD_INTER_TRANSACTION_TIMEOUT_SEC * 1000)) {
+        _Free(json);
+        const char *errStr = ERRSTR("Notecard not ready (CTX/RTX) {io}", c_ioerr);
+        if (cmdFound) {
+            NOTE_C_LOG_ERROR(errStr);
+        } else {
+            asyncTxn.rsp = _errDoc(asyncTxn.id, errStr);
+        }
+        return true;
+    }
+
+    // Hold the Notecard lock until the transaction completes
+    _LockNote();
+    _Trace(NOTE_C_TRACE_TXN_START, _noteApiIndex(asyncTxn.api));
+
+#ifndef NOTE_C_LOW_MEM
+    // Add a CRC value, so the request may be retried if it is received in a
+    // corrupted state (see `_noteTransactionShouldLockAndStart`)
+    asyncTxn.seqno = seqNo;
     if (reqFound) {
-        char *newJson = _crcAdd(json, transactionSeqNo);
+        char *newJson = _crcAdd(json, asyncTxn.seqno);
         if (newJson != NULL) {
             _Free(json);
             json = newJson;
-            crcAddedToRequest = true;
+            asyncTxn.crcAdded = true;
         }
     }
 #endif // !NOTE_C_LOW_MEM
@@ -532,220 +3108,75 @@ J *_noteTransactionShouldLock(J *req, bool lockNotecard)
     if (resetRequired) {
         NOTE_C_LOG_DEBUG("Resetting Notecard I/O Interface...");
         if ((resetRequired = !_Reset())) {
-            if (lockNotecard) {
-                _UnlockNote();
-            }
+            _UnlockNote();
             _Free(json);
             _TransactionStop();
             const char *errStr = ERRSTR("failed to reset Notecard interface {io}", c_iobad);
             if (cmdFound) {
                 NOTE_C_LOG_ERROR(errStr);
-                return NULL;
-            }
-            return _errDoc(id, errStr);
-        }
-    }
-
-    // If we're performing retries, this is where we come back to
-    // after a failed transaction.
-    const char *errStr = NULL;
-    char *rspJsonStr = NULL;
-    J *rsp = NULL;
-    bool isHeartbeat = false;
-    for (uint8_t lastRequestRetries = 0; lastRequestRetries <= CARD_REQUEST_RETRIES_ALLOWED; ++lastRequestRetries) {
-        // free on retry
-        if (rsp != NULL) {
-            JDelete(rsp);
-        }
-
-        // reset variables
-        errStr = NULL;
-        rspJsonStr = NULL;
-        rsp = NULL;
-
-        // Trace request unless suppressed
-        if (!isHeartbeat && suppressShowTransactions == 0) {
-            NOTE_C_LOG_INFO(json);
-        }
-
-        // In-place replacement of NULL-terminator with a newline character.
-        // The Notecard expects a newline-terminated string to understand the
-        // end of the request.
-        const size_t jsonLen = strlen(json);
-        json[jsonLen] = '\n';
-
-        size_t jsonTxLen;
-        if (isHeartbeat) {
-            // Heartbeat responses have no request
-            jsonTxLen = 0;
-        } else {
-            jsonTxLen = (jsonLen + 1);
-        }
-
-        // Perform the transaction
-        if (cmdFound) {
-            errStr = _Transaction(json, jsonTxLen, NULL, transactionTimeoutMs);
-            // break;  // No response expected for commands and no ability to retry.
-        } else {
-            errStr = _Transaction(json, jsonTxLen, &rspJsonStr, transactionTimeoutMs);
-        }
-
-        // Restore NULL-terminator
-        json[jsonLen] = '\0';
-
-        ////////////////////////
-        // Request retry logic
-        ////////////////////////
-
-        // Handle transaction errors
-        if (errStr != NULL) {
-            _Free(rspJsonStr);
-            // If there's an I/O error on the transaction, retry
-            if (NoteErrorContains(errStr, c_ioerr)) {
-                NOTE_C_LOG_WARN(ERRSTR("retrying... transaction failure", c_iobad));
-                resetRequired = !_Reset();
-                _DelayMs(RETRY_DELAY_MS);
-                continue;  // I/O error, retry
             } else {
-                NOTE_C_LOG_DEBUG(ERRSTR("transaction failure", c_bad));
-                break;  // Fatal error, do not retry
+                asyncTxn.rsp = _errDoc(asyncTxn.id, errStr);
             }
-        } else if (cmdFound) {
-            NOTE_C_LOG_DEBUG("Command successfully sent to Notecard");
-            break;  // No response expected and no further ability to retry.
+            return true;
         }
+    }
 
-        // Inspect the Notecard Response
-        if (rspJsonStr == NULL) {
-            // If the response is NULL, then we have a timeout or other error
-            errStr = ERRSTR("response expected, but response is NULL {io}", c_ioerr);
-            NOTE_C_LOG_WARN(ERRSTR("retrying... no response", c_iobad));
-            _DelayMs(RETRY_DELAY_MS);
-            continue;  // I/O error, retry
-        }
-
-#ifndef NOTE_C_LOW_MEM
-        // If we sent a CRC in the request, examine the response JSON to see if
-        // it has a CRC error.  Note that the CRC is stripped from the
-        // rspJsonStr as a side-effect of this method.
-        if (crcAddedToRequest && _crcError(rspJsonStr, transactionSeqNo)) {
-            _Free(rspJsonStr);
-            errStr = ERRSTR("CRC error {io}", c_iobad);
-            NOTE_C_LOG_WARN(ERRSTR("retrying... CRC error", c_iobad));
-            _DelayMs(RETRY_DELAY_MS);
-            continue;
-        }
-#endif // !NOTE_C_LOW_MEM
-
-        // Error types
-        bool isBadBin = false;
-        bool isIoError = false;
-        isHeartbeat = false;
-
-        // Error detection / classification
-        rsp = JParse(rspJsonStr);
-        if (rsp != NULL) {
-            isBadBin = JContainsString(rsp, c_err, c_badbinerr);
-            isIoError = JContainsString(rsp, c_err, c_ioerr) && !JContainsString(rsp, c_err, c_unsupported);
-            isHeartbeat = JContainsString(rsp, c_err, c_heartbeat);
-        } else {
-            // Failed to parse response as JSON
-            isIoError = true;
-#ifndef NOTE_C_LOW_MEM
-            _DebugWithLevel(NOTE_C_LOG_LEVEL_ERROR, "[ERROR] ");
-            _DebugWithLevel(NOTE_C_LOG_LEVEL_ERROR, "invalid JSON {io}: ");
-            _DebugWithLevel(NOTE_C_LOG_LEVEL_ERROR, rspJsonStr);
-#else
-            NOTE_C_LOG_ERROR(c_ioerr);
-#endif // !NOTE_C_LOW_MEM
-        }
+    asyncTxn.json = json;
+    asyncTxn.jsonLen = strlen(json);
+    _noteRetryStart(&asyncTxn.retry);
+    asyncTxn.state = TXN_STATE_TRANSMIT;
+    return true;
+}
 
-        // Error handling
-        if (isHeartbeat) {
-            // Heartbeat responses are not traditional errors, log and resume waiting
-            _Free(rspJsonStr);
-            const char * const status = JGetString(rsp, c_status);
-            NOTE_C_LOG_DEBUG(ERRSTR(status, c_heartbeat));
-#ifdef NOTE_C_HEARTBEAT_CALLBACK
-            if (_noteHeartbeat(status)) {
-                errStr = ERRSTR("host abandoned transaction {heartbeat}", c_heartbeat);
-                NoteResetRequired();
-                break;
+int NoteTransactionPoll(void)
+{
+    for (;;) {
+        switch (asyncTxn.state) {
+        case TXN_STATE_TRANSMIT:
+            if (!_noteAsyncTransmit()) {
+                return NOTE_C_TXN_IN_PROGRESS;
             }
-#else
-            (void)status; // avoid unused variable warning when NOTE_C_LOW_MEM defined
-#endif
-            --lastRequestRetries; // Heartbeats do not count against retry limit
-            continue;
-        } else if (isIoError || isBadBin) {
-            if (rsp != NULL) {
-                NOTE_C_LOG_ERROR(JGetString(rsp, c_err));
+            break;
+        case TXN_STATE_RECEIVE:
+            if (!_noteAsyncResponse()) {
+                return NOTE_C_TXN_IN_PROGRESS;
             }
-            if (isBadBin) {
-                NOTE_C_LOG_DEBUG("{bad-bin} errors not eligible for retry");
-                break;
-            } else {
-                _Free(rspJsonStr);
-                errStr = ERRSTR("corrupt response {io}", c_ioerr);
-                NOTE_C_LOG_WARN(ERRSTR("retrying... corrupt response", c_iobad));
-                _DelayMs(RETRY_DELAY_MS);
-                continue;
+            break;
+        case TXN_STATE_RETRY:
+            if (_noteAsyncWaiting()) {
+                return NOTE_C_TXN_IN_PROGRESS;
             }
+            asyncTxn.state = TXN_STATE_TRANSMIT;
+            asyncTxn.jsonSent = 0;
+            break;
+        case TXN_STATE_COMPLETE:
+            return NOTE_C_TXN_COMPLETE;
+        default:
+            return NOTE_C_TXN_IDLE;
         }
-
-        // Transaction completed
-        break;
-    } // end of retry loop
-
-    // Free the original serialized JSON request
-    _Free(json);
-
-#ifndef NOTE_C_LOW_MEM
-    // Request processing complete, regardless of success or error.
-    // Now, advance the request sequence number.
-    seqNo++;
-#endif // !NOTE_C_LOW_MEM
-
-    // Return an empty object (with no err field) when no response is expected
-    if (cmdFound) {
-        if (lockNotecard) {
-            _UnlockNote();
-        }
-        _TransactionStop();
-        return JCreateObject();
-    }
-
-    // Handle error condition
-    if (errStr != NULL) {
-        if (rsp != NULL) {
-            JDelete(rsp);
-            rsp = NULL;
-        }
-        NoteResetRequired(); // queue up a reset
-        J *errRsp = _errDoc(id, errStr);
-        if (lockNotecard) {
-            _UnlockNote();
-        }
-        _TransactionStop();
-        return errRsp;
     }
+}
 
-    // Log and discard the response JSON
-    if (suppressShowTransactions == 0) {
-        NOTE_C_LOG_INFO(rspJsonStr);
+J *NoteTransactionEnd(void)
+{
+    if (asyncTxn.state == TXN_STATE_IDLE) {
+        return NULL;
     }
-    _Free(rspJsonStr);
 
-    // Release the Notecard lock
-    if (lockNotecard) {
-        _UnlockNote();
+    // Abandon a transaction that is still in flight. The Notecard may yet
+    // respond, so resynchronize with it before the next transaction.
+    if (asyncTxn.state != TXN_STATE_COMPLETE) {
+        _noteAsyncFinish(ERRSTR("transaction abandoned by host {io}", c_ioerr));
+        NoteResetRequired();
+        if (asyncTxn.isCmd) {
+            // The command may not have been sent in full
+            JDelete(asyncTxn.rsp);
+            asyncTxn.rsp = NULL;
+        }
     }
 
-    // Inform the Notecard that the transaction is complete.
-    // This allows the Notecard (ESP) to drop into low power mode.
-    _TransactionStop();
-
-    // Done
+    J *rsp = asyncTxn.rsp;
+    memset(&asyncTxn, 0, sizeof(asyncTxn));
     return rsp;
 }
 
@@ -771,6 +3202,87 @@ bool NoteReset(void)
     return !resetRequired;
 }
 
+/*!
+ @internal
+
+ @brief Prepare to resynchronize with the Notecard.
+
+ Builds the bytes to send: a newline, which terminates any partial request or
+ binary payload the Notecard was receiving, followed by an `echo` request
+ carrying a fresh nonce. The nonce never repeats its first letter, so it can be
+ matched one byte at a time without backtracking.
+
+ @param sync The resynchronization state to initialize.
+ */
+void _noteResetSyncBegin(_noteResetSync *sync)
+{
+    static const char prefix[] = "\n{\"req\":\"echo\",\"text\":\"";
+    static const char suffix[] = "\"}\n";
+
+    // Successive attempts in the same millisecond must not share a nonce, or
+    // the answer to an earlier attempt could be taken for the latest one
+    static uint32_t attempts = 0;
+    uint32_t x = ((_GetMs() ^ (++attempts * 0x9E3779B9u)) | 1u);
+    for (size_t i = 0 ; i < NOTE_C_RESET_NONCE_LEN ; ++i) {
+        do {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            sync->nonce[i] = (char)('A' + (x % 26));
+        } while (i > 0 && sync->nonce[i] == sync->nonce[0]);
+    }
+
+    uint8_t *p = sync->request;
+    memcpy(p, prefix, sizeof(prefix) - 1);
+    p += (sizeof(prefix) - 1);
+    memcpy(p, sync->nonce, NOTE_C_RESET_NONCE_LEN);
+    p += NOTE_C_RESET_NONCE_LEN;
+    memcpy(p, suffix, sizeof(suffix) - 1);
+    p += (sizeof(suffix) - 1);
+    sync->requestLen = (uint32_t)(p - sync->request);
+    sync->matched = 0;
+    sync->dataLen = 0;
+}
+
+/*!
+ @internal
+
+ @brief Scan bytes received from the Notecard while resynchronizing.
+
+ @param sync The resynchronization state.
+ @param data The bytes received.
+ @param len The number of bytes received.
+
+ @returns `true` once the line echoing the nonce has been received in full, in
+          which case the Notecard is in sync and nothing it sent remains to be
+          read. Any bytes following that line are not scanned.
+ */
+bool _noteResetSyncScan(_noteResetSync *sync, const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0 ; i < len ; ++i) {
+        const char ch = (char)data[i];
+        if (ch == '\n' || ch == '\r') {
+            if (ch == '\n' && sync->matched == NOTE_C_RESET_NONCE_LEN) {
+                return true;
+            }
+            if (sync->matched < NOTE_C_RESET_NONCE_LEN) {
+                sync->matched = 0;
+            }
+            continue;
+        }
+        sync->dataLen++;
+        if (sync->matched == NOTE_C_RESET_NONCE_LEN) {
+            continue;
+        }
+        if (ch == sync->nonce[sync->matched]) {
+            sync->matched++;
+        } else {
+            sync->matched = (ch == sync->nonce[0]);
+        }
+    }
+    return false;
+}
+
 /*!
  @internal
 
@@ -838,38 +3350,53 @@ static void _notePingDrainInput(void)
     }
 }
 
-bool NotePing(void)
-{
-    // Short, fixed timeout. Long enough for a round-trip `echo` at 9600 baud
-    // with comfortable Notecard-side processing headroom; short enough that
-    // an autobaud scan across many rates completes quickly.
-    const uint32_t pingTimeoutMs = 500;
+/*!
+ @internal
 
-    // Generate a 16-character random nonce using xorshift32 seeded from the
-    // current millisecond clock. No file- or function-scope static state, so
-    // if this function is never called the linker can drop it all.
-    char nonce[17];
+ @brief Send the Notecard an `echo` request carrying random text, and verify
+        that the text comes back.
+
+ Performs no retries and does not trigger a Notecard reset on failure, so that
+ callers probing the connection (autobaud, I2C calibration) can move on to
+ their next candidate setting at once.
+
+ @param textLen The length of the text to echo.
+ @param timeoutMs The time to wait for the response, in milliseconds.
+
+ @returns `true` if the Notecard echoed the text, `false` otherwise.
+ */
+bool _noteEcho(size_t textLen, uint32_t timeoutMs)
+{
+    // Generate random text using xorshift32 seeded from the current
+    // millisecond clock. No file- or function-scope static state, so if this
+    // function is never called the linker can drop it all.
+    char *text = (char *)_Malloc(textLen + 1);
+    if (text == NULL) {
+        return false;
+    }
     uint32_t x = _GetMs() | 1u;   // avoid the all-zero xorshift fixed point
-    for (int i = 0; i < 16; i++) {
+    for (size_t i = 0; i < textLen; i++) {
         x ^= x << 13;
         x ^= x >> 17;
         x ^= x << 5;
-        nonce[i] = (char)('A' + (x % 26));
+        text[i] = (char)('A' + (x % 26));
     }
-    nonce[16] = '\0';
+    text[textLen] = '\0';
 
     // Build the request with note-c's own J* primitives (cleaner than
     // hand-assembling the JSON, and avoids pulling in snprintf which is
     // not on the libc whitelist).
     J *req = JCreateObject();
     if (req == NULL) {
+        _Free(text);
         return false;
     }
     JAddStringToObject(req, c_req, "echo");
-    JAddStringToObject(req, "text", nonce);
+    JAddStringToObject(req, "text", text);
     char *json = JPrintUnformatted(req);
     JDelete(req);
     if (json == NULL) {
+        _Free(text);
         return false;
     }
 
@@ -885,8 +3412,9 @@ bool NotePing(void)
     // expected during an autobaud scan.
     _noteSuspendTransactionDebug();
 
-    if (!_TransactionStart(pingTimeoutMs)) {
+    if (!_TransactionStart(timeoutMs)) {
         _Free(json);
+        _Free(text);
         _noteResumeTransactionDebug();
         return false;
     }
@@ -903,7 +3431,7 @@ bool NotePing(void)
     // Deliberately do NOT add a CRC: CRCs exist to enable retries, and we
     // are doing exactly one attempt.
     char *rspJson = NULL;
-    const char *err = _Transaction(json, jsonLen + 1, &rspJson, pingTimeoutMs);
+    const char *err = _Transaction(json, jsonLen + 1, &rspJson, timeoutMs);
     json[jsonLen] = '\0';
 
     _UnlockNote();
@@ -917,26 +3445,40 @@ bool NotePing(void)
     // paying a reset penalty on the next attempt.
     if (err != NULL || rspJson == NULL) {
         _Free(rspJson);
+        _Free(text);
         return false;
     }
 
     // Parse and verify. The response must be valid JSON, must not carry
     // an "err" field, and must contain a "text" field whose value is an
-    // exact match for the nonce we sent. Any other fields in the response
+    // exact match for the text we sent. Any other fields in the response
     // (e.g. "cmd":"echo") are ignored.
     J *rsp = JParse(rspJson);
     _Free(rspJson);
     if (rsp == NULL) {
+        _Free(text);
         return false;
     }
 
     bool ok = JIsNullString(rsp, c_err)
-              && JIsExactString(rsp, "text", nonce);
+              && JIsExactString(rsp, "text", text);
 
     JDelete(rsp);
+    _Free(text);
     return ok;
 }
 
+bool NotePing(void)
+{
+    // Short, fixed timeout. Long enough for a round-trip `echo` at 9600 baud
+    // with comfortable Notecard-side processing headroom; short enough that
+    // an autobaud scan across many rates completes quickly.
+    const uint32_t pingTimeoutMs = 500;
+
+    // A 16-character random nonce
+    return _noteEcho(16, pingTimeoutMs);
+}
+
 bool NoteErrorContains(const char *errstr, const char *errtype)
 {
     return (strstr(errstr, errtype) != NULL);
@@ -999,17 +3541,11 @@ uint64_t _n_atoh(char *p, int maxLen)
     return (n);
 }
 
-static uint32_t lut[16] = {
-    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
-    0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
-    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
-};
-
 /*!
  @brief Compute the CRC32 of the passed in buffer.
 
- Small lookup-table half-byte CRC32 algorithm. See
- https://create.stephan-brumme.com/crc32/#half-byte
+ The CRC32 is computed by the platform hook, if one has been set with
+ `NoteSetFnCRC32`, or by the built-in tables otherwise.
 
  @param data The buffer.
  @param length The length of the buffer.
@@ -1018,17 +3554,21 @@ static uint32_t lut[16] = {
  */
 NOTE_C_STATIC int32_t _crc32(const void* data, size_t length)
 {
-    uint32_t previousCrc32 = 0;
-    uint32_t crc = ~previousCrc32;
-    unsigned char* current = (unsigned char*) data;
+    return (int32_t)_crc32Update(0, data, length);
+}
 
-    while (length--) {
-        crc = lut[(crc ^  *current      ) & 0x0F] ^ (crc >> 4);
-        crc = lut[(crc ^ (*current >> 4)) & 0x0F] ^ (crc >> 4);
-        current++;
-    }
+/*!
+ @brief Continue the CRC32 of a buffer that is processed in pieces.
+
+ @param crc The CRC32 of the preceding pieces, or 0 for the first piece.
+ @param data The next piece of the buffer.
+ @param length The length of the piece.
 
-    return ~crc;
+ @returns The CRC32 of the buffer up to and including this piece.
+ */
+NOTE_C_STATIC uint32_t _crc32Update(uint32_t crc, const void* data, size_t length)
+{
+    return _Crc32(crc, (const uint8_t *)data, length);
 }
 
 /*!
@@ -1067,28 +3607,82 @@ NOTE_C_STATIC char *_crcAdd(char *json, uint16_t seqno)
         return NULL;
     }
 
-    bool isEmptyObject = (memchr(json, ':', jsonLen) == NULL);
+    memcpy(newJson, json, jsonLen+1);
+    _crcAppend(newJson, jsonLen, jsonLen+CRC_FIELD_LENGTH+1, seqno);
+
+    return newJson;
+}
+
+/*!
+ @brief Append a "crc" field to the passed in JSON buffer, in place.
+
+ This is the non-allocating counterpart of `_crcAdd`, used when the caller owns
+ a buffer large enough to hold the request plus `CRC_FIELD_LENGTH` bytes.
+
+ @param json The null-terminated JSON to add the CRC32 to and to compute the
+        CRC32 over.
+ @param jsonLen The length of the JSON, excluding the null-terminator.
+ @param bufLen The total size of the buffer holding the JSON.
+ @param seqno A 16-bit sequence number to include as a part of the CRC.
+
+ @returns The new length of the JSON or 0 if the field could not be added, in
+          which case the buffer is left untouched.
+ */
+NOTE_C_STATIC size_t _crcAppend(char *json, size_t jsonLen, size_t bufLen, uint16_t seqno)
+{
+    // Minimum JSON is "{}" and must end with a closing "}".
+    if (jsonLen < 2 || json[jsonLen-1] != '}') {
+        return 0;
+    }
+
+    // The CRC covers the JSON as it was before the field was added
+    return _crcAppendField(json, jsonLen, bufLen, seqno, (uint32_t)_crc32(json, jsonLen), (memchr(json, ':', jsonLen) == NULL));
+}
+
+/*!
+ @brief Append a "crc" field with a precomputed CRC32 to the passed in JSON
+        buffer, in place.
+
+ The buffer may hold only the final part of the JSON, as when a request is
+ streamed to the Notecard, in which case the CRC32 and whether the object has
+ any fields must cover all of the JSON.
+
+ @param json The null-terminated JSON, ending with a closing "}".
+ @param jsonLen The length of the JSON, excluding the null-terminator.
+ @param bufLen The total size of the buffer holding the JSON.
+ @param seqno A 16-bit sequence number to include as a part of the CRC.
+ @param crc The CRC32 of the JSON.
+ @param isEmptyObject `true` if the JSON object has no fields.
+
+ @returns The new length of the JSON or 0 if the field could not be added, in
+          which case the buffer is left untouched.
+ */
+NOTE_C_STATIC size_t _crcAppendField(char *json, size_t jsonLen, size_t bufLen, uint16_t seqno, uint32_t crc, bool isEmptyObject)
+{
+    if (jsonLen < 1 || json[jsonLen-1] != '}' || (jsonLen+CRC_FIELD_LENGTH+1) > bufLen) {
+        return 0;
+    }
+
     size_t newJsonLen = jsonLen-1;
 
-    memcpy(newJson, json, newJsonLen);
-    newJson[newJsonLen++] = (isEmptyObject ? ' ' : ',');    // Replace }
-    newJson[newJsonLen++] = '"';                            // +1
-    newJson[newJsonLen++] = 'c';                            // +2
-    newJson[newJsonLen++] = 'r';                            // +3
-    newJson[newJsonLen++] = 'c';                            // +4
-    newJson[newJsonLen++] = '"';                            // +5
-    newJson[newJsonLen++] = ':';                            // +6
-    newJson[newJsonLen++] = '"';                            // +7
-    _n_htoa16(seqno, (uint8_t *) &newJson[newJsonLen]);
+    json[newJsonLen++] = (isEmptyObject ? ' ' : ',');       // Replace }
+    json[newJsonLen++] = '"';                               // +1
+    json[newJsonLen++] = 'c';                               // +2
+    json[newJsonLen++] = 'r';                               // +3
+    json[newJsonLen++] = 'c';                               // +4
+    json[newJsonLen++] = '"';                               // +5
+    json[newJsonLen++] = ':';                               // +6
+    json[newJsonLen++] = '"';                               // +7
+    _n_htoa16(seqno, (uint8_t *) &json[newJsonLen]);
     newJsonLen += 4;                                        // +11
-    newJson[newJsonLen++] = ':';                            // +12
-    _n_htoa32(_crc32(json, jsonLen), &newJson[newJsonLen]);
+    json[newJsonLen++] = ':';                               // +12
+    _n_htoa32(crc, &json[newJsonLen]);
     newJsonLen += 8;                                        // +20
-    newJson[newJsonLen++] = '"';                            // +21
-    newJson[newJsonLen++] = '}';                            // +22 == CRC_FIELD_LENGTH
-    newJson[newJsonLen] = '\0';                             // null-terminated as it came in
+    json[newJsonLen++] = '"';                               // +21
+    json[newJsonLen++] = '}';                               // +22 == CRC_FIELD_LENGTH
+    json[newJsonLen] = '\0';                                // null-terminated as it came in
 
-    return newJson;
+    return newJsonLen;
 }
 
 /*!
@@ -1162,7 +3756,9 @@ NOTE_C_STATIC bool _crcError(char *json, uint16_t shouldBeSeqno)
     json[crcOffset] = '\0';
     uint32_t shouldBeCrc32 = _crc32(json, crcOffset);
 
-    return (shouldBeSeqno != actualSeqno || shouldBeCrc32 != actualCrc32);
+    const bool crcError = (shouldBeSeqno != actualSeqno || shouldBeCrc32 != actualCrc32);
+    _Trace(NOTE_C_TRACE_CRC_CHECK, crcError);
+    return crcError;
 }
 
 #endif // !NOTE_C_LOW_MEM
@@ -16,6 +16,169 @@
 
 #include "n_lib.h"
 
+// The default pacing sends a segment of CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN
+// bytes every CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS, which every Notecard keeps
+// up with at any baud rate
+#define SERIAL_PACING_DEFAULT { \
+    0, \
+    ((CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN * 1000) / CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS), \
+    CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN, \
+    false \
+}
+
+static const NoteSerialPacing defaultSerialPacing = SERIAL_PACING_DEFAULT;
+static NoteSerialPacing serialPacing = SERIAL_PACING_DEFAULT;
+
+// The pacer models the Notecard's receive buffer: every byte sent adds to it,
+// and it drains at the configured rate. A segment is only sent once there is
+// room for it, so the host waits no longer than the Notecard needs.
+static uint32_t pacingFill = 0;
+static uint32_t pacingMs = 0;
+
+/*!
+ @internal
+
+ @brief Drain the model of the Notecard's receive buffer by the time elapsed
+        since it was last updated.
+ */
+static void _serialPacingDrain(void)
+{
+    const uint32_t nowMs = _GetMs();
+    const uint32_t drained = (uint32_t)(((uint64_t)(nowMs - pacingMs) * serialPacing.drainBytesPerSec) / 1000);
+    if (drained == 0 && pacingFill != 0) {
+        // Keep accumulating time until at least a byte has drained
+        return;
+    }
+    pacingFill = ((pacingFill > drained) ? (pacingFill - drained) : 0);
+    pacingMs = nowMs;
+}
+
+/*!
+ @internal
+
+ @brief Determine whether the serial port needs pacing at all.
+
+ @returns `true` if the host must pause for the Notecard to keep up.
+ */
+static bool _serialPacingRequired(void)
+{
+    if (serialPacing.flowControl) {
+        return false;
+    }
+
+    // A port that is slower than the Notecard's drain rate paces itself
+    return !(serialPacing.baudRate && (serialPacing.baudRate / 10) <= serialPacing.drainBytesPerSec);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Get the time to wait before bytes may be sent to the Notecard
+  without overrunning its receive buffer.
+
+  @param   len The number of bytes to send.
+
+  @returns The time to wait, in milliseconds.
+*/
+/**************************************************************************/
+uint32_t _serialPacingDelayMs(uint32_t len)
+{
+    if (!_serialPacingRequired()) {
+        return 0;
+    }
+    _serialPacingDrain();
+    if ((pacingFill + len) <= serialPacing.bufferLen) {
+        return 0;
+    }
+    const uint32_t excess = ((pacingFill + len) - serialPacing.bufferLen);
+    return (uint32_t)((((uint64_t)excess * 1000) + serialPacing.drainBytesPerSec - 1) / serialPacing.drainBytesPerSec);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Wait until bytes may be sent to the Notecard without overrunning its
+  receive buffer.
+
+  @param   len The number of bytes to send.
+*/
+/**************************************************************************/
+static void _serialPacingWait(uint32_t len)
+{
+    const uint32_t waitMs = _serialPacingDelayMs(len);
+    if (waitMs == 0) {
+        return;
+    }
+    _DelayMs(waitMs);
+
+    // Assume the Notecard drained no more than was needed, leaving exactly
+    // enough room for these bytes
+    pacingFill = ((len < serialPacing.bufferLen) ? (serialPacing.bufferLen - len) : 0);
+    pacingMs = _GetMs();
+}
+
+/**************************************************************************/
+/*!
+  @brief  Get the largest number of bytes to send to the Notecard at once.
+
+  @returns The segment length, in bytes.
+*/
+/**************************************************************************/
+uint32_t _serialPacingSegmentLen(void)
+{
+    return serialPacing.bufferLen;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Account for bytes sent to the Notecard.
+
+  @param   len The number of bytes sent.
+*/
+/**************************************************************************/
+void _serialPacingSent(uint32_t len)
+{
+    _serialPacingDrain();
+    pacingFill += len;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Note that the Notecard has consumed everything sent to it, as it
+  does before it responds to a request or after a reset.
+*/
+/**************************************************************************/
+void _serialPacingReset(void)
+{
+    pacingFill = 0;
+    pacingMs = _GetMs();
+}
+
+void NoteSetSerialPacing(const NoteSerialPacing *pacing)
+{
+    _LockNote();
+    serialPacing = ((pacing != NULL) ? *pacing : defaultSerialPacing);
+
+    // Normalize the pacing, so that every segment fits and eventually drains
+    if (serialPacing.bufferLen == 0) {
+        serialPacing.bufferLen = defaultSerialPacing.bufferLen;
+    }
+    if (serialPacing.drainBytesPerSec == 0) {
+        // The Notecard drains its buffer no faster than the default rate
+        // merely because the port is fast
+        serialPacing.drainBytesPerSec = defaultSerialPacing.drainBytesPerSec;
+    }
+    _serialPacingReset();
+    _UnlockNote();
+}
+
+void NoteGetSerialPacing(NoteSerialPacing *pacing)
+{
+    if (pacing != NULL) {
+        _LockNote();
+        *pacing = serialPacing;
+        _UnlockNote();
+    }
+}
+
 /**************************************************************************/
 /*!
   @brief  Given a JSON string, perform a serial transaction with the Notecard.
@@ -45,17 +208,12 @@ const char *_serialNoteTransaction(const char *request, size_t reqLen, char **re
             reqLen--; // remove carriage return if it exists
         }
 
-        err = _serialChunkedTransmit((const uint8_t *)request, reqLen, true);
+        // Append the carriage return and newline to the transaction
+        err = _serialChunkedTransmitLine((const uint8_t *)request, reqLen, true);
         if (err) {
             NOTE_C_LOG_ERROR(err);
             return err;
         }
-
-        // Append the carriage return and newline to the transaction.
-        // Stack buffer used to avoid passing flash-resident data through the
-        // non-const hook. TODO: Remove when serialTransmitFn accepts const uint8_t *.
-        uint8_t newline[] = {'\r', '\n'};
-        _SerialTransmit(newline, c_newline_len, true);
     }
 
     // If no reply expected, we're done
@@ -76,16 +234,16 @@ const char *_serialNoteTransaction(const char *request, size_t reqLen, char **re
             _DelayMs(10);
         }
     }
+    _Trace(NOTE_C_TRACE_FIRST_RX, 0);
 
-    // Allocate a buffer for input, noting that we always put the +1 in the
-    // alloc so we can be assured that it can be null-terminated. This must be
-    // the case because json parsing requires a null-terminated string.
+    // Allocate a buffer for input, large enough for the typical response to
+    // the API, and always with space for the NULL-terminator the JSON parser
+    // requires.
     uint32_t available = 0;
-    uint32_t jsonbufAllocLen = ALLOC_CHUNK;
-    uint8_t *jsonbuf = (uint8_t *)_Malloc(jsonbufAllocLen + 1);
-    if (jsonbuf == NULL) {
-        err = ERRSTR("transaction: jsonbuf malloc failed", c_mem);
-        NOTE_C_LOG_ERROR(err);
+    uint32_t jsonbufAllocLen = 0;
+    uint8_t *jsonbuf = NULL;
+    err = _noteResponseBufGrow(&jsonbuf, 0, &jsonbufAllocLen, 1, cardResponseSizeHint);
+    if (err) {
         return err;
     }
 
@@ -106,29 +264,13 @@ const char *_serialNoteTransaction(const char *request, size_t reqLen, char **re
         jsonbufLen += jsonbufAvailLen;
         jsonbuf[jsonbufLen] = '\0';
 
+        // When more bytes are available than we have buffer to accommodate
+        // (i.e. overflow), then grow the buffer
         if (available) {
-            // When more bytes are available than we have buffer to accommodate
-            // (i.e. overflow), then we allocate blocks of size `ALLOC_CHUNK` to
-            // reduce heap fragmentation.
-            // NOTE: We always put the +1 in the allocation so we can be assured
-            // that it can be null-terminated, because the json parser requires
-            // a null-terminated string.
-            jsonbufAllocLen += (ALLOC_CHUNK * ((available / ALLOC_CHUNK) + ((available % ALLOC_CHUNK) > 0)));
-            uint8_t *jsonbufNew = (uint8_t *)_Malloc(jsonbufAllocLen + 1);
-            if (jsonbufNew == NULL) {
-                err = ERRSTR("transaction: jsonbuf grow malloc failed", c_mem);
-                NOTE_C_LOG_ERROR(err);
-                if (jsonbuf) {
-                    _Free(jsonbuf);
-                }
+            err = _noteResponseBufGrow(&jsonbuf, jsonbufLen, &jsonbufAllocLen, available, 0);
+            if (err) {
                 return err;
             }
-            if (jsonbuf) {
-                memcpy(jsonbufNew, jsonbuf, jsonbufLen);
-                _Free(jsonbuf);
-            }
-            jsonbuf = jsonbufNew;
-            NOTE_C_LOG_DEBUG("additional receive buffer chunk allocated");
         }
     } while (available);
 
@@ -154,66 +296,76 @@ bool _serialNoteReset(void)
 {
     NOTE_C_LOG_DEBUG("resetting Serial interface...");
 
-    // Reset the Serial subsystem and exit if failure
-    _DelayMs(CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS);
-    if (!_SerialReset()) {
-        NOTE_C_LOG_ERROR(ERRSTR("unable to reset Serial interface.", c_err));
-        return false;
-    }
-
-    // The guaranteed behavior for robust resyncing is to send two newlines
-    // and  wait for two echoed blank lines in return.
+    // Rather than draining for a fixed window, send a newline followed by an
+    // `echo` request carrying a nonce, and stop as soon as the Notecard echoes
+    // the nonce back. Each round waits at most CARD_RESET_DRAIN_MS for the
+    // echo, and gives up sooner once unrecognized data has been followed by
+    // CARD_RESET_QUIET_MS of silence.
+    // NOTE: The newline is a bare `\n` rather than `\r\n`, because it is the
+    //       one terminator every Notecard firmware version answers on its
+    //       serial port.
     bool notecardReady = false;
+    uint32_t backoffMs = CARD_RESET_BACKOFF_MS;
     for (size_t retries = 0; retries < CARD_RESET_SYNC_RETRIES ; ++retries) {
 
-        // Send a newline to the module to clean out request/response processing
-        // NOTE: This MUST always be `\n` and not `\r\n`, because there are some
-        //       versions of the Notecard firmware will not respond to `\r\n`
-        //       after communicating over I2C.
-        // Stack buffer used to avoid passing flash-resident data through the
-        // non-const hook. TODO: Remove when serialTransmitFn accepts const uint8_t *.
-        uint8_t lf[] = {'\n'};
-        _SerialTransmit(lf, 1, true);
+        // Pause between rounds, so that an unresponsive Notecard is not
+        // hammered with resets, then reset the Serial subsystem and exit if
+        // failure
+        _DelayMs(backoffMs);
+        backoffMs = ((backoffMs * 2) < CARD_RESET_DRAIN_MS) ? (backoffMs * 2) : CARD_RESET_DRAIN_MS;
+        if (!_SerialReset()) {
+            NOTE_C_LOG_ERROR(ERRSTR("unable to reset Serial interface.", c_err));
+            return false;
+        }
+        if (retries > 0) {
+            NOTE_C_LOG_DEBUG("retrying Serial interface reset.");
+        }
 
-        // Drain all communications for 500ms
-        bool somethingFound = false;
-        bool nonControlCharFound = false;
+        _noteResetSync sync;
+        _noteResetSyncBegin(&sync);
+        _serialPacingWait(sync.requestLen);
+        _SerialTransmit(sync.request, sync.requestLen, true);
+        _serialPacingSent(sync.requestLen);
 
-        // Read Serial data for at least CARD_RESET_DRAIN_MS continously
-        for (uint32_t startMs = _GetMs() ; (_GetMs() - startMs) < CARD_RESET_DRAIN_MS ;) {
-            // Determine if Serial data is available
-            while (_SerialAvailable()) {
+        bool somethingFound = false;
+        const uint32_t startMs = _GetMs();
+        uint32_t dataMs = startMs;
+        for (;;) {
+            const bool available = _SerialAvailable();
+            if (available) {
                 somethingFound = true;
-                // The Notecard responds to a bare `\n` with `\r\n`. If we get
-                // any other characters back, it means the host and Notecard
-                // aren't synced up yet and we need to transmit `\n` again.
-                char ch = _SerialReceive();
-                if (ch != '\n' && ch != '\r') {
-                    nonControlCharFound = true;
-                    // Reset the timer with each non-control character
-                    startMs = _GetMs();
+                const uint8_t ch = (uint8_t)_SerialReceive();
+                const uint32_t dataLen = sync.dataLen;
+                if (_noteResetSyncScan(&sync, &ch, 1)) {
+                    notecardReady = true;
+                    break;
+                }
+                if (sync.dataLen != dataLen) {
+                    dataMs = _GetMs();
                 }
             }
-            _DelayMs(1);
+            const uint32_t nowMs = _GetMs();
+            if ((nowMs - startMs) >= CARD_RESET_DRAIN_MS) {
+                break;
+            }
+            if (sync.dataLen && (nowMs - dataMs) >= CARD_RESET_QUIET_MS) {
+                break;
+            }
+            if (!available) {
+                _DelayMs(1);
+            }
         }
 
-        // If all we got back is newlines, we're ready
-        if (somethingFound && !nonControlCharFound) {
-            notecardReady = true;
+        if (notecardReady) {
             break;
         }
 
         NOTE_C_LOG_ERROR(somethingFound ? ERRSTR("unrecognized data from notecard", c_iobad) : ERRSTR("notecard not responding", c_iobad));
-
-        _DelayMs(CARD_RESET_DRAIN_MS);
-        if (!_SerialReset()) {
-            NOTE_C_LOG_ERROR(ERRSTR("unable to reset Serial interface.", c_err));
-            return false;
-        }
-
-        NOTE_C_LOG_DEBUG("retrying Serial interface reset.");
     }
 
+    // Whatever was sent before the reset has been discarded
+    _serialPacingReset();
+
     // Done
     return notecardReady;
 }
@@ -243,6 +395,7 @@ const char *_serialChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, u
         while (!_SerialAvailable()) {
             if (timeoutMs && (_GetMs() - startMs >= timeoutMs)) {
                 *size = received;
+                _StatsAdd(bytesReceived, received);
                 if (received) {
                     NOTE_C_LOG_ERROR(ERRSTR("received only partial reply before timeout", c_iobad));
                 }
@@ -258,15 +411,13 @@ const char *_serialChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, u
         // Once we've received any character, we will no longer wait patiently
         timeoutMs = (CARD_INTRA_TRANSACTION_TIMEOUT_SEC * 1000);
         startMs = _GetMs();
+        if (received == 0) {
+            // The Notecard only responds once it has read everything sent
+            _serialPacingReset();
+        }
 
-        // Receive the next character
-        char ch = _SerialReceive();
-
-        // Place into the buffer
-        buffer[received++] = ch;
-
-        // Look for end-of-packet marker
-        eop = (ch == '\n');
+        // Receive what is available, up to the end-of-packet marker
+        received += _SerialReceiveLine(&buffer[received], (*size - received), &eop);
 
         // Check overflow condition
         overflow = ((received >= *size) && !eop);
@@ -286,50 +437,110 @@ const char *_serialChunkedReceive(uint8_t *buffer, uint32_t *size, bool delay, u
 
     // Return it
     *size = received;
+    _StatsAdd(bytesReceived, received);
     return NULL;
 }
 
 /**************************************************************************/
 /*!
-  @brief  Transmit bytes over serial to the Notecard.
+  @brief  Transmit bytes over serial to the Notecard, in segments, followed by
+  an optional suffix.
+
+  The suffix is transmitted together with the last segment, so that a
+  vectored transmit hook receives both in one call.
 
   @param   buffer A buffer of bytes to transmit.
   @param   size The count of bytes in the buffer to send.
+  @param   suffix Bytes to transmit after the buffer, or NULL.
+  @param   suffixLen The count of bytes in the suffix.
   @param   delay Respect standard processing delays.
-
-  @returns  A c-string with an error, or `NULL` if no error ocurred.
 */
 /**************************************************************************/
-const char *_serialChunkedTransmit(const uint8_t *buffer, uint32_t size, bool delay)
+static void _serialSegmentedTransmit(const uint8_t *buffer, uint32_t size, const uint8_t *suffix, size_t suffixLen, bool delay)
 {
-#if CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN > SIZE_MAX
-#  error "CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN exceeds SIZE_MAX. Use I2C interface instead."
-#endif
-
     // Transmit the request in segments so as not to overwhelm the Notecard's
     // interrupt buffers
-    for (uint32_t segRem = size, segOff = 0; segRem > 0; ) {
+    const uint32_t maxSegLen = _serialPacingSegmentLen();
+    for (uint32_t segRem = size, segOff = 0; ; ) {
         size_t segLen;
 
         // Set the segment length to the max or the remainder, whichever is less
-        if (segRem > CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN) {
-            segLen = CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN;
+        if (segRem > maxSegLen) {
+            segLen = maxSegLen;
         } else {
             segLen = (size_t)segRem;
         }
-
-        _SerialTransmit(&buffer[segOff], segLen, false);
-        segOff += segLen;
-
-        // Check here to avoid an unnecessary delay at the end of the last segment
-        segRem -= segLen;
-        if (segRem == 0) {
+        segRem -= (uint32_t)segLen;
+        const bool lastSeg = (segRem == 0);
+
+        // Gather the suffix with the last segment
+        NoteIoVec iov[2];
+        size_t iovCount = 0;
+        if (segLen > 0) {
+            iov[iovCount].data = &buffer[segOff];
+            iov[iovCount++].len = segLen;
+        }
+        if (lastSeg && suffixLen > 0) {
+            iov[iovCount].data = suffix;
+            iov[iovCount++].len = suffixLen;
+            segLen += suffixLen;
+        }
+        if (iovCount == 0) {
             break;
         }
+
+        // Wait for the Notecard to make room for the segment
+        if (delay) {
+            _serialPacingWait((uint32_t)segLen);
+        }
+        _SerialTransmitv(iov, iovCount, (lastSeg && suffixLen > 0));
         if (delay) {
-            _DelayMs(CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS);
+            _serialPacingSent((uint32_t)segLen);
+        }
+        _StatsAdd(bytesSent, segLen);
+        _Trace(NOTE_C_TRACE_SEGMENT_TX, segLen);
+        segOff += (uint32_t)iov[0].len;
+
+        if (lastSeg) {
+            break;
         }
     }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Transmit bytes over serial to the Notecard.
+
+  @param   buffer A buffer of bytes to transmit.
+  @param   size The count of bytes in the buffer to send.
+  @param   delay Respect standard processing delays.
 
+  @returns  A c-string with an error, or `NULL` if no error ocurred.
+*/
+/**************************************************************************/
+const char *_serialChunkedTransmit(const uint8_t *buffer, uint32_t size, bool delay)
+{
+    _serialSegmentedTransmit(buffer, size, NULL, 0, delay);
+    return NULL;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Transmit bytes over serial to the Notecard, terminated by a carriage
+  return and newline, and flush them.
+
+  @param   buffer A buffer of bytes to transmit.
+  @param   size The count of bytes in the buffer to send, without a terminator.
+  @param   delay Respect standard processing delays.
+
+  @returns  A c-string with an error, or `NULL` if no error ocurred.
+*/
+/**************************************************************************/
+const char *_serialChunkedTransmitLine(const uint8_t *buffer, uint32_t size, bool delay)
+{
+    // Stack buffer used to avoid passing flash-resident data through the
+    // non-const hook. TODO: Remove when serialTransmitFn accepts const uint8_t *.
+    uint8_t newline[] = {'\r', '\n'};
+    _serialSegmentedTransmit(buffer, size, newline, c_newline_len, delay);
     return NULL;
 }
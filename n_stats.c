@@ -0,0 +1,192 @@
+/*!
+ * @file n_stats.c
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#ifdef NOTE_C_STATS
+
+#include "n_lib.h"
+
+// Statistics, updated by the transaction and transport layers while they hold
+// the Notecard lock
+NoteStats noteStats;
+
+/*!
+ @internal
+
+ @brief Count a latency in a histogram of power-of-two buckets.
+
+ @param latency The histogram.
+ @param ms The latency to count.
+ */
+static void _noteStatsLatency(uint32_t *latency, uint32_t ms)
+{
+    uint32_t bucket = 0;
+    while (ms != 0 && bucket < (NOTE_C_STATS_BUCKETS - 1)) {
+        ms >>= 1;
+        bucket++;
+    }
+    latency[bucket]++;
+}
+
+/*!
+ @internal
+
+ @brief Find the statistics kept for an API, claiming an unused entry if the
+        API hasn't been seen before.
+
+ @param api The name of the API.
+
+ @returns The statistics for the API, or NULL if there is no room for it.
+ */
+static NoteStatsApi *_noteStatsApi(const char *api)
+{
+    for (size_t i = 0 ; i < NOTE_C_STATS_APIS ; ++i) {
+        NoteStatsApi *entry = &noteStats.apis[i];
+        if (entry->api[0] == '\0') {
+            strlcpy(entry->api, api, sizeof(entry->api));
+            return entry;
+        }
+        if (strncmp(entry->api, api, sizeof(entry->api) - 1) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/*!
+ @internal
+
+ @brief Record a completed transaction.
+
+ @param api The name of the API, or NULL or "" if it isn't known.
+ @param elapsedMs The duration of the transaction, including its retries.
+ @param retries The number of retries performed.
+ @param isError `true` if the transaction ended in an error.
+ */
+void _noteStatsTransaction(const char *api, uint32_t elapsedMs, uint32_t retries, bool isError)
+{
+    noteStats.transactions++;
+    if (isError) {
+        noteStats.errors++;
+    }
+    _noteStatsLatency(noteStats.latency, elapsedMs);
+
+    NoteStatsApi *entry = ((api != NULL && api[0] != '\0') ? _noteStatsApi(api) : NULL);
+    if (entry == NULL) {
+        noteStats.untracked++;
+        return;
+    }
+    entry->transactions++;
+    if (isError) {
+        entry->errors++;
+    }
+    entry->retries += retries;
+    entry->totalMs += elapsedMs;
+    if (elapsedMs > entry->maxMs) {
+        entry->maxMs = elapsedMs;
+    }
+    _noteStatsLatency(entry->latency, elapsedMs);
+}
+
+/*!
+ @internal
+
+ @brief Add a latency histogram to a JSON object.
+
+ @param obj The object.
+ @param latency The histogram.
+
+ @returns `true` on success, and `false` if there is insufficient memory.
+ */
+static bool _noteStatsAddLatency(J *obj, const uint32_t *latency)
+{
+    J *arr = JAddArrayToObject(obj, "latency");
+    if (arr == NULL) {
+        return false;
+    }
+    for (size_t i = 0 ; i < NOTE_C_STATS_BUCKETS ; ++i) {
+        J *item = JCreateNumber((JNUMBER)latency[i]);
+        if (item == NULL) {
+            return false;
+        }
+        JAddItemToArray(arr, item);
+    }
+    return true;
+}
+
+void NoteGetStats(NoteStats *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    _LockNote();
+    *stats = noteStats;
+    _UnlockNote();
+}
+
+J *NoteGetStatsObject(void)
+{
+    J *obj = JCreateObject();
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    _LockNote();
+    JAddIntToObject(obj, "transactions", noteStats.transactions);
+    JAddIntToObject(obj, "errors", noteStats.errors);
+    JAddIntToObject(obj, "retries", noteStats.retries);
+    JAddIntToObject(obj, "io_errors", noteStats.ioErrors);
+    JAddIntToObject(obj, "crc_errors", noteStats.crcErrors);
+    JAddIntToObject(obj, "bad_bin_errors", noteStats.badBinErrors);
+    JAddIntToObject(obj, "heartbeats", noteStats.heartbeats);
+    JAddIntToObject(obj, "resets", noteStats.resets);
+    JAddIntToObject(obj, "reset_failures", noteStats.resetFailures);
+    JAddIntToObject(obj, "bytes_sent", noteStats.bytesSent);
+    JAddIntToObject(obj, "bytes_received", noteStats.bytesReceived);
+    JAddIntToObject(obj, "i2c_queries", noteStats.i2cQueries);
+    JAddIntToObject(obj, "i2c_query_ms", noteStats.i2cQueryMs);
+    JAddIntToObject(obj, "untracked", noteStats.untracked);
+    bool success = _noteStatsAddLatency(obj, noteStats.latency);
+
+    J *apis = JAddObjectToObject(obj, "apis");
+    success = success && (apis != NULL);
+    for (size_t i = 0 ; success && i < NOTE_C_STATS_APIS && noteStats.apis[i].api[0] != '\0' ; ++i) {
+        const NoteStatsApi *entry = &noteStats.apis[i];
+        J *api = JAddObjectToObject(apis, entry->api);
+        if (api == NULL) {
+            success = false;
+            break;
+        }
+        JAddIntToObject(api, "transactions", entry->transactions);
+        JAddIntToObject(api, "errors", entry->errors);
+        JAddIntToObject(api, "retries", entry->retries);
+        JAddIntToObject(api, "total_ms", entry->totalMs);
+        JAddIntToObject(api, "max_ms", entry->maxMs);
+        success = _noteStatsAddLatency(api, entry->latency);
+    }
+    _UnlockNote();
+
+    if (!success) {
+        JDelete(obj);
+        return NULL;
+    }
+    return obj;
+}
+
+void NoteResetStats(void)
+{
+    _LockNote();
+    memset(&noteStats, 0, sizeof(noteStats));
+    _UnlockNote();
+}
+
+#endif // NOTE_C_STATS
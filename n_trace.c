@@ -0,0 +1,114 @@
+/*!
+ * @file n_trace.c
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#ifdef NOTE_C_TRACE
+
+#include "n_lib.h"
+
+// The trace ring, written by the transaction and transport layers while they
+// hold the Notecard lock
+static NoteTraceEvent traceRing[NOTE_C_TRACE_EVENTS];
+static uint32_t traceEvents = 0;    // Events recorded since the ring was cleared
+static traceClockFn traceClock = NULL;
+
+/*!
+ @internal
+
+ @brief Record a trace event, overwriting the oldest event when the ring is
+        full.
+
+ @param type The type of the event.
+ @param arg The argument of the event, truncated to 16 bits.
+ */
+void _noteTrace(uint8_t type, uint32_t arg)
+{
+    NoteTraceEvent *event = &traceRing[traceEvents % NOTE_C_TRACE_EVENTS];
+    event->timeUs = ((traceClock != NULL) ? traceClock() : (_GetMs() * 1000));
+    event->arg = (uint16_t)arg;
+    event->type = type;
+    event->reserved = 0;
+    traceEvents++;
+}
+
+/*!
+ @internal
+
+ @brief Get an event from the ring, oldest first. Called with the Notecard
+        locked.
+
+ @param i The position of the event, from 0 for the oldest.
+
+ @returns The event.
+ */
+static const NoteTraceEvent *_noteTraceEvent(uint32_t i)
+{
+    const uint32_t first = ((traceEvents > NOTE_C_TRACE_EVENTS) ? (traceEvents - NOTE_C_TRACE_EVENTS) : 0);
+    return &traceRing[(first + i) % NOTE_C_TRACE_EVENTS];
+}
+
+void NoteSetTraceClock(traceClockFn clockFn)
+{
+    _LockNote();
+    traceClock = clockFn;
+    _UnlockNote();
+}
+
+size_t NoteTraceRead(NoteTraceEvent *events, size_t maxEvents)
+{
+    if (events == NULL) {
+        return 0;
+    }
+
+    _LockNote();
+    size_t count = ((traceEvents > NOTE_C_TRACE_EVENTS) ? NOTE_C_TRACE_EVENTS : traceEvents);
+    if (count > maxEvents) {
+        count = maxEvents;
+    }
+    for (size_t i = 0 ; i < count ; ++i) {
+        events[i] = *_noteTraceEvent((uint32_t)i);
+    }
+    _UnlockNote();
+
+    return count;
+}
+
+void NoteTraceDump(void)
+{
+    // "notetrace TTTTTTTT YYYY AAAA"
+    char line[sizeof("notetrace ") + 8 + 1 + 4 + 1 + 4];
+    memcpy(line, "notetrace ", sizeof("notetrace ") - 1);
+    char *p = &line[sizeof("notetrace ") - 1];
+
+    _LockNote();
+    const uint32_t count = ((traceEvents > NOTE_C_TRACE_EVENTS) ? NOTE_C_TRACE_EVENTS : traceEvents);
+    for (uint32_t i = 0 ; i < count ; ++i) {
+        const NoteTraceEvent *event = _noteTraceEvent(i);
+        _n_htoa16((uint16_t)(event->timeUs >> 16), (unsigned char *)&p[0]);
+        _n_htoa16((uint16_t)event->timeUs, (unsigned char *)&p[4]);
+        p[8] = ' ';
+        _n_htoa16(event->type, (unsigned char *)&p[9]);
+        p[13] = ' ';
+        _n_htoa16(event->arg, (unsigned char *)&p[14]);
+        _Debugln(line);
+    }
+    _UnlockNote();
+}
+
+void NoteTraceClear(void)
+{
+    _LockNote();
+    traceEvents = 0;
+    _UnlockNote();
+}
+
+#endif // NOTE_C_TRACE
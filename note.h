@@ -114,6 +114,24 @@ extern "C" {
 
 // Notecard hook functions
 
+/*!
+ @typedef crc32Fn
+
+ @brief The type for the CRC32 hook.
+
+ The hook must compute the standard reflected CRC-32 (polynomial 0xEDB88320,
+ as used by zlib) and must support computing it over a buffer in pieces, by
+ passing the result for the preceding pieces as `crc`, exactly like zlib's
+ `crc32()`.
+
+ @param crc The CRC32 of the preceding pieces, or 0 for the first piece.
+ @param data The buffer.
+ @param length The length of the buffer.
+
+ @returns The CRC32 of the buffer up to and including this piece.
+ */
+typedef uint32_t (*crc32Fn) (uint32_t crc, const uint8_t *data, size_t length);
+
 /*!
  @typedef delayMsFn
 
@@ -222,6 +240,20 @@ typedef const char * (*i2cTransmitFn) (uint16_t address, uint8_t* txBuf,
  */
 typedef void * (*mallocFn) (size_t size);
 
+/*!
+ @typedef reallocFn
+
+ @brief The type for the memory reallocation hook.
+
+ @param ptr The memory to resize, previously allocated by the memory
+        allocation hook, or NULL.
+ @param size The number of bytes to resize it to.
+
+ @returns A pointer to the resized memory, with its contents preserved, or
+          NULL on failure, in which case `ptr` is left allocated.
+ */
+typedef void * (*reallocFn) (void *ptr, size_t size);
+
 /*!
  @typedef mutexFn
 
@@ -229,6 +261,17 @@ typedef void * (*mallocFn) (size_t size);
  */
 typedef void (*mutexFn) (void);
 
+/*!
+ @typedef tryMutexFn
+
+ @brief The type for the Notecard try-lock hook.
+
+ @param timeoutMs The longest time to wait for the lock, in milliseconds.
+
+ @returns `true` if the lock was taken and `false` if it wasn't taken in time.
+ */
+typedef bool (*tryMutexFn) (uint32_t timeoutMs);
+
 /*!
  @typedef serialAvailableFn
 
@@ -247,6 +290,31 @@ typedef bool (*serialAvailableFn) (void);
  */
 typedef char (*serialReceiveFn) (void);
 
+/*!
+ @typedef serialAvailableCountFn
+
+ @brief The type for the serial available count hook.
+
+ @return The number of bytes that can be read without waiting.
+ */
+typedef size_t (*serialAvailableCountFn) (void);
+
+/*!
+ @typedef serialReceiveBufferFn
+
+ @brief The type for the bulk serial receive hook.
+
+ The hook should not wait for data to arrive; it returns whatever has already
+ been received, which may be nothing.
+
+ @param buf A buffer to store the received bytes.
+ @param max The size, in bytes, of `buf`.
+ @param got The number of bytes stored in `buf`.
+
+ @return `true` on success and `false` on failure.
+ */
+typedef bool (*serialReceiveBufferFn) (uint8_t *buf, size_t max, size_t *got);
+
 /*!
  @typedef serialResetFn
 
@@ -270,6 +338,59 @@ typedef bool (*serialResetFn) (void);
  */
 typedef void (*serialTransmitFn) (uint8_t *txBuf, size_t txBufSize, bool flush);
 
+/*!
+ @brief A buffer in a gather list passed to a vectored transmit hook.
+ */
+typedef struct {
+    const uint8_t *data;    /*!< The bytes to transmit */
+    size_t len;             /*!< The number of bytes */
+} NoteIoVec;
+
+/*!
+ @typedef serialTransmitVectorFn
+
+ @brief The type for the vectored serial transmit hook.
+
+ The buffers are transmitted back to back, in order, as with `writev`.
+
+ @param iov The buffers to transmit.
+ @param iovCount The number of buffers.
+ @param flush If true, flush the serial peripheral's transmit buffer.
+ */
+typedef void (*serialTransmitVectorFn) (const NoteIoVec *iov, size_t iovCount, bool flush);
+
+/*!
+ @typedef i2cTransmitVectorFn
+
+ @brief The type for the vectored I2C transmit hook.
+
+ Each buffer is sent as its own I2C write, framed exactly as by the I2C
+ transmit hook, and the writes are issued back to back, in order.
+
+ @param address The I2C address of the Notecard to transmit the data to.
+ @param iov The buffers to transmit, each at most the I2C MTU in size.
+ @param iovCount The number of buffers.
+
+ @returns NULL on success and an error string on failure.
+ */
+typedef const char * (*i2cTransmitVectorFn) (uint16_t address, const NoteIoVec *iov, size_t iovCount);
+
+/*!
+ @typedef waitForDataFn
+
+ @brief The type for the I2C data-ready wait hook.
+
+ This hook blocks until the Notecard signals that it has a response for the
+ host, typically via an interrupt on a GPIO wired to the Notecard's ATTN pin,
+ or until the timeout elapses, whichever comes first.
+
+ @param timeoutMs The maximum time, in milliseconds, to wait.
+
+ @returns `true` if the Notecard signalled that data is ready, `false` if the
+          timeout elapsed first.
+ */
+typedef bool (*waitForDataFn) (uint32_t timeoutMs);
+
 /*!
  @typedef txnStartFn
 
@@ -392,10 +513,17 @@ J *NoteRequestResponseWithRetry(J *req, uint32_t timeoutSeconds);
  instead of "req"), this function returns NULL, since commands do not have
  a response.
 
- @param reqJSON A valid newline-terminated JSON C-string containing the request.
+ The string may also hold a pipeline of newline-delimited requests and
+ commands, which are sent in turn while the Notecard is locked once. The
+ responses to the requests are returned in the same order, one per line, and a
+ request that fails yields an error document (with its "id", if any) in its
+ place. Malformed lines are skipped.
+
+ @param reqJSON A valid newline-terminated JSON C-string containing the request,
+        or several newline-delimited requests.
 
- @returns A newline-terminated JSON C-string with the response, or NULL
-          if there was no response or if there was an error.
+ @returns A newline-terminated JSON C-string with the response (or responses),
+          or NULL if there was no response or if there was an error.
 
  @note When a "cmd" is sent, it is not possible to determine if an error occurred.
 
@@ -405,6 +533,226 @@ J *NoteRequestResponseWithRetry(J *req, uint32_t timeoutSeconds);
        the memory associated with the request string.
  */
 char * NoteRequestResponseJSON(const char *reqJSON);
+/*!
+ @brief Send a batch of requests to the Notecard and return all the responses.
+
+ The Notecard lock is taken, and the transaction window (see
+ `NoteSetFnTransaction`) is opened, exactly once for the entire batch, rather
+ than once per request. This reduces the overhead and the number of Notecard
+ wake-ups when many requests are issued back-to-back.
+
+ The requests are sent in array order. Each request behaves exactly as if it
+ had been sent with `NoteTransaction`, including CRC, retry and reset handling.
+ The returned array holds one response per request, in the same order. A
+ failed request yields an error response (i.e. one with an "err" field) in its
+ slot, so a failure does not prevent the remaining requests from being sent.
+ A response that could not be allocated is replaced by a `{mem}` error
+ response. Commands (i.e. "cmd") yield an empty object.
+
+ The passed in array, and the requests it contains, are always freed,
+ regardless of if the requests were successful or not.
+
+ @param reqArray Pointer to a `J` array of request objects.
+
+ @returns A `J` array with one response per request, or NULL if `reqArray` is
+          NULL, is not an array or if memory for the responses could not be
+          allocated.
+
+ @see NoteResponseError to check each response for errors.
+ */
+J *NoteRequestBatch(J *reqArray);
+/*!
+ @brief A request that is serialized once and sent many times.
+
+ @see NoteRequestTemplateNew
+ */
+typedef struct NoteRequestTemplate NoteRequestTemplate;
+/*!
+ @brief Create a template for a request that is sent repeatedly.
+
+ The request is serialized once, when the template is created. Any string
+ value of the form `"{{name}}"` marks a slot, whose value is set with the
+ `NoteRequestTemplateSet*` functions and stamped into the serialized request
+ each time it is sent. This avoids rebuilding and re-serializing a request of
+ the same shape (e.g. a `note.add` of sensor readings) on every send.
+
+ @code
+ J *req = NoteNewRequest("note.add");
+ JAddStringToObject(req, "file", "sensors.qo");
+ J *body = JAddObjectToObject(req, "body");
+ JAddStringToObject(body, "temp", "{{temp}}");
+ JAddStringToObject(body, "state", "{{state}}");
+ NoteRequestTemplate *tmpl = NoteRequestTemplateNew(req);
+
+ NoteRequestTemplateSetNumber(tmpl, "temp", 21.5);
+ NoteRequestTemplateSetString(tmpl, "state", "ok");
+ NoteRequestTemplateSend(tmpl);
+ @endcode
+
+ The "id" of the request and its timeout are also fixed when the template is
+ created. Slot names must be unique within the request, and slots may not be
+ used as keys. The user agent is never added to `hub.set` templates.
+
+ The passed in request is always freed, regardless of if the template could
+ be created or not.
+
+ @param req Pointer to a `J` request object.
+
+ @returns The template, which must be freed with `NoteRequestTemplateDelete`,
+          or NULL if the request is invalid or there is insufficient memory.
+ */
+NoteRequestTemplate *NoteRequestTemplateNew(J *req);
+/*!
+ @brief Free a request template.
+
+ @param tmpl The template to free. May be NULL.
+ */
+void NoteRequestTemplateDelete(NoteRequestTemplate *tmpl);
+/*!
+ @brief Set the value of a slot of a request template to an integer.
+
+ @param tmpl The request template.
+ @param slot The name of the slot.
+ @param value The value.
+
+ @returns `true` if the slot was set, and `false` if there is no such slot or
+          there is insufficient memory.
+ */
+bool NoteRequestTemplateSetInt(NoteRequestTemplate *tmpl, const char *slot, JINTEGER value);
+/*!
+ @brief Set the value of a slot of a request template to a number.
+
+ @param tmpl The request template.
+ @param slot The name of the slot.
+ @param value The value.
+
+ @returns `true` if the slot was set, and `false` if there is no such slot or
+          there is insufficient memory.
+ */
+bool NoteRequestTemplateSetNumber(NoteRequestTemplate *tmpl, const char *slot, JNUMBER value);
+/*!
+ @brief Set the value of a slot of a request template to a string.
+
+ @param tmpl The request template.
+ @param slot The name of the slot.
+ @param value The value, which is copied. NULL is treated as an empty string.
+
+ @returns `true` if the slot was set, and `false` if there is no such slot or
+          there is insufficient memory.
+ */
+bool NoteRequestTemplateSetString(NoteRequestTemplate *tmpl, const char *slot, const char *value);
+/*!
+ @brief Send a request template to the Notecard, and return the response.
+
+ The slot values are stamped into the serialized request, which is then sent
+ exactly as `NoteTransaction` sends a request, including CRC, retry and reset
+ handling. The template is not freed, and its slot values are retained for
+ subsequent sends.
+
+ @param tmpl The request template.
+
+ @returns A `J` object with the response, or NULL if a slot has not been set
+          or there is insufficient memory. A command (i.e. "cmd") template
+          yields an empty object.
+ */
+J *NoteRequestTemplateResponse(NoteRequestTemplate *tmpl);
+/*!
+ @brief Send a request template to the Notecard.
+
+ @param tmpl The request template.
+
+ @returns `true` if the request was sent and its response has no error.
+
+ @see NoteRequestTemplateResponse
+ */
+bool NoteRequestTemplateSend(NoteRequestTemplate *tmpl);
+/*!
+ @brief Send a request to the Notecard without using the heap.
+
+ The request is serialized into the caller-supplied scratch buffer, the CRC is
+ appended in place and the response is received into the same buffer. No
+ memory is allocated by this function or by the transport, which makes it
+ suitable for hosts where heap fragmentation is a concern. CRC, retry, reset
+ and heartbeat handling are the same as `NoteTransaction`, but the user agent
+ is never added to `hub.set` requests.
+
+ The response is left in `scratch` as a null-terminated JSON string, stripped
+ of its trailing newline and CRC field, so it can be inspected in place (e.g.
+ with `JParse`, if the heap is available, or a scanner of the caller's
+ choosing). Errors reported by the Notecard (i.e. an "err" field) are
+ returned in the response, exactly as `NoteRequestResponseJSON` does. Commands
+ (i.e. "cmd") leave `{}` in the buffer.
+
+ @param req Pointer to a `J` request object. It is not freed.
+ @param scratch A buffer that holds the serialized request and then the
+        response.
+ @param scratchLen The size of the buffer in bytes. It must hold the larger of
+        the request (plus 24 bytes for the CRC field and newline) and the
+        response (plus the null-terminator).
+
+ @returns NULL on success, or an error string if the transaction failed or if
+          either the request or the response did not fit in `scratch`.
+ */
+const char *NoteTransactionBuffered(J *req, uint8_t *scratch, size_t scratchLen);
+
+/*!
+ @brief Status values returned by `NoteTransactionPoll`.
+ */
+enum {
+    NOTE_C_TXN_IDLE = 0,    /*!< No transaction has been begun */
+    NOTE_C_TXN_IN_PROGRESS, /*!< The transaction is still in flight */
+    NOTE_C_TXN_COMPLETE,    /*!< The response is ready to be collected */
+};
+/*!
+ @brief Begin a non-blocking transaction with the Notecard.
+
+ This is the non-blocking counterpart of `NoteTransaction`, for single-threaded
+ firmware (e.g. a super-loop or cooperative scheduler) that can't afford to be
+ blocked for the whole round trip. The request is serialized immediately,
+ after which `NoteTransactionPoll` must be called regularly to drive the
+ transaction forward. Each call transmits the next piece of the request or
+ reads whatever part of the response has already arrived, and returns without
+ waiting. The pauses between request segments and between retries are
+ observed across calls rather than by sleeping. Once the transaction is
+ complete, `NoteTransactionEnd` returns the response.
+
+ CRC, retry, reset and heartbeat handling are the same as `NoteTransaction`.
+ The Notecard lock and the transaction window are held from this call until
+ the transaction completes, and only one transaction may be in flight at a
+ time.
+
+ @param req Pointer to a `J` request object. It is not freed, and may be freed
+        as soon as this function returns.
+
+ @returns `true` if the transaction was begun, or `false` if the request is
+          invalid, could not be serialized or another transaction is already
+          in flight.
+
+ @note The platform's `txnStartFn` and I/O reset hooks are still called
+       synchronously, so they may block when invoked.
+ */
+bool NoteTransactionBegin(J *req);
+/*!
+ @brief Advance the transaction begun with `NoteTransactionBegin`.
+
+ @returns `NOTE_C_TXN_IN_PROGRESS` while the transaction is in flight,
+          `NOTE_C_TXN_COMPLETE` once `NoteTransactionEnd` may collect the
+          response, or `NOTE_C_TXN_IDLE` if no transaction has been begun.
+ */
+int NoteTransactionPoll(void);
+/*!
+ @brief End the transaction begun with `NoteTransactionBegin`.
+
+ Calling this before `NoteTransactionPoll` reports `NOTE_C_TXN_COMPLETE`
+ abandons the transaction, and the I/O interface is reset before the next one.
+
+ @returns The response, exactly as `NoteTransaction` would have returned it,
+          an error response if a request was abandoned, or NULL if no
+          transaction had been begun or a command was abandoned. An abandoned
+          command has no response, because it may not have been sent in
+          full. The caller must free the response.
+ */
+J *NoteTransactionEnd(void);
 NOTE_C_DEPRECATED void NoteSuspendTransactionDebug(void);
 NOTE_C_DEPRECATED void NoteResumeTransactionDebug(void);
 #define SYNCSTATUS_LEVEL_MAJOR         0
@@ -468,6 +816,281 @@ bool NoteRequestWithRetry(J *req, uint32_t timeoutSeconds);
  @returns The previous timeout value that was overridden.
  */
 uint32_t NoteSetRequestTimeout(uint32_t overrideSecs);
+/*!
+ @brief Stream requests to the Notecard as they are serialized.
+
+ By default, each request is serialized into a single heap buffer (and copied
+ once more to add the CRC) before it is transmitted. When streaming is enabled,
+ requests are instead serialized through one transport-sized segment buffer,
+ which is transmitted each time it fills, and the CRC is computed as the bytes
+ go out. This bounds the memory needed to send a request to one segment,
+ regardless of the size of the request, at the cost of re-serializing the
+ request on retry and of not tracing the request text.
+
+ @param enable `true` to stream requests and `false` (the default) to serialize
+        them in full before transmitting.
+
+ @returns The previous setting.
+ */
+bool NoteSetRequestStreaming(bool enable);
+
+// Priority classes of NoteTransactionWithPriority
+#define NOTE_C_PRIORITY_HIGH    0
+#define NOTE_C_PRIORITY_NORMAL  1
+#define NOTE_C_PRIORITY_LOW     2
+#define NOTE_C_PRIORITY_CLASSES 3
+
+/*!
+ @brief Enable or disable scheduling of access to the Notecard.
+
+ By default, threads wait for the Notecard on the mutex set with
+ `NoteSetFnNoteMutex`, in whatever order the platform wakes them. When
+ scheduling is enabled, the mutex only guards a queue of waiting threads, and
+ the Notecard is handed to the waiter with the highest priority class (see
+ `NoteTransactionWithPriority`), in first-come, first-served order within a
+ class. Waiters check for their turn after `NOTE_C_SCHEDULER_POLL_MS`
+ milliseconds, backing off to every `NOTE_C_SCHEDULER_POLL_MAX_MS` (50 by
+ default) while the Notecard stays busy. Other requests and note-c functions
+ wait in the `NOTE_C_PRIORITY_NORMAL` class.
+
+ Scheduling must be enabled or disabled before other threads use the
+ Notecard.
+
+ @warning With scheduling enabled, the Notecard lock isn't recursive, even if
+          the platform mutex is. A thread that already holds the Notecard,
+          such as a hook or callback that issues a request while a
+          transaction is in progress, waits for itself forever.
+
+ @param enable `true` to schedule access to the Notecard and `false` (the
+        default) to leave it to the mutex.
+
+ @returns The previous setting.
+ */
+bool NoteSetRequestScheduling(bool enable);
+/*!
+ @brief Send a request to the Notecard, waiting for it in a priority class.
+
+ This is `NoteTransaction`, except that the wait for the Notecard is ordered
+ by `priority` when request scheduling is enabled (see
+ `NoteSetRequestScheduling`) and bounded by `timeoutMs`. A long transaction
+ already in progress is never interrupted, but a waiting request of a higher
+ class goes ahead of all requests of lower classes. Without scheduling, a
+ bounded wait requires the try-lock function set with `NoteSetFnNoteTryLock`.
+
+ This function doesn't free the passed in request object.
+
+ @param req Pointer to a `J` request object.
+ @param priority One of `NOTE_C_PRIORITY_HIGH`, `NOTE_C_PRIORITY_NORMAL` or
+        `NOTE_C_PRIORITY_LOW`.
+ @param timeoutMs The longest time to wait for the Notecard, in milliseconds,
+        or 0 to wait for as long as it takes.
+
+ @returns A `J` object with the response, an error response containing
+          "{busy}" if the Notecard didn't become available in time, or NULL
+          under the same conditions as `NoteTransaction`.
+ */
+J *NoteTransactionWithPriority(J *req, uint8_t priority, uint32_t timeoutMs);
+/*!
+ @brief Policy governing how failed transactions are retried.
+
+ Each retry is preceded by a delay that starts at `initialDelayMs` and is
+ multiplied by `backoffFactor` after every retry, up to `maxDelayMs`. A
+ transaction stops being retried once any of its limits is reached.
+ */
+typedef struct {
+    uint32_t initialDelayMs;    /*!< Delay before the first retry */
+    uint32_t maxDelayMs;        /*!< Upper limit of the delay before a retry */
+    uint32_t deadlineMs;        /*!< Time allowed for all attempts at a transaction (0 for no limit) */
+    uint8_t backoffFactor;      /*!< Growth of the delay after each retry (1 for a fixed delay) */
+    uint8_t jitterPercent;      /*!< Random variation of each delay, as a percentage of the delay */
+    uint8_t maxRetries;         /*!< Retries allowed for a transaction, for any reason */
+    uint8_t ioRetries;          /*!< Retries allowed for `{io}` errors (I/O failures, timeouts and corrupt responses) */
+    uint8_t crcRetries;         /*!< Retries allowed for CRC errors */
+    uint8_t badBinRetries;      /*!< Retries allowed for `{bad-bin}` errors */
+} NoteRetryPolicy;
+/*!
+ @brief Set the policy for retrying failed transactions.
+
+ The default policy retries up to 5 times, after a fixed 500 ms delay, for
+ `{io}` and CRC errors alike, and never retries `{bad-bin}` errors. Adding
+ backoff and jitter avoids hammering a Notecard that is busy, while a generous
+ `crcRetries` with a short `initialDelayMs` recovers quickly from corruption on
+ a noisy line.
+
+ The policy also paces `NoteRequestResponseWithRetry` (and
+ `NoteRequestWithRetry`), which wait the backoff delay between attempts
+ instead of retrying back-to-back.
+
+ @param policy The policy to apply. It is copied. Pass NULL to restore the
+        default policy.
+ */
+void NoteSetRetryPolicy(const NoteRetryPolicy *policy);
+/*!
+ @brief Get the policy for retrying failed transactions.
+
+ @param policy Pointer to store the current policy.
+ */
+void NoteGetRetryPolicy(NoteRetryPolicy *policy);
+/*!
+ @brief Set how long responses to a read-only API are cached.
+
+ Responses to `card.version`, `hub.status`, `card.time`, `card.wireless` and
+ `env.get` may be cached by `NoteRequestResponse` (and `NoteRequest`), keyed on
+ the serialized request, so that tasks polling the same state share one
+ transaction. Only requests that have no arguments, other than the names and
+ time of `env.get`, are cached, as are only responses without an error.
+
+ Cached responses are discarded once their TTL elapses, when
+ `NoteInvalidateResponseCache` is called, and when a request that may change
+ the state they report (e.g. `env.set` for `env.get`) is sent through
+ `NoteRequestResponse`. Caching is disabled for every API by default.
+
+ @param api The API (e.g. "card.version").
+ @param ttlMs The time, in milliseconds, that a response remains valid, or 0
+        to disable caching of the API.
+
+ @returns `true` if the API is cacheable, and `false` otherwise.
+ */
+bool NoteSetResponseCacheTTL(const char *api, uint32_t ttlMs);
+/*!
+ @brief Discard cached responses.
+
+ @param api The API whose responses are discarded, or NULL to discard every
+        cached response.
+ */
+void NoteInvalidateResponseCache(const char *api);
+#ifdef NOTE_C_STATS
+#ifndef NOTE_C_STATS_APIS
+#define NOTE_C_STATS_APIS 16        // Number of distinct APIs tracked
+#endif
+#define NOTE_C_STATS_API_LEN 24     // Longest API name tracked, including the terminator
+#define NOTE_C_STATS_BUCKETS 16     // Latency histogram buckets
+/*!
+ @brief Statistics kept for a single API (e.g. "note.add").
+
+ Latencies are counted in a histogram of power-of-two buckets. Bucket 0 holds
+ transactions that took less than 1 ms and bucket `n` those that took from
+ `2^(n-1)` up to `2^n` ms, except the last bucket, which has no upper bound.
+ */
+typedef struct {
+    char api[NOTE_C_STATS_API_LEN];     /*!< Name of the API */
+    uint32_t transactions;              /*!< Transactions performed */
+    uint32_t errors;                    /*!< Transactions that ended in an error */
+    uint32_t retries;                   /*!< Retries performed across all transactions */
+    uint32_t totalMs;                   /*!< Time spent across all transactions */
+    uint32_t maxMs;                     /*!< Longest transaction */
+    uint32_t latency[NOTE_C_STATS_BUCKETS]; /*!< Latency histogram */
+} NoteStatsApi;
+/*!
+ @brief Statistics kept for all transactions with the Notecard.
+ */
+typedef struct {
+    uint32_t transactions;      /*!< Transactions performed */
+    uint32_t errors;            /*!< Transactions that ended in an error */
+    uint32_t retries;           /*!< Retries performed */
+    uint32_t ioErrors;          /*!< `{io}` errors (I/O failures, timeouts and corrupt responses) */
+    uint32_t crcErrors;         /*!< Responses that failed their CRC */
+    uint32_t badBinErrors;      /*!< `{bad-bin}` errors */
+    uint32_t heartbeats;        /*!< Heartbeats received while awaiting a response */
+    uint32_t resets;            /*!< Resets of the I/O interface */
+    uint32_t resetFailures;     /*!< Resets of the I/O interface that failed */
+    uint32_t bytesSent;         /*!< Bytes transmitted to the Notecard */
+    uint32_t bytesReceived;     /*!< Bytes received from the Notecard */
+    uint32_t i2cQueries;        /*!< Queries of the I2C response length */
+    uint32_t i2cQueryMs;        /*!< Time spent waiting for I2C responses */
+    uint32_t untracked;         /*!< Transactions of APIs that didn't fit in `apis` */
+    uint32_t latency[NOTE_C_STATS_BUCKETS]; /*!< Latency histogram */
+    NoteStatsApi apis[NOTE_C_STATS_APIS];   /*!< Per-API statistics, unused entries have an empty name */
+} NoteStats;
+/*!
+ @brief Get the statistics gathered since startup or the last call to
+        `NoteResetStats`.
+
+ Only available when note-c is built with `NOTE_C_STATS` defined.
+
+ @param stats Pointer to store a copy of the statistics.
+ */
+void NoteGetStats(NoteStats *stats);
+/*!
+ @brief Get the statistics as a JSON object.
+
+ The per-API statistics are keyed by API name, within an "apis" object.
+
+ @returns A `J` object that must be freed by the caller, or NULL if there is
+          insufficient memory.
+ */
+J *NoteGetStatsObject(void);
+/*!
+ @brief Clear the statistics.
+ */
+void NoteResetStats(void);
+#endif // NOTE_C_STATS
+#ifdef NOTE_C_TRACE
+#ifndef NOTE_C_TRACE_EVENTS
+#define NOTE_C_TRACE_EVENTS 128     // Number of events kept in the trace ring
+#endif
+// Trace event types, and the argument recorded with each
+#define NOTE_C_TRACE_TXN_START      1   // Transaction started, index of its API in n_api.c (0xFFFF if unknown)
+#define NOTE_C_TRACE_TXN_STOP       2   // Transaction finished, 1 if it ended in an error
+#define NOTE_C_TRACE_SEGMENT_TX     3   // Segment transmitted, its length
+#define NOTE_C_TRACE_FIRST_RX       4   // First byte of the response available, 0
+#define NOTE_C_TRACE_CRC_CHECK      5   // Response CRC checked, 1 if it failed
+#define NOTE_C_TRACE_RETRY          6   // Transaction retried, the class of the error
+#define NOTE_C_TRACE_RESET          7   // I/O interface reset, 1 if it succeeded
+#define NOTE_C_TRACE_HEARTBEAT      8   // Heartbeat received, 0
+/*!
+ @brief An event of the transaction trace.
+ */
+typedef struct {
+    uint32_t timeUs;    /*!< Timestamp, in microseconds */
+    uint16_t arg;       /*!< Argument, which depends on the type */
+    uint8_t type;       /*!< One of the `NOTE_C_TRACE_` event types */
+    uint8_t reserved;
+} NoteTraceEvent;
+/*!
+ @typedef traceClockFn
+
+ @brief The type for the trace clock hook.
+
+ @returns The value of a free-running microsecond counter.
+ */
+typedef uint32_t (*traceClockFn) (void);
+/*!
+ @brief Set the clock used to timestamp trace events.
+
+ Without a trace clock, events are timestamped with the millisecond counter,
+ scaled to microseconds.
+
+ Only available when note-c is built with `NOTE_C_TRACE` defined.
+
+ @param clockFn The platform-specific microsecond counter, or NULL.
+ */
+void NoteSetTraceClock(traceClockFn clockFn);
+/*!
+ @brief Copy the events in the trace ring, oldest first.
+
+ The ring keeps the last `NOTE_C_TRACE_EVENTS` events.
+
+ @param events Pointer to store the events.
+ @param maxEvents The number of events that fit in `events`.
+
+ @returns The number of events copied.
+ */
+size_t NoteTraceRead(NoteTraceEvent *events, size_t maxEvents);
+/*!
+ @brief Write the events in the trace ring to the debug output, oldest first.
+
+ Each event is written on a line of the form "notetrace TTTTTTTT YYYY AAAA",
+ the hexadecimal timestamp, type and argument of the event.
+ `scripts/notetrace_to_chrome.py` converts these lines into a Chrome trace
+ that can be opened in Perfetto or chrome://tracing.
+ */
+void NoteTraceDump(void);
+/*!
+ @brief Discard the events in the trace ring.
+ */
+void NoteTraceClear(void);
+#endif // NOTE_C_TRACE
 
 /*!
  @brief Check if the Notecard response contains an error.
@@ -553,6 +1176,26 @@ void NoteSetFnHeartbeat(heartbeatFn fn, void *context);
  */
 void NoteGetFnHeartbeat(heartbeatFn *fn, void **context);
 #endif
+/*!
+ @brief Set the CRC32 hook.
+
+ The CRC32 protects every request and response. By default it is computed with
+ the built-in tables, whose size is selected at build time with
+ `NOTE_C_CRC32_SLICING`. Platforms with a CRC peripheral or CRC instructions
+ may supply a faster implementation. Pass NULL to restore the built-in tables.
+
+ @param fn Pointer to the CRC32 function.
+
+ @note The hook is not used when `NOTE_C_LOW_MEM` is defined, because CRCs are
+       then disabled.
+ */
+void NoteSetFnCRC32(crc32Fn fn);
+/*!
+ @brief Get the currently set CRC32 hook.
+
+ @param fn Pointer to store the current CRC32 function pointer.
+ */
+void NoteGetFnCRC32(crc32Fn *fn);
 /*!
  @brief Set the transaction hook functions.
 
@@ -630,6 +1273,23 @@ void NoteSetFnNoteMutex(mutexFn lockFn, mutexFn unlockFn);
        interested in that particular function pointer.
  */
 void NoteGetFnNoteMutex(mutexFn *lockFn, mutexFn *unlockFn);
+/*!
+ @brief Set the Notecard try-lock function.
+
+ The try-lock function takes the same lock as the lock function set with
+ `NoteSetFnNoteMutex`, but gives up after a time. It bounds the wait of
+ `NoteTransactionWithPriority` when request scheduling is disabled.
+
+ @param tryLockFn Function to lock Notecard access, waiting no longer than the
+        given time.
+ */
+void NoteSetFnNoteTryLock(tryMutexFn tryLockFn);
+/*!
+ @brief Get the currently set Notecard try-lock function.
+
+ @param tryLockFn Pointer to store the current Notecard try-lock function.
+ */
+void NoteGetFnNoteTryLock(tryMutexFn *tryLockFn);
 /*!
  @brief Set the default system functions (memory allocation, delay, timing).
 
@@ -671,6 +1331,27 @@ void NoteSetFn(mallocFn mallocHook, freeFn freeHook, delayMsFn delayMsHook,
  */
 void NoteGetFn(mallocFn *mallocHook, freeFn *freeHook, delayMsFn *delayMsHook,
                getMsFn *getMsHook);
+/*!
+ @brief Set the platform-specific memory reallocation hook function.
+
+ When set, buffers that outgrow their allocation, such as those holding a
+ large response, are resized in place where the heap allows, instead of being
+ copied into a new allocation. The hook must operate on the same heap as the
+ memory allocation and free hooks (e.g. `realloc` with `malloc` and `free`).
+
+ @param reallocHook The platform-specific memory reallocation function, or
+        NULL to allocate, copy and free instead.
+
+ @note This operation will lock Notecard access while in progress, if Notecard
+       mutex functions have been set.
+ */
+void NoteSetFnRealloc(reallocFn reallocHook);
+/*!
+ @brief Get the platform-specific memory reallocation hook function.
+
+ @param reallocHook Pointer to store the current memory reallocation function.
+ */
+void NoteGetFnRealloc(reallocFn *reallocHook);
 /*!
  @brief Set the platform-specific serial communication hook functions.
 
@@ -714,6 +1395,198 @@ void NoteSetFnSerialDefault(serialResetFn resetFn, serialTransmitFn transmitFn,
  */
 void NoteGetFnSerial(serialResetFn *resetFn, serialTransmitFn *transmitFn,
                      serialAvailableFn *availFn, serialReceiveFn *receiveFn);
+/*!
+ @brief Set the platform-specific hook functions used to receive serial data in
+        bulk.
+
+ When set, these are used in place of the serial available and receive hooks,
+ so that a response is read a buffer at a time rather than a byte at a time.
+
+ @param availCountFn The platform-specific function to get the number of bytes
+        that can be read without waiting, or NULL. When set, reads never ask
+        for more bytes than it reports.
+ @param receiveBufferFn The platform-specific function to receive serial data
+        in bulk, or NULL to receive a byte at a time.
+
+ @note This operation will lock Notecard access while in progress, if Notecard
+       mutex functions have been set.
+ */
+void NoteSetFnSerialReceiveBuffer(serialAvailableCountFn availCountFn,
+                                  serialReceiveBufferFn receiveBufferFn);
+/*!
+ @brief Get the platform-specific hook functions used to receive serial data in
+        bulk.
+
+ @param availCountFn Pointer to store the current serial available count
+        function.
+ @param receiveBufferFn Pointer to store the current bulk serial receive
+        function.
+
+ @note Any of the passed in pointers can be NULL if the caller is not
+       interested in that particular function pointer.
+ */
+void NoteGetFnSerialReceiveBuffer(serialAvailableCountFn *availCountFn,
+                                  serialReceiveBufferFn *receiveBufferFn);
+/*!
+ @brief Set the platform-specific vectored transmit hook functions.
+
+ When set, the serial transport hands each request segment and its
+ terminator to the platform in a single call, and the I2C transport hands
+ runs of chunks that need no processing delay between them (such as binary
+ data) to the platform in a single call, so that platforms with DMA or `writev`
+ don't need note-c to copy them into one buffer.
+
+ @param serialFn The platform-specific function to transmit a gather list via
+        serial, or NULL to use the serial transmit hook.
+ @param i2cFn The platform-specific function to transmit a gather list via
+        I2C, or NULL to use the I2C transmit hook.
+
+ @note This operation will lock Notecard access while in progress, if Notecard
+       mutex functions have been set.
+ */
+void NoteSetFnTransmitVector(serialTransmitVectorFn serialFn, i2cTransmitVectorFn i2cFn);
+/*!
+ @brief Get the platform-specific vectored transmit hook functions.
+
+ @param serialFn Pointer to store the current vectored serial transmit
+        function.
+ @param i2cFn Pointer to store the current vectored I2C transmit function.
+
+ @note Any of the passed in pointers can be NULL if the caller is not
+       interested in that particular function pointer.
+ */
+void NoteGetFnTransmitVector(serialTransmitVectorFn *serialFn, i2cTransmitVectorFn *i2cFn);
+/*!
+ @brief Set the platform-specific I2C data-ready wait hook.
+
+ When set, the I2C transport waits on this hook between queries for a
+ response instead of polling the Notecard, so that a response is picked up as
+ soon as the Notecard signals it. Each wait is bounded by the transaction
+ timeout and by `NOTE_C_I2C_WAIT_MAX_MS`, after which the Notecard is queried
+ anyway in case a signal was missed. A signal that turns out to have no data
+ behind it makes the transport poll for the rest of that response.
+
+ Without this hook, the transport polls the Notecard at an interval that
+ starts at `NOTE_C_I2C_POLL_MS` and doubles up to `NOTE_C_I2C_POLL_MAX_MS`.
+
+ @param fn The platform-specific function to wait for data, or NULL to poll.
+
+ @note This operation will lock Notecard access while in progress, if Notecard
+       mutex functions have been set.
+ */
+void NoteSetFnWaitForData(waitForDataFn fn);
+/*!
+ @brief Get the platform-specific I2C data-ready wait hook.
+
+ @param fn Pointer to store the current data-ready wait function.
+
+ @note The passed in pointer can be NULL if the caller is not interested in
+       the function pointer.
+ */
+void NoteGetFnWaitForData(waitForDataFn *fn);
+/*!
+ @brief Pacing of data sent to the Notecard over serial.
+
+ The host keeps track of how full the Notecard's receive buffer is, adding the
+ bytes it sends and draining it at `drainBytesPerSec`, and only pauses when a
+ segment would not fit.
+ */
+typedef struct {
+    uint32_t baudRate;          /*!< Baud rate of the serial port (0 if unknown) */
+    uint32_t drainBytesPerSec;  /*!< Rate at which the Notecard empties its receive buffer (0 for the default of 1000 bytes/s) */
+    uint16_t bufferLen;         /*!< Bytes the Notecard can buffer, and the largest segment sent at once (0 for default) */
+    bool flowControl;           /*!< The port uses hardware flow control, so the host never needs to pause */
+} NoteSerialPacing;
+/*!
+ @brief Set the pacing of data sent to the Notecard over serial.
+
+ The default pacing sends 250 bytes every 250 ms, which every Notecard model
+ keeps up with at any baud rate. A Notecard that drains its buffer faster, as
+ given by its datasheet, can be sent data sooner by raising
+ `drainBytesPerSec`. The drain rate is never derived from `baudRate`, since
+ a fast port doesn't make the Notecard consume data any faster, so a
+ `drainBytesPerSec` of 0 selects the default 1000 bytes/s. No pauses are made
+ when the port is slower than the Notecard drains its buffer, or when
+ `flowControl` is set.
+
+ @param pacing The pacing to apply. It is copied. Pass NULL to restore the
+        default pacing.
+
+ @note This operation will lock Notecard access while in progress, if Notecard
+       mutex functions have been set.
+ */
+void NoteSetSerialPacing(const NoteSerialPacing *pacing);
+/*!
+ @brief Get the pacing of data sent to the Notecard over serial.
+
+ @param pacing Pointer to store the current pacing.
+ */
+void NoteGetSerialPacing(NoteSerialPacing *pacing);
+/*!
+ @brief Pacing of data sent to the Notecard over I2C.
+
+ Requests are sent in chunks of the I2C MTU. The host pauses before each chunk,
+ after each chunk, and after each segment of chunks, so as not to overrun the
+ Notecard's interrupt buffers.
+ */
+typedef struct {
+    uint16_t ioDelayMs;         /*!< Pause before each I2C I/O, unless turbo I/O is enabled */
+    uint16_t chunkDelayMs;      /*!< Pause after each chunk of a request */
+    uint16_t segmentLen;        /*!< Bytes of a request sent before a segment pause (0 for default) */
+    uint16_t segmentDelayMs;    /*!< Pause after each segment of a request */
+} NoteI2CPacing;
+/*!
+ @typedef i2cPacingSaveFn
+
+ @brief The type for the hook that saves a calibrated I2C pacing.
+
+ The platform may store the pacing and apply it with `NoteSetI2CPacing` at
+ startup, rather than calibrating again.
+
+ @param pacing The pacing selected by calibration.
+ */
+typedef void (*i2cPacingSaveFn) (const NoteI2CPacing *pacing);
+/*!
+ @brief Set the pacing of data sent to the Notecard over I2C.
+
+ The default pacing pauses 6 ms before each I/O, 20 ms after each chunk and
+ 250 ms after every 250 bytes, which every Notecard model keeps up with. A
+ pause of 0 is skipped.
+
+ @param pacing The pacing to apply. It is copied. Pass NULL to restore the
+        default pacing.
+
+ @note This operation will lock Notecard access while in progress, if Notecard
+       mutex functions have been set.
+ */
+void NoteSetI2CPacing(const NoteI2CPacing *pacing);
+/*!
+ @brief Get the pacing of data sent to the Notecard over I2C.
+
+ @param pacing Pointer to store the current pacing.
+ */
+void NoteGetI2CPacing(NoteI2CPacing *pacing);
+/*!
+ @brief Find the fastest I2C pacing the connected Notecard keeps up with.
+
+ Starting with no pauses at all, each candidate pacing must carry
+ `NOTE_C_I2C_CALIBRATION_TRIALS` `echo` requests that span more than one
+ segment. On a failed round trip, such as a NACK or an `{io}` error, the
+ interface is reset and the pauses back off halfway towards the default
+ pacing, which is the last candidate. The first stable pacing is applied and
+ passed to `saveFn`.
+
+ @param saveFn The platform-specific function to save the selected pacing, or
+        NULL.
+
+ @returns `true` if a stable pacing was found, or `false` if I2C is not the
+          active interface or the Notecard failed even at the default pacing,
+          in which case the pacing in effect beforehand is restored.
+
+ @note This function exchanges a number of requests with the Notecard, and may
+       take several seconds.
+ */
+bool NoteCalibrateI2CPacing(i2cPacingSaveFn saveFn);
 /*!
  @brief Set the platform-specific I2C communication hook functions, address and MTU.
 
@@ -817,6 +1690,51 @@ void NoteGetI2CAddress(uint32_t *i2cAddr);
  @param [out] i2cMtu Pointer to store the current I2C MTU.
  */
 void NoteGetI2CMtu(uint32_t *i2cMtu);
+/*!
+ @brief Find and apply the largest I2C MTU that both the Notecard and the host
+        I2C driver handle reliably.
+
+ Starting from `NOTE_I2C_MTU_DEFAULT`, the MTU is doubled until `echo` round
+ trips fail or it reaches `NOTE_I2C_MTU_MAX`, and then narrowed down to
+ within `NOTE_C_I2C_MTU_PROBE_RESOLUTION` bytes of the smallest MTU that
+ failed. After each failure the interface is reset at the largest MTU that
+ worked.
+
+ @returns The MTU selected, which the platform may store and apply with
+          `NoteSetI2CMtu` at startup, or 0 if I2C is not the active interface
+          or the Notecard failed even at the default MTU, in which case the
+          MTU in effect beforehand is restored.
+
+ @note This function exchanges a number of requests with the Notecard, and may
+       take several seconds.
+ */
+uint32_t NoteProbeI2CMtu(void);
+/*!
+ @brief Share the I2C bus with other devices during exchanges with the
+        Notecard.
+
+ By default the I2C mutex is held for a whole exchange with the Notecard,
+ including the pauses while the Notecard processes a request, so other
+ devices on the bus may wait for seconds. In bus-sharing mode the I2C mutex
+ is instead taken and released around each chunk and each query, so other
+ devices wait for at most one I2C I/O. Exchanges with the Notecard are kept
+ whole by the Notecard mutex, which must therefore be set with
+ `NoteSetFnNoteMutex` if other threads use the Notecard.
+
+ @param enable `true` to release the I2C mutex between chunks, `false` to
+        hold it for each exchange (the default).
+
+ @note This operation will lock Notecard access while in progress, if Notecard
+       mutex functions have been set.
+ */
+void NoteSetI2CBusSharing(bool enable);
+/*!
+ @brief Get whether the I2C bus is shared with other devices during exchanges
+        with the Notecard.
+
+ @param [out] enabled Pointer to store whether bus-sharing mode is enabled.
+ */
+void NoteGetI2CBusSharing(bool *enabled);
 
 // The Notecard, whose default I2C address is below, uses a serial-to-i2c
 // protocol whose "byte count" must fit into a single byte and which must not
@@ -949,6 +1867,45 @@ void NoteDebugIntln(const char *msg, int n);
  @param ... Variable arguments for the format string.
  */
 void NoteDebugf(const char *format, ...);
+/*!
+ @brief Defer debug output, so that logging never waits on a slow debug port.
+
+ Once a buffer is set, debug output is copied into it rather than passed to the
+ debug output hook, and is written out when the application calls
+ `NoteDebugFlush`, typically from an idle task. Output that doesn't fit in the
+ buffer is dropped and counted by `NoteDebugDropped`.
+
+ Any task may write debug output while another flushes it. Output written
+ while another task is still copying its own output into the buffer is
+ dropped rather than waited for, and counted too. This relies on C11 atomics.
+ Where they're unavailable, or `NOTE_C_NO_ATOMICS` is defined, only one task
+ may write debug output while a buffer is set.
+
+ Any output already in the previous buffer is flushed before the new buffer is
+ used. This must not be called while debug output is being written or
+ flushed.
+
+ @param buffer The buffer for the deferred output, or NULL to write debug
+        output as soon as it is produced.
+ @param size The size of the buffer, in bytes.
+ */
+void NoteSetDebugBuffer(char *buffer, size_t size);
+/*!
+ @brief Write deferred debug output to the debug output hook.
+
+ This may run in a different task than the one performing Notecard
+ transactions, but only one task may flush at a time.
+
+ @returns The number of characters written.
+ */
+size_t NoteDebugFlush(void);
+/*!
+ @brief Get the number of debug messages dropped because the deferred output
+        buffer was full or in use by another task.
+
+ @returns The number of messages dropped.
+ */
+uint32_t NoteDebugDropped(void);
 
 #define NOTE_C_LOG_LEVEL_ERROR  0
 #define NOTE_C_LOG_LEVEL_WARN   1
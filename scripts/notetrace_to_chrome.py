@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Convert a note-c transaction trace into a Chrome trace.
+
+note-c built with NOTE_C_TRACE writes the trace ring to the debug output with
+NoteTraceDump(), one "notetrace TTTTTTTT YYYY AAAA" line per event. This script
+picks those lines out of a captured log and writes a Chrome trace, which can be
+opened in https://ui.perfetto.dev or chrome://tracing.
+
+    notetrace_to_chrome.py capture.log > trace.json
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+TXN_START = 1
+TXN_STOP = 2
+SEGMENT_TX = 3
+FIRST_RX = 4
+CRC_CHECK = 5
+RETRY = 6
+RESET = 7
+HEARTBEAT = 8
+
+INSTANT_EVENTS = {
+    SEGMENT_TX: ('segment tx', 'len'),
+    FIRST_RX: ('first rx', None),
+    CRC_CHECK: ('crc check', 'error'),
+    RETRY: ('retry', 'class'),
+    RESET: ('reset', 'success'),
+    HEARTBEAT: ('heartbeat', None),
+}
+
+RETRY_CLASSES = ['io', 'crc', 'bad-bin']
+
+LINE = re.compile(r'notetrace ([0-9A-Fa-f]{8}) ([0-9A-Fa-f]{4}) ([0-9A-Fa-f]{4})')
+
+
+def api_names(n_api_path):
+    """Read the API names, in table order, from n_api.c."""
+    try:
+        with open(n_api_path) as f:
+            source = f.read()
+    except OSError:
+        return []
+    table = source[source.find('noteApis[]'):]
+    table = table[:table.find('};')]
+    return re.findall(r'\{\s*"([^"]*)"', table)
+
+
+def read_events(lines):
+    """Parse the trace lines, unwrapping the 32-bit microsecond clock."""
+    events = []
+    offset = 0
+    last = None
+    for line in lines:
+        match = LINE.search(line)
+        if match is None:
+            continue
+        time_us, event_type, arg = (int(group, 16) for group in match.groups())
+        if last is not None and time_us < last:
+            offset += 1 << 32
+        last = time_us
+        events.append((time_us + offset, event_type, arg))
+    return events
+
+
+def chrome_trace(events, apis):
+    """Build the Chrome trace, pairing transaction starts and stops."""
+    trace = []
+    start = None
+    for time_us, event_type, arg in events:
+        if event_type == TXN_START:
+            name = apis[arg] if arg < len(apis) else 'unknown'
+            start = (time_us, name)
+        elif event_type == TXN_STOP:
+            if start is None:
+                continue
+            trace.append({
+                'name': start[1],
+                'cat': 'transaction',
+                'ph': 'X',
+                'ts': start[0],
+                'dur': time_us - start[0],
+                'pid': 1,
+                'tid': 1,
+                'args': {'error': bool(arg)},
+            })
+            start = None
+        elif event_type in INSTANT_EVENTS:
+            name, arg_name = INSTANT_EVENTS[event_type]
+            args = {}
+            if arg_name == 'class':
+                args[arg_name] = RETRY_CLASSES[arg] if arg < len(RETRY_CLASSES) else arg
+            elif arg_name is not None:
+                args[arg_name] = arg
+            trace.append({
+                'name': name,
+                'cat': 'transport',
+                'ph': 'i',
+                's': 't',
+                'ts': time_us,
+                'pid': 1,
+                'tid': 1,
+                'args': args,
+            })
+    return {'traceEvents': trace, 'displayTimeUnit': 'ms'}
+
+
+def main():
+    default_n_api = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'n_api.c')
+    parser = argparse.ArgumentParser(description='Convert a note-c transaction trace into a Chrome trace.')
+    parser.add_argument('log', nargs='?', help='captured debug output (default: stdin)')
+    parser.add_argument('--n-api', default=default_n_api, help='n_api.c, used to name the APIs')
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log) as f:
+            events = read_events(f)
+    else:
+        events = read_events(sys.stdin)
+
+    json.dump(chrome_trace(events, api_names(args.n_api)), sys.stdout, indent=1)
+    sys.stdout.write('\n')
+
+
+if __name__ == '__main__':
+    main()
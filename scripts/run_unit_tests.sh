@@ -1,6 +1,7 @@
 #!/bin/bash
 
 COVERAGE=0
+CRC32_SLICING=0
 HEARTBEAT_CALLBACK=0
 MEM_CHECK=0
 LOW_MEM=0
@@ -13,6 +14,7 @@ VERBOSE=0
 while [[ "$#" -gt 0 ]]; do
     case $1 in
         --coverage) COVERAGE=1 ;;
+        --crc32-slicing) CRC32_SLICING="$2"; shift ;;
         --heartbeat-callback) HEARTBEAT_CALLBACK=1 ;;
         --low-mem) LOW_MEM=1 ;;
         --mem-check) MEM_CHECK=1 ;;
@@ -46,6 +48,9 @@ if [[ $COVERAGE -eq 1 ]]; then
     CMAKE_OPTIONS="${CMAKE_OPTIONS} -DNOTE_C_COVERAGE:BOOL=ON"
     BUILD_OPTIONS="${BUILD_OPTIONS} coverage"
 fi
+if [[ $CRC32_SLICING -ne 0 ]]; then
+    CMAKE_OPTIONS="${CMAKE_OPTIONS} -DNOTE_C_CRC32_SLICING:STRING=${CRC32_SLICING}"
+fi
 if [[ $LOW_MEM -eq 1 ]]; then
     CMAKE_OPTIONS="${CMAKE_OPTIONS} -DNOTE_C_LOW_MEM:BOOL=ON"
 fi
@@ -0,0 +1,79 @@
+/*!
+ * @file crc32_benchmark.c
+ *
+ * Measures the throughput of the CRC32 implementation selected by
+ * NOTE_C_CRC32_SLICING over a range of buffer sizes.
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "n_lib.h"
+
+#ifndef NOTE_C_CRC32_SLICING
+#define NOTE_C_CRC32_SLICING 0
+#endif
+
+// Amount of data to checksum per buffer size, so each measurement takes a
+// comparable amount of time regardless of the buffer size.
+#define BYTES_PER_RUN (64UL * 1024UL * 1024UL)
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+int main(void)
+{
+    static const size_t sizes[] = {1024, 4096, 16384, 65536};
+    static const char check[] = "123456789";
+
+    // Verify the implementation before timing it
+    uint32_t crc = _crc32Compute(0, (const uint8_t *)check, sizeof(check) - 1);
+    if (crc != 0xCBF43926) {
+        fprintf(stderr, "crc32 (slicing %d): check value 0x%08lX, expected 0xCBF43926\n",
+                NOTE_C_CRC32_SLICING, (unsigned long)crc);
+        return 1;
+    }
+
+    uint8_t *buf = (uint8_t *)malloc(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+    if (buf == NULL) {
+        return 1;
+    }
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0 ; i < sizes[sizeof(sizes) / sizeof(sizes[0]) - 1] ; ++i) {
+        seed = (seed * 1103515245) + 12345;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+
+    for (size_t s = 0 ; s < sizeof(sizes) / sizeof(sizes[0]) ; ++s) {
+        size_t iterations = BYTES_PER_RUN / sizes[s];
+        crc = 0;
+        double start = nowSeconds();
+        for (size_t i = 0 ; i < iterations ; ++i) {
+            crc = _crc32Compute(crc, buf, sizes[s]);
+        }
+        double elapsed = nowSeconds() - start;
+        printf("crc32 slicing-%d %6zu bytes: %8.1f MB/s (crc 0x%08lX)\n",
+               NOTE_C_CRC32_SLICING, sizes[s],
+               ((double)BYTES_PER_RUN / (1024.0 * 1024.0)) / elapsed,
+               (unsigned long)crc);
+    }
+
+    free(buf);
+    return 0;
+}
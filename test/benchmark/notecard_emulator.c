@@ -0,0 +1,503 @@
+/*!
+ * @file notecard_emulator.c
+ *
+ * Emulates a Notecard behind the serial or I2C hooks, on a simulated clock.
+ *
+ * Bytes from the host land in an interrupt buffer of `bufferLen` bytes, which
+ * the Notecard processes at `drainBytesPerSec`. On serial, a byte that arrives
+ * to a full buffer is lost, and on I2C, a write that would not fit is NACKed,
+ * which is what the host's pacing delays protect against. Once a request has
+ * been processed, its response is ready `responseLatencyUs` later, and then
+ * takes the wire time of each byte to reach the host.
+ *
+ * Requests carrying a "crc" field are checked, and their responses carry one
+ * computed the same way, with the request's sequence number. A request resent
+ * with the sequence number of the last one is answered from the last response
+ * rather than executed again. Bit errors are injected in both directions from
+ * a seeded generator.
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "notecard_emulator.h"
+
+// The field replaces the closing brace with ,"crc":"SSSS:CCCCCCCC"}
+#define CRC_FIELD_LENGTH 22
+#define CRC_FIELD_NAME_TEST "\"crc\":\""
+
+// The time reported by `card.time` when the emulator begins, 2026-01-01
+#define EPOCH_SECS 1767225600UL
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t alloc;
+} emuBuffer;
+
+static emuConfig card;
+static emuStats stats;
+static uint64_t clockUs;
+static uint32_t prng;
+
+// The interrupt buffer
+static uint32_t fill;
+static uint64_t drainedUs;
+
+// The request being received, and the responses waiting for the host
+static emuBuffer line;
+static emuBuffer out;
+static size_t outOff;
+static uint64_t outReadyUs;
+static uint64_t nextByteUs;
+
+// The last request that carried a sequence number, and its response
+static bool lastValid;
+static uint16_t lastSeqno;
+static emuBuffer lastResponse;
+
+static uint32_t notes;
+
+static void bufAppend(emuBuffer *b, const void *data, size_t len)
+{
+    if (b->len + len > b->alloc) {
+        size_t alloc = (b->alloc ? b->alloc : 256);
+        while (alloc < b->len + len) {
+            alloc *= 2;
+        }
+        char *p = (char *)realloc(b->buf, alloc);
+        if (p == NULL) {
+            fprintf(stderr, "notecard emulator: out of memory\n");
+            exit(1);
+        }
+        b->buf = p;
+        b->alloc = alloc;
+    }
+    memcpy(&b->buf[b->len], data, len);
+    b->len += len;
+}
+
+static void bufFree(emuBuffer *b)
+{
+    free(b->buf);
+    b->buf = NULL;
+    b->len = 0;
+    b->alloc = 0;
+}
+
+// The standard reflected CRC-32, kept independent of the library's own
+static uint32_t crc32(const char *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0 ; i < len ; ++i) {
+        crc ^= (uint8_t)data[i];
+        for (int bit = 0 ; bit < 8 ; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t hexValue(const char *p, size_t len, bool *ok)
+{
+    uint32_t value = 0;
+    for (size_t i = 0 ; i < len ; ++i) {
+        const char c = p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= (uint32_t)(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            value |= (uint32_t)(c - 'A' + 10);
+        } else if (c >= 'a' && c <= 'f') {
+            value |= (uint32_t)(c - 'a' + 10);
+        } else {
+            *ok = false;
+        }
+    }
+    return value;
+}
+
+static uint32_t prngNext(void)
+{
+    prng ^= prng << 13;
+    prng ^= prng >> 17;
+    prng ^= prng << 5;
+    return prng;
+}
+
+// Flip a random bit of the byte, about once every `bitErrorInterval` bytes
+static uint8_t wireByte(uint8_t byte)
+{
+    if (card.bitErrorInterval && (prngNext() % card.bitErrorInterval) == 0) {
+        byte ^= (uint8_t)(1 << (prngNext() % 8));
+        stats.bitErrors++;
+    }
+    return byte;
+}
+
+// Microseconds on the wire for a number of bytes
+static uint64_t wireUs(uint32_t bytes)
+{
+    if (card.interface == NOTE_C_INTERFACE_I2C) {
+        return ((uint64_t)bytes * 9 * 1000000) / card.i2cClockHz;
+    }
+    return ((uint64_t)bytes * 10 * 1000000) / card.baudRate;
+}
+
+// Process the interrupt buffer up to the current time
+static void drain(void)
+{
+    const uint64_t drained = ((clockUs - drainedUs) * card.drainBytesPerSec) / 1000000;
+    if (drained == 0) {
+        return;
+    }
+    fill = ((fill > drained) ? (uint32_t)(fill - drained) : 0);
+    drainedUs += ((drained * 1000000) / card.drainBytesPerSec);
+    if (fill == 0) {
+        drainedUs = clockUs;
+    }
+}
+
+static void queueResponse(const char *json, size_t len)
+{
+    // The request is answered once everything in the buffer is processed
+    const uint64_t processedUs = drainedUs + (((uint64_t)fill * 1000000) / card.drainBytesPerSec);
+    const uint64_t readyUs = ((processedUs > clockUs) ? processedUs : clockUs) + card.responseLatencyUs;
+
+    if (outOff == out.len) {
+        out.len = 0;
+        outOff = 0;
+        outReadyUs = readyUs;
+        nextByteUs = readyUs + wireUs(1);
+    }
+    bufAppend(&out, json, len);
+    bufAppend(&out, "\r\n", 2);
+    stats.responses++;
+}
+
+static void queueError(const char *err)
+{
+    char json[128];
+    const int len = snprintf(json, sizeof(json), "{\"err\":\"%s\"}", err);
+    queueResponse(json, (size_t)len);
+}
+
+// Answer the API, returning NULL if it is not emulated
+static J *execute(const char *api, J *req)
+{
+    J *rsp = NULL;
+    const uint32_t nowSecs = (uint32_t)(EPOCH_SECS + (clockUs / 1000000));
+
+    if (strcmp(api, "echo") == 0) {
+        rsp = JDuplicate(req, true);
+        JDeleteItemFromObject(rsp, "req");
+        JDeleteItemFromObject(rsp, "cmd");
+        JDeleteItemFromObject(rsp, "id");
+    } else if (strcmp(api, "card.version") == 0) {
+        rsp = JCreateObject();
+        JAddStringToObject(rsp, "version", "notecard-emulator-1.0.0");
+        JAddStringToObject(rsp, "device", "dev:000000000000000");
+        JAddStringToObject(rsp, "name", "Blues Notecard Emulator");
+    } else if (strcmp(api, "card.time") == 0) {
+        rsp = JCreateObject();
+        JAddIntToObject(rsp, "time", nowSecs);
+        JAddStringToObject(rsp, "zone", "UTC,Etc/UTC");
+    } else if (strcmp(api, "card.status") == 0) {
+        rsp = JCreateObject();
+        JAddStringToObject(rsp, "status", "{normal}");
+        JAddIntToObject(rsp, "storage", 8);
+        JAddIntToObject(rsp, "time", nowSecs);
+    } else if (strcmp(api, "hub.status") == 0) {
+        rsp = JCreateObject();
+        JAddStringToObject(rsp, "status", "idle {disconnected}");
+    } else if (strcmp(api, "hub.sync") == 0) {
+        rsp = JCreateObject();
+    } else if (strcmp(api, "note.add") == 0) {
+        rsp = JCreateObject();
+        JAddIntToObject(rsp, "total", ++notes);
+    }
+
+    return rsp;
+}
+
+// Answer a complete request line, without its terminator
+static void request(char *json, size_t len)
+{
+    stats.requests++;
+    if (len && json[len-1] == '\r') {
+        len--;
+    }
+
+    // A bare newline is answered with one
+    if (len == 0) {
+        queueResponse("", 0);
+        return;
+    }
+
+    // Check and strip the CRC, restoring the closing brace it replaced
+    bool hasCrc = false;
+    uint16_t seqno = 0;
+    if (card.crc && len >= (CRC_FIELD_LENGTH + 2) && memcmp(&json[len - CRC_FIELD_LENGTH], CRC_FIELD_NAME_TEST, sizeof(CRC_FIELD_NAME_TEST) - 1) == 0) {
+        const char *field = &json[len - CRC_FIELD_LENGTH + sizeof(CRC_FIELD_NAME_TEST) - 1];
+        bool ok = (field[4] == ':');
+        seqno = (uint16_t)hexValue(field, 4, &ok);
+        const uint32_t crc = hexValue(&field[5], 8, &ok);
+        len -= CRC_FIELD_LENGTH;
+        json[len-1] = '}';
+        if (!ok || crc != crc32(json, len)) {
+            stats.crcErrors++;
+            queueError("CRC error {io}");
+            return;
+        }
+        hasCrc = true;
+    }
+    json[len] = '\0';
+
+    // The Notecard recognizes a resent request by its sequence number
+    if (hasCrc && lastValid && seqno == lastSeqno) {
+        stats.resends++;
+        queueResponse(lastResponse.buf, lastResponse.len);
+        return;
+    }
+
+    J *req = JParse(json);
+    if (req == NULL) {
+        stats.parseErrors++;
+        queueError("unrecognized request: invalid JSON {io}");
+        return;
+    }
+
+    const char *api = JGetString(req, "req");
+    const bool isCommand = (api[0] == '\0');
+    if (isCommand) {
+        api = JGetString(req, "cmd");
+    }
+    J *rsp = execute(api, req);
+    if (isCommand) {
+        JDelete(rsp);
+        JDelete(req);
+        return;
+    }
+    if (rsp == NULL) {
+        JDelete(req);
+        queueError("unknown request {not-supported}");
+        return;
+    }
+    if (JIsPresent(req, "id")) {
+        JAddIntToObject(rsp, "id", JGetInt(req, "id"));
+    }
+    JDelete(req);
+
+    char *text = JPrintUnformatted(rsp);
+    JDelete(rsp);
+    if (text == NULL) {
+        queueError("out of memory {io}");
+        return;
+    }
+
+    // Protect the response with the request's sequence number
+    lastResponse.len = 0;
+    size_t textLen = strlen(text);
+    if (hasCrc) {
+        char field[CRC_FIELD_LENGTH + 2];
+        snprintf(field, sizeof(field), "%c\"crc\":\"%04X:%08lX\"}",
+                 (memchr(text, ':', textLen) == NULL) ? ' ' : ',',
+                 seqno, (unsigned long)crc32(text, textLen));
+        bufAppend(&lastResponse, text, textLen - 1);
+        bufAppend(&lastResponse, field, CRC_FIELD_LENGTH + 1);
+        lastValid = true;
+        lastSeqno = seqno;
+    } else {
+        bufAppend(&lastResponse, text, textLen);
+    }
+    JFree(text);
+
+    queueResponse(lastResponse.buf, lastResponse.len);
+}
+
+// A byte that made it into the interrupt buffer
+static void receive(uint8_t byte)
+{
+    stats.bytesIn++;
+    byte = wireByte(byte);
+    if (byte != '\n') {
+        bufAppend(&line, &byte, 1);
+        return;
+    }
+
+    // Room for the terminator that `request` writes in place
+    bufAppend(&line, "", 1);
+    request(line.buf, line.len - 1);
+    line.len = 0;
+}
+
+static bool outReady(void)
+{
+    return (outOff < out.len && clockUs >= outReadyUs);
+}
+
+static uint8_t deliver(void)
+{
+    stats.bytesOut++;
+    return wireByte((uint8_t)out.buf[outOff++]);
+}
+
+static uint32_t simGetMs(void)
+{
+    clockUs += card.hostCallUs;
+    return (uint32_t)(clockUs / 1000);
+}
+
+static void simDelayMs(uint32_t ms)
+{
+    clockUs += ((uint64_t)ms * 1000);
+}
+
+static bool serialReset(void)
+{
+    // Whatever the host's UART had received is lost
+    outOff = out.len;
+    return true;
+}
+
+static void serialTransmit(uint8_t *buf, size_t len, bool flush)
+{
+    (void)flush;
+    for (size_t i = 0 ; i < len ; ++i) {
+        clockUs += wireUs(1);
+        drain();
+        if (fill == card.bufferLen) {
+            stats.overruns++;
+            continue;
+        }
+        fill++;
+        stats.peakFill = ((fill > stats.peakFill) ? fill : stats.peakFill);
+        receive(buf[i]);
+    }
+}
+
+static bool serialAvailable(void)
+{
+    clockUs += card.hostCallUs;
+    return (outReady() && clockUs >= nextByteUs);
+}
+
+static char serialReceive(void)
+{
+    clockUs += card.hostCallUs;
+    if (!outReady() || clockUs < nextByteUs) {
+        return '\0';
+    }
+    nextByteUs += wireUs(1);
+    return (char)deliver();
+}
+
+static bool i2cReset(uint16_t address)
+{
+    (void)address;
+    return true;
+}
+
+// A write carries the address and a length byte ahead of the data
+static const char *i2cTransmit(uint16_t address, uint8_t *buf, uint16_t size)
+{
+    (void)address;
+    clockUs += card.hostCallUs + wireUs(2 + (uint32_t)size);
+    drain();
+    if (size > card.i2cMaxChunk || (fill + size) > card.bufferLen) {
+        stats.nacks++;
+        return "i2c: received NACK on transmit of data {io}";
+    }
+    fill += size;
+    stats.peakFill = ((fill > stats.peakFill) ? fill : stats.peakFill);
+    for (uint16_t i = 0 ; i < size ; ++i) {
+        receive(buf[i]);
+    }
+    return NULL;
+}
+
+// A read is a write of the requested length, then a read of the address, two
+// header bytes and the data
+static const char *i2cReceive(uint16_t address, uint8_t *buf, uint16_t size, uint32_t *available)
+{
+    (void)address;
+    clockUs += card.hostCallUs + wireUs(3) + wireUs(3 + (uint32_t)size);
+    const uint32_t pending = (outReady() ? (uint32_t)(out.len - outOff) : 0);
+    if (size > pending) {
+        *available = 0;
+        return "i2c: requested more than available {io}";
+    }
+    for (uint16_t i = 0 ; i < size ; ++i) {
+        buf[i] = deliver();
+    }
+    *available = pending - size;
+    return NULL;
+}
+
+void emuBegin(const emuConfig *config)
+{
+    card = *config;
+    memset(&stats, 0, sizeof(stats));
+    clockUs = 0;
+    prng = (card.seed ? card.seed : 1);
+    fill = 0;
+    drainedUs = 0;
+    line.len = 0;
+    out.len = 0;
+    outOff = 0;
+    outReadyUs = 0;
+    nextByteUs = 0;
+    lastValid = false;
+    lastResponse.len = 0;
+    notes = 0;
+
+    NoteSetFnDefault(malloc, free, simDelayMs, simGetMs);
+    if (card.interface == NOTE_C_INTERFACE_I2C) {
+        NoteSetFnI2C(NOTE_I2C_ADDR_DEFAULT, NOTE_I2C_MTU_DEFAULT, i2cReset, i2cTransmit, i2cReceive);
+    } else {
+        NoteSetFnSerial(serialReset, serialTransmit, serialAvailable, serialReceive);
+    }
+}
+
+void emuEnd(void)
+{
+    bufFree(&line);
+    bufFree(&out);
+    bufFree(&lastResponse);
+}
+
+void emuInjectBitErrors(uint32_t interval)
+{
+    card.bitErrorInterval = interval;
+}
+
+void emuGetStats(emuStats *s)
+{
+    *s = stats;
+}
+
+uint64_t emuNowUs(void)
+{
+    return clockUs;
+}
+
+bool emuWaitForData(uint32_t timeoutMs)
+{
+    const uint64_t deadlineUs = clockUs + ((uint64_t)timeoutMs * 1000);
+    if (outOff < out.len && outReadyUs <= deadlineUs) {
+        clockUs = ((outReadyUs > clockUs) ? outReadyUs : clockUs);
+        return true;
+    }
+    clockUs = deadlineUs;
+    return false;
+}
@@ -0,0 +1,108 @@
+/*!
+ * @file notecard_emulator.h
+ *
+ * A deterministic Notecard emulator that plugs into the serial or I2C hooks,
+ * so that changes to the transport, pacing and retry logic can be measured
+ * without hardware.
+ *
+ * The emulator owns a simulated clock, which it installs as the delay and
+ * millisecond hooks, and which advances only as bytes cross the emulated wire,
+ * as the host delays and, by a small fixed cost, each time the host calls a
+ * hook. Every run with the same configuration produces the same results.
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#ifndef NOTECARD_EMULATOR_H
+#define NOTECARD_EMULATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "note.h"
+
+/*!
+ @brief The emulated Notecard and the wire it is attached by.
+ */
+typedef struct {
+    int interface;                  /*!< NOTE_C_INTERFACE_SERIAL or NOTE_C_INTERFACE_I2C */
+    uint32_t baudRate;              /*!< Serial line rate, 10 bit times per byte */
+    uint32_t i2cClockHz;            /*!< I2C clock, 9 clocks per byte */
+    uint32_t i2cMaxChunk;           /*!< Largest I2C write accepted, larger writes are NACKed */
+    uint32_t bufferLen;             /*!< Size of the interrupt buffer requests land in */
+    uint32_t drainBytesPerSec;      /*!< Rate at which the buffer is processed */
+    uint32_t responseLatencyUs;     /*!< Time to answer a request once it has been processed */
+    uint32_t bitErrorInterval;      /*!< Mean bytes between injected bit errors, 0 for none */
+    uint32_t seed;                  /*!< Seed for the injected bit errors */
+    uint32_t hostCallUs;            /*!< Time charged for each call into a hook */
+    bool crc;                       /*!< Whether requests and responses are protected by CRC */
+} emuConfig;
+
+/*!
+ @brief What the emulated Notecard saw, since `emuBegin`.
+ */
+typedef struct {
+    uint32_t requests;              /*!< Request lines received, including bare newlines */
+    uint32_t responses;             /*!< Responses queued for the host */
+    uint32_t resends;               /*!< Requests recognized as resent, by sequence number */
+    uint32_t overruns;              /*!< Serial bytes dropped because the buffer was full */
+    uint32_t nacks;                 /*!< I2C writes refused because the buffer was full or they were too long */
+    uint32_t crcErrors;             /*!< Requests that failed their CRC */
+    uint32_t parseErrors;           /*!< Requests that were not valid JSON */
+    uint32_t bitErrors;             /*!< Bit errors injected, in either direction */
+    uint32_t peakFill;              /*!< Highest fill of the interrupt buffer */
+    uint64_t bytesIn;               /*!< Payload bytes received from the host */
+    uint64_t bytesOut;              /*!< Payload bytes delivered to the host */
+} emuStats;
+
+/*!
+ @brief Reset the emulator and install it as the clock and the hooks of the
+        configured interface.
+
+ The memory hooks are set to `malloc` and `free`. The emulator answers
+ `echo`, `card.version`, `card.time`, `card.status`, `hub.status`, `hub.sync`
+ and `note.add`, and answers any other request with an error.
+
+ @param config The emulated Notecard. It is copied.
+ */
+void emuBegin(const emuConfig *config);
+
+/*!
+ @brief Release what the emulator allocated.
+ */
+void emuEnd(void);
+
+/*!
+ @brief Change how often bit errors are injected, without resetting the
+        emulator.
+
+ @param interval Mean bytes between bit errors, 0 for none.
+ */
+void emuInjectBitErrors(uint32_t interval);
+
+/*!
+ @brief Get what the emulated Notecard has seen.
+
+ @param stats Pointer to store the statistics.
+ */
+void emuGetStats(emuStats *stats);
+
+/*!
+ @brief The simulated time, in microseconds since `emuBegin`.
+ */
+uint64_t emuNowUs(void);
+
+/*!
+ @brief A data-ready hook for `NoteSetFnWaitForData`, which signals as soon as
+        a response is ready, like the Notecard's ATTN pin.
+ */
+bool emuWaitForData(uint32_t timeoutMs);
+
+#endif // NOTECARD_EMULATOR_H
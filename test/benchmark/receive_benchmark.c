@@ -0,0 +1,172 @@
+/*!
+ * @file receive_benchmark.c
+ *
+ * Measures the time to receive a large response from an emulated serial
+ * Notecard and print it back to JSON, with the buffer growth policy selected
+ * by NOTE_C_ALLOC_GROWTH_GEOMETRIC, with and without a reallocation hook.
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "n_lib.h"
+
+// Size of the emulated `note.changes` response
+#define RESPONSE_LEN (32UL * 1024UL)
+
+#define ITERATIONS 200
+
+static char *response;
+static size_t responseLen;
+static size_t responseOff;
+static unsigned long allocations;
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void *countingMalloc(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void *countingRealloc(void *ptr, size_t size)
+{
+    allocations++;
+    return realloc(ptr, size);
+}
+
+static uint32_t benchGetMs(void)
+{
+    return (uint32_t)(nowSeconds() * 1000);
+}
+
+static void benchDelayMs(uint32_t ms)
+{
+    (void)ms;
+}
+
+static bool benchSerialReset(void)
+{
+    return true;
+}
+
+// Each request is answered with the whole response
+static void benchSerialTransmit(uint8_t *buf, size_t len, bool flush)
+{
+    (void)buf;
+    (void)len;
+    (void)flush;
+    responseOff = 0;
+}
+
+static bool benchSerialAvailable(void)
+{
+    return (responseOff < responseLen);
+}
+
+static char benchSerialReceive(void)
+{
+    return response[responseOff++];
+}
+
+static size_t benchSerialAvailableCount(void)
+{
+    return (responseLen - responseOff);
+}
+
+static bool benchSerialReceiveBuffer(uint8_t *buf, size_t max, size_t *got)
+{
+    *got = (((responseLen - responseOff) < max) ? (responseLen - responseOff) : max);
+    memcpy(buf, &response[responseOff], *got);
+    responseOff += *got;
+    return true;
+}
+
+static int run(const char *name, reallocFn reallocHook)
+{
+    static const char request[] = "{\"req\":\"note.changes\"}";
+
+    NoteSetFnRealloc(reallocHook);
+    allocations = 0;
+    double receiveSeconds = 0;
+    double printSeconds = 0;
+    for (int i = 0 ; i < ITERATIONS ; ++i) {
+        char *rsp = NULL;
+        double start = nowSeconds();
+        const char *err = _serialNoteTransaction(request, sizeof(request) - 1, &rsp, 1000);
+        receiveSeconds += (nowSeconds() - start);
+        if (err != NULL || rsp == NULL || strlen(rsp) != responseLen) {
+            fprintf(stderr, "%s: receive failed\n", name);
+            return 1;
+        }
+
+        J *obj = JParse(rsp);
+        NoteFree(rsp);
+        if (obj == NULL) {
+            fprintf(stderr, "%s: parse failed\n", name);
+            return 1;
+        }
+        start = nowSeconds();
+        char *json = JPrintUnformatted(obj);
+        printSeconds += (nowSeconds() - start);
+        JDelete(obj);
+        if (json == NULL) {
+            fprintf(stderr, "%s: print failed\n", name);
+            return 1;
+        }
+        NoteFree(json);
+    }
+
+    printf("growth %-9s %-14s %6lu bytes: receive %7.1f us, print %7.1f us, %lu allocations\n",
+           (NOTE_C_ALLOC_GROWTH_GEOMETRIC ? "geometric" : "linear"), name,
+           (unsigned long)responseLen, (receiveSeconds * 1e6) / ITERATIONS,
+           (printSeconds * 1e6) / ITERATIONS, allocations / ITERATIONS);
+    return 0;
+}
+
+int main(void)
+{
+    // A response of many small notes, as `note.changes` returns
+    response = (char *)malloc(RESPONSE_LEN + 64);
+    if (response == NULL) {
+        return 1;
+    }
+    responseLen = (size_t)sprintf(response, "{\"changes\":0,\"notes\":{");
+    for (int note = 0 ; responseLen < RESPONSE_LEN ; ++note) {
+        responseLen += (size_t)sprintf(&response[responseLen], "%s\"%d\":{\"body\":{\"temp\":%d.5},\"time\":%d}",
+                                       (note ? "," : ""), note, note % 100, 1700000000 + note);
+    }
+    responseLen += (size_t)sprintf(&response[responseLen], "}}\r\n");
+
+    NoteSetFnDefault(countingMalloc, free, benchDelayMs, benchGetMs);
+    NoteSetFnSerial(benchSerialReset, benchSerialTransmit, benchSerialAvailable, benchSerialReceive);
+    NoteSetFnSerialReceiveBuffer(benchSerialAvailableCount, benchSerialReceiveBuffer);
+    NoteSetSerialPacing(&(NoteSerialPacing) {
+        0, 0, 0, true
+    });
+
+    int failures = 0;
+    failures += run("malloc/copy", NULL);
+    failures += run("realloc hook", countingRealloc);
+
+    free(response);
+    return (failures != 0);
+}
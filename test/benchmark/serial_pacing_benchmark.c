@@ -0,0 +1,159 @@
+/*!
+ * @file serial_pacing_benchmark.c
+ *
+ * Compares the throughput of the default serial pacing with pacing derived
+ * from the baud rate and the Notecard's drain rate, by transmitting to an
+ * emulated Notecard on a simulated clock, and checks that the emulated
+ * Notecard's receive buffer is never overrun.
+ *
+ * Only the 1000 B/s drain rate and 250 B buffer are documented Notecard
+ * limits. The faster cards are hypothetical, and show what configuring the
+ * pacing would gain if a Notecard were specified to drain that fast.
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "n_lib.h"
+
+// Amount of data to send in each run, about the size of a large binary upload
+#define BYTES_PER_RUN (40UL * 1024UL)
+
+// The emulated Notecard
+typedef struct {
+    const char *name;
+    uint32_t baudRate;
+    uint32_t drainBytesPerSec;
+    uint32_t bufferLen;
+} emulatedNotecard;
+
+static emulatedNotecard card;
+static uint64_t clockUs;
+static uint64_t drainedUs;
+static uint32_t fill;
+static uint32_t peakFill;
+static uint32_t overruns;
+
+// Drain the emulated Notecard's buffer up to the current time
+static void cardDrain(void)
+{
+    const uint64_t drained = ((clockUs - drainedUs) * card.drainBytesPerSec) / 1000000;
+    if (drained == 0) {
+        return;
+    }
+    fill = ((fill > drained) ? (uint32_t)(fill - drained) : 0);
+    drainedUs += ((drained * 1000000) / card.drainBytesPerSec);
+    if (fill == 0) {
+        drainedUs = clockUs;
+    }
+}
+
+static uint32_t simGetMs(void)
+{
+    return (uint32_t)(clockUs / 1000);
+}
+
+static void simDelayMs(uint32_t ms)
+{
+    clockUs += ((uint64_t)ms * 1000);
+}
+
+static bool simSerialReset(void)
+{
+    return true;
+}
+
+// Each byte takes ten bit times on the wire, and lands in the Notecard's buffer
+static void simSerialTransmit(uint8_t *buf, size_t len, bool flush)
+{
+    (void)buf;
+    (void)flush;
+    for (size_t i = 0 ; i < len ; ++i) {
+        clockUs += (10000000ULL / card.baudRate);
+        cardDrain();
+        if (fill == card.bufferLen) {
+            overruns++;
+        } else {
+            fill++;
+        }
+        peakFill = ((fill > peakFill) ? fill : peakFill);
+    }
+}
+
+static bool simSerialAvailable(void)
+{
+    return false;
+}
+
+static char simSerialReceive(void)
+{
+    return '\0';
+}
+
+static int run(const char *pacingName, const NoteSerialPacing *pacing, const uint8_t *data)
+{
+    clockUs = 0;
+    drainedUs = 0;
+    fill = 0;
+    peakFill = 0;
+    overruns = 0;
+    NoteSetSerialPacing(pacing);
+
+    if (_serialChunkedTransmit(data, BYTES_PER_RUN, true) != NULL) {
+        fprintf(stderr, "%s, %s pacing: transmit failed\n", card.name, pacingName);
+        return 1;
+    }
+
+    const double seconds = ((double)clockUs / 1e6);
+    printf("%-50s %-8s pacing: %6.2f s, %8.1f bytes/s, peak fill %4lu/%-4lu, %lu overruns\n",
+           card.name, pacingName, seconds, (double)BYTES_PER_RUN / seconds,
+           (unsigned long)peakFill, (unsigned long)card.bufferLen, (unsigned long)overruns);
+    return (overruns != 0);
+}
+
+int main(void)
+{
+    static const emulatedNotecard cards[] = {
+        {"115200 baud, 1000 B/s, 250 B buffer", 115200, 1000, 250},
+        {"115200 baud, 4000 B/s, 250 B buffer (hypothetical)", 115200, 4000, 250},
+        {"115200 baud, 8000 B/s, 1 KB buffer (hypothetical)", 115200, 8000, 1024},
+        {"9600 baud, 1000 B/s, 250 B buffer", 9600, 1000, 250},
+    };
+
+    uint8_t *data = (uint8_t *)malloc(BYTES_PER_RUN);
+    if (data == NULL) {
+        return 1;
+    }
+    memset(data, 'a', BYTES_PER_RUN);
+
+    NoteSetFnDefault(malloc, free, simDelayMs, simGetMs);
+    NoteSetFnSerial(simSerialReset, simSerialTransmit, simSerialAvailable, simSerialReceive);
+
+    int failures = 0;
+    for (size_t c = 0 ; c < sizeof(cards) / sizeof(cards[0]) ; ++c) {
+        card = cards[c];
+
+        failures += run("default", NULL, data);
+
+        const NoteSerialPacing derived = {
+            card.baudRate,
+            card.drainBytesPerSec,
+            (uint16_t)card.bufferLen,
+            false
+        };
+        failures += run("derived", &derived, data);
+    }
+
+    free(data);
+    return (failures != 0);
+}
@@ -0,0 +1,210 @@
+/*!
+ * @file transport_benchmark.c
+ *
+ * Measures request throughput over serial and I2C against the Notecard
+ * emulator, with the default transport settings and with the ones the library
+ * can derive or calibrate, and with bit errors injected on the wire, so that
+ * changes to the transport, pacing and retry logic can be compared run to run.
+ *
+ * Only the 1000 B/s drain rate and 250 B buffer of the serial Notecard are
+ * documented limits. The faster serial Notecard and the I2C Notecard are
+ * hypothetical, and show what deriving or calibrating the pacing and probing
+ * the MTU gain on a card that can keep up.
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "n_lib.h"
+#include "notecard_emulator.h"
+
+// Requests in each run, and the length of the text each one echoes
+#define REQUESTS 50
+#define TEXT_LEN 500
+
+// Mean bytes between bit errors, when they are injected
+#define BIT_ERROR_INTERVAL 4000
+
+typedef enum {
+    TUNE_NONE,          // Default pacing and MTU, polled
+    TUNE_ATTN,          // As above, waiting on the data-ready hook
+    TUNE_DERIVED,       // Serial pacing derived from the card's limits
+    TUNE_CALIBRATED,    // I2C pacing calibrated and MTU probed, with the hook
+} tuning;
+
+typedef struct {
+    const char *name;
+    emuConfig card;
+    tuning tune;
+    bool bitErrors;
+} scenario;
+
+// Distinct text for each request, so that each CRC differs
+static void makeText(char *text, int request)
+{
+    uint32_t x = (uint32_t)(request + 1) * 2654435761u;
+    for (size_t i = 0 ; i < TEXT_LEN ; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        text[i] = (char)('a' + (x % 26));
+    }
+    text[TEXT_LEN] = '\0';
+}
+
+static bool echo(const char *text, bool *corrupt)
+{
+    J *req = NoteNewRequest("echo");
+    if (req == NULL) {
+        return false;
+    }
+    JAddStringToObject(req, "text", text);
+    J *rsp = NoteRequestResponse(req);
+    if (rsp == NULL) {
+        return false;
+    }
+    const bool ok = !NoteResponseError(rsp);
+    *corrupt = (ok && strcmp(JGetString(rsp, "text"), text) != 0);
+    NoteDeleteResponse(rsp);
+    return ok;
+}
+
+static int run(const scenario *s)
+{
+    emuBegin(&s->card);
+    NoteSetSerialPacing(NULL);
+    NoteSetI2CPacing(NULL);
+    NoteSetFnWaitForData(NULL);
+
+    // Tune the transport on a clean line, then synchronize with a first echo
+    char text[TEXT_LEN + 1];
+    bool corrupt = false;
+    if (s->tune == TUNE_DERIVED) {
+        const NoteSerialPacing derived = {
+            s->card.baudRate,
+            s->card.drainBytesPerSec,
+            (uint16_t)s->card.bufferLen,
+            false
+        };
+        NoteSetSerialPacing(&derived);
+    }
+    if (s->tune == TUNE_ATTN || s->tune == TUNE_CALIBRATED) {
+        NoteSetFnWaitForData(emuWaitForData);
+    }
+    makeText(text, -1);
+    if (!echo(text, &corrupt)) {
+        fprintf(stderr, "%s: the emulated Notecard did not answer\n", s->name);
+        emuEnd();
+        return 1;
+    }
+    if (s->tune == TUNE_CALIBRATED && (NoteProbeI2CMtu() == 0 || !NoteCalibrateI2CPacing(NULL))) {
+        fprintf(stderr, "%s: calibration failed\n", s->name);
+        emuEnd();
+        return 1;
+    }
+
+    emuStats before;
+    emuGetStats(&before);
+    const uint64_t startUs = emuNowUs();
+    emuInjectBitErrors(s->bitErrors ? BIT_ERROR_INTERVAL : 0);
+
+    uint32_t failed = 0;
+    uint32_t corrupted = 0;
+    for (int i = 0 ; i < REQUESTS ; ++i) {
+        makeText(text, i);
+        if (!echo(text, &corrupt)) {
+            failed++;
+        }
+        corrupted += corrupt;
+    }
+
+    const double seconds = ((double)(emuNowUs() - startUs) / 1e6);
+    emuStats after;
+    emuGetStats(&after);
+    emuEnd();
+
+    printf("%-50s %6.2f s, %5.1f req/s, %7.1f bytes/s, %3lu lines received, %3lu overruns, %3lu NACKs, %3lu bit errors, %lu/%d failed, %lu corrupt\n",
+           s->name, seconds, (double)REQUESTS / seconds,
+           (double)((after.bytesIn - before.bytesIn) + (after.bytesOut - before.bytesOut)) / seconds,
+           (unsigned long)(after.requests - before.requests),
+           (unsigned long)(after.overruns - before.overruns),
+           (unsigned long)(after.nacks - before.nacks),
+           (unsigned long)(after.bitErrors - before.bitErrors),
+           (unsigned long)failed, REQUESTS, (unsigned long)corrupted);
+    if (s->tune == TUNE_CALIBRATED && !s->bitErrors) {
+        uint32_t mtu = 0;
+        NoteGetI2CMtu(&mtu);
+        NoteI2CPacing pacing;
+        NoteGetI2CPacing(&pacing);
+        printf("%-50s MTU %lu, pauses %u/%u/%u ms, segment %u B\n", "",
+               (unsigned long)mtu, pacing.ioDelayMs, pacing.chunkDelayMs,
+               pacing.segmentDelayMs, pacing.segmentLen);
+    }
+
+    // Only bit errors excuse a failed request, and nothing may go unnoticed
+    return ((failed && !s->bitErrors) || corrupted);
+}
+
+int main(void)
+{
+    static const emuConfig serialCard = {
+        .interface = NOTE_C_INTERFACE_SERIAL,
+        .baudRate = 115200,
+        .bufferLen = 250,
+        .drainBytesPerSec = 1000,
+        .responseLatencyUs = 50000,
+        .seed = 1,
+        .hostCallUs = 1,
+        .crc = true,
+    };
+    static const emuConfig fastSerialCard = {
+        .interface = NOTE_C_INTERFACE_SERIAL,
+        .baudRate = 115200,
+        .bufferLen = 250,
+        .drainBytesPerSec = 4000,
+        .responseLatencyUs = 50000,
+        .seed = 1,
+        .hostCallUs = 1,
+        .crc = true,
+    };
+    static const emuConfig i2cCard = {
+        .interface = NOTE_C_INTERFACE_I2C,
+        .i2cClockHz = 100000,
+        .i2cMaxChunk = 128,
+        .bufferLen = 512,
+        .drainBytesPerSec = 8000,
+        .responseLatencyUs = 50000,
+        .seed = 1,
+        .hostCallUs = 1,
+        .crc = true,
+    };
+    const scenario scenarios[] = {
+        {"serial 115200, default pacing", serialCard, TUNE_NONE, false},
+        {"serial 115200, derived pacing", serialCard, TUNE_DERIVED, false},
+        {"serial 115200, derived pacing, bit errors", serialCard, TUNE_DERIVED, true},
+        {"serial 115200, 4000 B/s (hypothetical), default", fastSerialCard, TUNE_NONE, false},
+        {"serial 115200, 4000 B/s (hypothetical), derived", fastSerialCard, TUNE_DERIVED, false},
+        {"i2c 100 kHz (hypothetical), default", i2cCard, TUNE_NONE, false},
+        {"i2c 100 kHz (hypothetical), ATTN", i2cCard, TUNE_ATTN, false},
+        {"i2c 100 kHz (hypothetical), calibrated", i2cCard, TUNE_CALIBRATED, false},
+        {"i2c 100 kHz (hypothetical), calibrated, bit errors", i2cCard, TUNE_CALIBRATED, true},
+    };
+
+    int failures = 0;
+    for (size_t i = 0 ; i < sizeof(scenarios) / sizeof(scenarios[0]) ; ++i) {
+        failures += run(&scenarios[i]);
+    }
+    NoteSetI2CMtu(0);
+
+    return (failures != 0);
+}
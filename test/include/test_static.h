@@ -16,14 +16,19 @@ extern "C" {
 extern bool resetRequired;
 
 // Make these normally static functions externally visible if building tests.
+uint32_t _crc32Update(uint32_t crc, const void* data, size_t length);
 char *_crcAdd(char *json, uint16_t seqno);
+size_t _crcAppend(char *json, size_t jsonLen, size_t bufLen, uint16_t seqno);
+size_t _crcAppendField(char *json, size_t jsonLen, size_t bufLen, uint16_t seqno, uint32_t crc, bool isEmptyObject);
 bool _crcError(char *json, uint16_t shouldBeSeqno);
 void _delayIO(void);
 J * _errDoc(uint32_t id, const char *errmsg);
 const char * _i2cNoteQueryLength(uint32_t * available, uint32_t timeoutMs);
+void _i2cWaitForData(uint32_t startMs, uint32_t timeoutMs, uint32_t *pollMs);
 char _j_tolower(char c);
+int _noteJSONScanKey(const char *json, size_t jsonLen, const char *key, const char **value, size_t *valueLen);
 void _noteSetActiveInterface(int interface);
-uint32_t _noteTransaction_calculateTimeoutMs(J *req, bool isReq);
+uint32_t _noteTransaction_calculateTimeoutMs(J *req, uint8_t apiFlags);
 unsigned char *_print(const J * const item, Jbool format, Jbool omitempty);
 void _setTime(JTIME seconds);
 bool _timerExpiredSecs(uint32_t *timer, uint32_t periodSecs);
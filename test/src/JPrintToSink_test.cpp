@@ -0,0 +1,113 @@
+/*!
+ * @file JPrintToSink_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "n_lib.h"
+
+#include <string>
+
+namespace
+{
+
+struct Sink {
+    std::string output;
+    size_t segments;
+    size_t maxSegment;
+    size_t failAfter;
+};
+
+Jbool collect(void *context, const char *data, size_t length)
+{
+    Sink *sink = static_cast<Sink *>(context);
+    if (sink->failAfter && sink->segments >= sink->failAfter) {
+        return false;
+    }
+    sink->output.append(data, length);
+    sink->segments++;
+    sink->maxSegment = (length > sink->maxSegment) ? length : sink->maxSegment;
+    return true;
+}
+
+SCENARIO("JPrintToSink")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+
+    Sink sink = {"", 0, 0, 0};
+    char buf[32];
+
+    GIVEN("A JSON object larger than the buffer") {
+        J *jsonObj = JParse("{"
+                            "\"req\": \"note.add\","
+                            "\"body\": {\"temp\": 21.5, \"ok\": true, \"none\": null,"
+                            "\"list\": [1, \"two\", false]},"
+                            "\"payload\": \"this string is much longer than the print buffer\\n\\t\\u0001\""
+                            "}");
+        REQUIRE(jsonObj != NULL);
+        char *expected = JPrintUnformatted(jsonObj);
+        REQUIRE(expected != NULL);
+
+        WHEN("JPrintToSink is called on that object") {
+            const int tailLen = JPrintToSink(jsonObj, buf, sizeof(buf), false, collect, &sink);
+
+            THEN("The segments and the final segment reproduce JPrintUnformatted") {
+                REQUIRE(tailLen > 0);
+                CHECK(tailLen < (int)sizeof(buf));
+                CHECK(buf[tailLen] == '\0');
+                CHECK(buf[tailLen - 1] == '}');
+                CHECK(sink.segments > 1);
+                CHECK(sink.maxSegment < sizeof(buf));
+                CHECK(sink.output + buf == expected);
+            }
+        }
+
+        WHEN("The sink fails") {
+            sink.failAfter = 1;
+
+            THEN("Printing fails") {
+                CHECK(JPrintToSink(jsonObj, buf, sizeof(buf), false, collect, &sink) == -1);
+            }
+        }
+
+        JFree(expected);
+        JDelete(jsonObj);
+    }
+
+    GIVEN("A JSON object that fits in the buffer") {
+        J *jsonObj = JCreateObject();
+        REQUIRE(jsonObj != NULL);
+        JAddStringToObject(jsonObj, "req", "card.version");
+
+        THEN("Nothing is passed to the sink") {
+            CHECK(JPrintToSink(jsonObj, buf, sizeof(buf), false, collect, &sink) == (int)strlen("{\"req\":\"card.version\"}"));
+            CHECK(strcmp(buf, "{\"req\":\"card.version\"}") == 0);
+            CHECK(sink.segments == 0);
+        }
+
+        JDelete(jsonObj);
+    }
+
+    GIVEN("Invalid parameters") {
+        J *jsonObj = JCreateObject();
+        REQUIRE(jsonObj != NULL);
+
+        CHECK(JPrintToSink(NULL, buf, sizeof(buf), false, collect, &sink) == -1);
+        CHECK(JPrintToSink(jsonObj, NULL, sizeof(buf), false, collect, &sink) == -1);
+        CHECK(JPrintToSink(jsonObj, buf, 4, false, collect, &sink) == -1);
+        CHECK(JPrintToSink(jsonObj, buf, sizeof(buf), false, NULL, &sink) == -1);
+
+        JDelete(jsonObj);
+    }
+}
+
+}
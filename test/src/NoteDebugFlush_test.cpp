@@ -0,0 +1,162 @@
+/*!
+ * @file NoteDebugFlush_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "n_lib.h"
+
+namespace
+{
+
+std::string debugOutput;
+size_t debugOutputCalls = 0;
+
+size_t debugOutputCapture(const char *text)
+{
+    debugOutputCalls++;
+    debugOutput += text;
+    return strlen(text);
+}
+
+SCENARIO("NoteDebugFlush")
+{
+    char buffer[16];
+    debugOutput.clear();
+    debugOutputCalls = 0;
+    NoteSetFnDebugOutput(debugOutputCapture);
+
+#ifndef NOTE_NODEBUG
+    SECTION("Output is written as it is produced without a buffer") {
+        NoteDebug("abc");
+
+        CHECK(debugOutput == "abc");
+        CHECK(NoteDebugFlush() == 0);
+    }
+
+    SECTION("Deferred output is only written when flushed") {
+        NoteSetDebugBuffer(buffer, sizeof(buffer));
+
+        NoteDebug("abc");
+        NoteDebugf("%d", 42);
+
+        CHECK(debugOutputCalls == 0);
+        CHECK(NoteDebugFlush() == 5);
+        CHECK(debugOutput == "abc42");
+        CHECK(NoteDebugFlush() == 0);
+    }
+
+    SECTION("Output wraps around the end of the buffer") {
+        NoteSetDebugBuffer(buffer, sizeof(buffer));
+
+        NoteDebug("0123456789");
+        NoteDebugFlush();
+        NoteDebug("abcdefghij");
+
+        CHECK(NoteDebugFlush() == 10);
+        CHECK(debugOutput == "0123456789abcdefghij");
+    }
+
+    SECTION("Output that doesn't fit is dropped and counted") {
+        NoteSetDebugBuffer(buffer, sizeof(buffer));
+        const uint32_t dropped = NoteDebugDropped();
+
+        NoteDebug("0123456789");
+        NoteDebug("abcdef");
+        NoteDebug("abcde");
+
+        CHECK(NoteDebugDropped() == (dropped + 1));
+        NoteDebugFlush();
+        CHECK(debugOutput == "0123456789abcde");
+    }
+
+    SECTION("Removing the buffer flushes it and restores immediate output") {
+        NoteSetDebugBuffer(buffer, sizeof(buffer));
+        NoteDebug("abc");
+
+        NoteSetDebugBuffer(NULL, 0);
+        NoteDebug("def");
+
+        CHECK(debugOutput == "abcdef");
+    }
+
+    SECTION("Flushed output is passed to the hook in chunks") {
+        char largeBuffer[256];
+        NoteSetDebugBuffer(largeBuffer, sizeof(largeBuffer));
+        const std::string line(100, 'x');
+
+        NoteDebug(line.c_str());
+
+        CHECK(NoteDebugFlush() == 100);
+        CHECK(debugOutputCalls > 1);
+        CHECK(debugOutput == line);
+        NoteSetDebugBuffer(NULL, 0);
+    }
+
+    SECTION("Concurrent writers and a flushing task never interleave output") {
+        static char ring[512];
+        NoteSetDebugBuffer(ring, sizeof(ring));
+        const uint32_t dropped = NoteDebugDropped();
+        const int writers = 4;
+        const int messages = 2000;
+
+        std::atomic<int> running(writers);
+        std::vector<std::thread> threads;
+        for (int w = 0 ; w < writers ; ++w) {
+            threads.emplace_back([w, &running]() {
+                for (int i = 0 ; i < messages ; ++i) {
+                    NoteDebug(("<" + std::to_string(w) + ":" + std::to_string(i) + ">").c_str());
+                }
+                running--;
+            });
+        }
+        while (running > 0) {
+            NoteDebugFlush();
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        NoteDebugFlush();
+
+        // Every message is either written out whole or counted as dropped
+        int written = 0;
+        size_t pos = 0;
+        while (pos < debugOutput.size()) {
+            const size_t end = debugOutput.find('>', pos);
+            REQUIRE(debugOutput[pos] == '<');
+            REQUIRE(end != std::string::npos);
+            REQUIRE(debugOutput.find('<', pos + 1) > end);
+            written++;
+            pos = (end + 1);
+        }
+        CHECK((written + (NoteDebugDropped() - dropped)) == (writers * messages));
+    }
+#else
+    SECTION("Nothing is deferred when debug output is disabled") {
+        NoteSetDebugBuffer(buffer, sizeof(buffer));
+        NoteDebug("abc");
+
+        CHECK(NoteDebugFlush() == 0);
+        CHECK(NoteDebugDropped() == 0);
+    }
+#endif
+
+    NoteSetDebugBuffer(NULL, 0);
+    NoteSetFnDebugOutput(NULL);
+}
+
+}
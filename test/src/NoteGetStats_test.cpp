@@ -0,0 +1,230 @@
+/*!
+ * @file NoteGetStats_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+#ifdef NOTE_C_STATS
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(const char *, _noteJSONTransaction, const char *, size_t, char **, uint32_t)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+FAKE_VALUE_FUNC(J *, NoteUserAgent)
+
+namespace
+{
+
+uint32_t clockMs = 0;
+
+void NoteDelayMsAdvance(uint32_t delayMs)
+{
+    clockMs += delayMs;
+}
+
+uint32_t NoteGetMsClock(void)
+{
+    return clockMs;
+}
+
+const char *respond(char **resp, const char *respString)
+{
+    // Every exchange with the Notecard takes 10 ms
+    clockMs += 10;
+    if (resp) {
+        *resp = strdup(respString);
+    }
+    return NULL;
+}
+
+const char *_noteJSONTransactionValid(const char *, size_t, char **resp, uint32_t)
+{
+    return respond(resp, "{\"total\":1}");
+}
+
+const char *_noteJSONTransactionIOError(const char *, size_t, char **resp, uint32_t)
+{
+    return respond(resp, "{\"err\":\"{io}\"}");
+}
+
+const char *_noteJSONTransactionTransportError(const char *, size_t, char **, uint32_t)
+{
+    clockMs += 10;
+    return "transport failure {io}";
+}
+
+const char *_noteJSONTransactionHeartbeat(const char *request, size_t reqLen, char **resp, uint32_t timeoutMs)
+{
+    if (_noteJSONTransaction_fake.call_count == 1) {
+        return respond(resp, "{\"err\":\"{heartbeat}\",\"status\":\"testing stsafe\"}");
+    }
+    return _noteJSONTransactionValid(request, reqLen, resp, timeoutMs);
+}
+
+SCENARIO("NoteGetStats")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    NoteResetStats();
+    clockMs = 0;
+    NoteDelayMs_fake.custom_fake = NoteDelayMsAdvance;
+    NoteGetMs_fake.custom_fake = NoteGetMsClock;
+    _noteTransactionStart_fake.return_val = true;
+
+    NoteStats stats;
+
+    SECTION("Transactions are counted per API") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+
+        NoteGetStats(&stats);
+
+        CHECK(stats.transactions == 3);
+        CHECK(stats.errors == 0);
+        CHECK(stats.retries == 0);
+        CHECK(stats.untracked == 0);
+        CHECK(strcmp(stats.apis[0].api, "note.add") == 0);
+        CHECK(stats.apis[0].transactions == 2);
+        CHECK(stats.apis[0].totalMs == 20);
+        CHECK(stats.apis[0].maxMs == 10);
+        CHECK(strcmp(stats.apis[1].api, "card.version") == 0);
+        CHECK(stats.apis[1].transactions == 1);
+        CHECK(stats.apis[2].api[0] == '\0');
+    }
+
+    SECTION("Latencies are counted in power-of-two buckets") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        NoteGetStats(&stats);
+
+        // 10 ms falls in the bucket for 8 ms up to 16 ms
+        CHECK(stats.latency[4] == 1);
+        CHECK(stats.apis[0].latency[4] == 1);
+    }
+
+    SECTION("Commands are counted by name") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        NoteRequest(NoteNewCommand("card.attn"));
+
+        NoteGetStats(&stats);
+
+        CHECK(stats.transactions == 1);
+        CHECK(strcmp(stats.apis[0].api, "card.attn") == 0);
+    }
+
+    SECTION("Errors, retries and resets are counted") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionIOError;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+        CHECK(NoteResponseErrorContains(rsp, "{io}"));
+        JDelete(rsp);
+
+        NoteGetStats(&stats);
+
+        CHECK(stats.transactions == 1);
+        CHECK(stats.errors == 1);
+        CHECK(stats.ioErrors == (CARD_REQUEST_RETRIES_ALLOWED + 1));
+        CHECK(stats.retries == CARD_REQUEST_RETRIES_ALLOWED);
+        CHECK(stats.apis[0].errors == 1);
+        CHECK(stats.apis[0].retries == CARD_REQUEST_RETRIES_ALLOWED);
+        CHECK(stats.apis[0].maxMs > 0);
+    }
+
+    SECTION("Resets of the I/O interface are counted") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionTransportError;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        NoteGetStats(&stats);
+
+        CHECK(stats.resets >= (CARD_REQUEST_RETRIES_ALLOWED + 1));
+        CHECK(stats.resetFailures == 0);
+    }
+
+    SECTION("Heartbeats are counted") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionHeartbeat;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        NoteGetStats(&stats);
+
+        CHECK(stats.heartbeats == 1);
+        CHECK(stats.transactions == 1);
+        CHECK(stats.retries == 0);
+    }
+
+    SECTION("APIs that don't fit in the table are untracked") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        for (int i = 0 ; i <= NOTE_C_STATS_APIS ; ++i) {
+            char api[16];
+            snprintf(api, sizeof(api), "test.api%d", i);
+            JDelete(NoteRequestResponse(NoteNewRequest(api)));
+        }
+
+        NoteGetStats(&stats);
+
+        CHECK(stats.transactions == (NOTE_C_STATS_APIS + 1));
+        CHECK(stats.untracked == 1);
+        CHECK(stats.apis[NOTE_C_STATS_APIS - 1].transactions == 1);
+    }
+
+    SECTION("NoteResetStats clears the statistics") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        NoteResetStats();
+        NoteGetStats(&stats);
+
+        CHECK(stats.transactions == 0);
+        CHECK(stats.apis[0].api[0] == '\0');
+        CHECK(stats.latency[4] == 0);
+    }
+
+    SECTION("NoteGetStatsObject reports the statistics as JSON") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        J *obj = NoteGetStatsObject();
+
+        REQUIRE(obj != NULL);
+        CHECK(JGetInt(obj, "transactions") == 1);
+        CHECK(JGetArraySize(JGetArray(obj, "latency")) == NOTE_C_STATS_BUCKETS);
+        J *api = JGetObjectItem(JGetObject(obj, "apis"), "note.add");
+        REQUIRE(api != NULL);
+        CHECK(JGetInt(api, "transactions") == 1);
+        CHECK(JGetInt(api, "max_ms") == 10);
+        CHECK(JGetArrayItem(JGetArray(api, "latency"), 4)->valuenumber == 1);
+
+        JDelete(obj);
+    }
+
+    NoteResetStats();
+    RESET_FAKE(_noteJSONTransaction);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(NoteDelayMs);
+    RESET_FAKE(NoteGetMs);
+    RESET_FAKE(NoteUserAgent);
+}
+
+}
+
+#endif // NOTE_C_STATS
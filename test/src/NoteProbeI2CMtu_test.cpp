@@ -0,0 +1,116 @@
+/*!
+ * @file NoteProbeI2CMtu_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(bool, _noteEcho, size_t, uint32_t)
+FAKE_VALUE_FUNC(bool, NoteReset)
+FAKE_VALUE_FUNC(int, NoteGetActiveInterface)
+
+namespace
+{
+
+// The largest MTU the emulated Notecard and host driver handle
+uint32_t largestWorkingMtu;
+
+// The MTU of each `echo`, once per candidate, and of each reset
+std::vector<uint32_t> probed;
+std::vector<uint32_t> resets;
+
+bool _noteEchoUpTo(size_t, uint32_t)
+{
+    const uint32_t mtu = NoteI2CMax();
+    if (probed.empty() || probed.back() != mtu) {
+        probed.push_back(mtu);
+    }
+    return (mtu <= largestWorkingMtu);
+}
+
+bool NoteResetRecord(void)
+{
+    resets.push_back(NoteI2CMax());
+    return true;
+}
+
+SCENARIO("NoteProbeI2CMtu")
+{
+    probed.clear();
+    resets.clear();
+    NoteSetI2CMtu(0);
+    NoteGetActiveInterface_fake.return_val = NOTE_C_INTERFACE_I2C;
+    _noteEcho_fake.custom_fake = _noteEchoUpTo;
+    NoteReset_fake.custom_fake = NoteResetRecord;
+
+    uint32_t mtu = 0;
+
+    SECTION("Every MTU works") {
+        largestWorkingMtu = NOTE_I2C_MTU_MAX;
+
+        CHECK(NoteProbeI2CMtu() == NOTE_I2C_MTU_MAX);
+        NoteGetI2CMtu(&mtu);
+        CHECK(mtu == NOTE_I2C_MTU_MAX);
+        CHECK(probed == std::vector<uint32_t>({30, 60, 120, 240, NOTE_I2C_MTU_MAX}));
+        CHECK(_noteEcho_fake.call_count == (probed.size() * NOTE_C_I2C_CALIBRATION_TRIALS));
+        CHECK(_noteEcho_fake.arg0_val == NOTE_C_I2C_CALIBRATION_LEN);
+        CHECK(resets.empty());
+    }
+
+    SECTION("The probe narrows down on the largest MTU that works") {
+        largestWorkingMtu = 100;
+
+        CHECK(NoteProbeI2CMtu() == 97);
+        NoteGetI2CMtu(&mtu);
+        CHECK(mtu == 97);
+        CHECK(probed == std::vector<uint32_t>({30, 60, 120, 90, 105, 97}));
+        // The interface is reset at the largest MTU that had worked
+        CHECK(resets == std::vector<uint32_t>({60, 90}));
+    }
+
+    SECTION("Only the default MTU works") {
+        largestWorkingMtu = 30;
+
+        CHECK(NoteProbeI2CMtu() == 30);
+        CHECK(probed == std::vector<uint32_t>({30, 60, 45, 37}));
+    }
+
+    SECTION("The default MTU fails") {
+        NoteSetI2CMtu(64);
+        largestWorkingMtu = 0;
+
+        CHECK(NoteProbeI2CMtu() == 0);
+        NoteGetI2CMtu(&mtu);
+        CHECK(mtu == 64);
+        CHECK(probed == std::vector<uint32_t>({30}));
+        CHECK(_noteEcho_fake.call_count == 1);
+    }
+
+    SECTION("I2C is not active") {
+        NoteGetActiveInterface_fake.return_val = NOTE_C_INTERFACE_SERIAL;
+
+        CHECK(NoteProbeI2CMtu() == 0);
+        CHECK(_noteEcho_fake.call_count == 0);
+    }
+
+    NoteSetI2CMtu(0);
+    RESET_FAKE(_noteEcho);
+    RESET_FAKE(NoteReset);
+    RESET_FAKE(NoteGetActiveInterface);
+}
+
+}
@@ -0,0 +1,206 @@
+/*!
+ * @file NoteRequestBatch_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(J *, _noteTransactionShouldLockAndStart, J *, bool, bool)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(_noteTransactionStop)
+FAKE_VOID_FUNC(_noteLockNote)
+FAKE_VOID_FUNC(_noteUnlockNote)
+FAKE_VALUE_FUNC(J *, _errDoc, uint32_t, const char *)
+
+namespace
+{
+
+J *_noteTransactionShouldLockAndStartValid(J *req, bool lockNotecard, bool startTransaction)
+{
+    // The batch must own the lock and the transaction window
+    if (lockNotecard || startTransaction) {
+        return NULL;
+    }
+
+    J *rsp = JCreateObject();
+    JAddStringToObject(rsp, "echo", JGetString(req, "req"));
+    return rsp;
+}
+
+J *_noteTransactionShouldLockAndStartSecondFails(J *req, bool lockNotecard, bool startTransaction)
+{
+    if (_noteTransactionShouldLockAndStart_fake.call_count == 2) {
+        return NULL;
+    }
+    return _noteTransactionShouldLockAndStartValid(req, lockNotecard, startTransaction);
+}
+
+J *_errDocValid(uint32_t id, const char *errmsg)
+{
+    J *rsp = JCreateObject();
+    JAddStringToObject(rsp, c_err, errmsg);
+    JAddIntToObject(rsp, "id", id);
+    return rsp;
+}
+
+// The error document for the failed request can't be allocated, but a
+// placeholder can
+J *_errDocFirstFails(uint32_t id, const char *errmsg)
+{
+    if (_errDoc_fake.call_count == 1) {
+        return NULL;
+    }
+    return _errDocValid(id, errmsg);
+}
+
+J *newBatch(size_t count)
+{
+    const char *apis[] = {"card.version", "hub.status", "card.time"};
+    J *batch = JCreateArray();
+    for (size_t i = 0 ; i < count ; ++i) {
+        J *req = NoteNewRequest(apis[i % (sizeof(apis) / sizeof(apis[0]))]);
+        JAddIntToObject(req, "id", (JINTEGER)(i + 1));
+        JAddItemToArray(batch, req);
+    }
+    return batch;
+}
+
+SCENARIO("NoteRequestBatch")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    // Ignore the locking performed while setting the hooks
+    RESET_FAKE(_noteLockNote);
+    RESET_FAKE(_noteUnlockNote);
+    _noteTransactionStart_fake.return_val = true;
+    _errDoc_fake.custom_fake = _errDocValid;
+
+    SECTION("Passing a NULL array returns NULL") {
+        CHECK(NoteRequestBatch(NULL) == NULL);
+        CHECK(_noteTransactionStart_fake.call_count == 0);
+    }
+
+    SECTION("Passing a non-array returns NULL") {
+        J *req = NoteNewRequest("card.version");
+        REQUIRE(req != NULL);
+
+        CHECK(NoteRequestBatch(req) == NULL);
+        CHECK(_noteTransactionStart_fake.call_count == 0);
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 0);
+    }
+
+    SECTION("An empty batch returns an empty array") {
+        J *rsp = NoteRequestBatch(JCreateArray());
+
+        REQUIRE(rsp != NULL);
+        CHECK(JIsArray(rsp));
+        CHECK(JGetArraySize(rsp) == 0);
+
+        JDelete(rsp);
+    }
+
+    SECTION("The lock and transaction window are held once for the batch") {
+        _noteTransactionShouldLockAndStart_fake.custom_fake = _noteTransactionShouldLockAndStartValid;
+
+        J *rsp = NoteRequestBatch(newBatch(10));
+
+        REQUIRE(rsp != NULL);
+        CHECK(JGetArraySize(rsp) == 10);
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 10);
+        CHECK(_noteTransactionStart_fake.call_count == 1);
+        CHECK(_noteTransactionStop_fake.call_count == 1);
+        CHECK(_noteLockNote_fake.call_count == 1);
+        CHECK(_noteUnlockNote_fake.call_count == 1);
+
+        // Responses are returned in request order
+        CHECK(JContainsString(JGetArrayItem(rsp, 0), "echo", "card.version"));
+        CHECK(JContainsString(JGetArrayItem(rsp, 1), "echo", "hub.status"));
+        CHECK(JContainsString(JGetArrayItem(rsp, 2), "echo", "card.time"));
+        for (int i = 0 ; i < JGetArraySize(rsp) ; ++i) {
+            CHECK(!NoteResponseError(JGetArrayItem(rsp, i)));
+        }
+
+        JDelete(rsp);
+    }
+
+    SECTION("A failed request yields an error in its slot only") {
+        _noteTransactionShouldLockAndStart_fake.custom_fake = _noteTransactionShouldLockAndStartSecondFails;
+
+        J *rsp = NoteRequestBatch(newBatch(3));
+
+        REQUIRE(rsp != NULL);
+        REQUIRE(JGetArraySize(rsp) == 3);
+        CHECK(!NoteResponseError(JGetArrayItem(rsp, 0)));
+        CHECK(NoteResponseError(JGetArrayItem(rsp, 1)));
+        CHECK(JGetInt(JGetArrayItem(rsp, 1), "id") == 2);
+        CHECK(!NoteResponseError(JGetArrayItem(rsp, 2)));
+
+        JDelete(rsp);
+    }
+
+    SECTION("Every slot has an error when the transaction window can't be opened") {
+        _noteTransactionStart_fake.return_val = false;
+
+        J *rsp = NoteRequestBatch(newBatch(3));
+
+        REQUIRE(rsp != NULL);
+        REQUIRE(JGetArraySize(rsp) == 3);
+        for (int i = 0 ; i < JGetArraySize(rsp) ; ++i) {
+            J *item = JGetArrayItem(rsp, i);
+            CHECK(NoteResponseErrorContains(item, "{io}"));
+            CHECK(JGetInt(item, "id") == (i + 1));
+        }
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 0);
+        CHECK(_noteTransactionStop_fake.call_count == 0);
+        CHECK(_noteLockNote_fake.call_count == 0);
+
+        JDelete(rsp);
+    }
+
+    SECTION("A response that can't be allocated is replaced by a {mem} error") {
+        _noteTransactionShouldLockAndStart_fake.custom_fake = _noteTransactionShouldLockAndStartSecondFails;
+        _errDoc_fake.custom_fake = _errDocFirstFails;
+
+        J *rsp = NoteRequestBatch(newBatch(3));
+
+        REQUIRE(rsp != NULL);
+        REQUIRE(JGetArraySize(rsp) == 3);
+        CHECK(NoteResponseErrorContains(JGetArrayItem(rsp, 1), "{mem}"));
+        CHECK(JGetInt(JGetArrayItem(rsp, 1), "id") == 2);
+        CHECK(!NoteResponseError(JGetArrayItem(rsp, 2)));
+
+        JDelete(rsp);
+    }
+
+    SECTION("The batch fails when not even an error response can be allocated") {
+        _noteTransactionShouldLockAndStart_fake.custom_fake = _noteTransactionShouldLockAndStartSecondFails;
+        _errDoc_fake.custom_fake = NULL;
+        _errDoc_fake.return_val = NULL;
+
+        CHECK(NoteRequestBatch(newBatch(3)) == NULL);
+        // The remaining requests are not sent
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 2);
+        CHECK(_noteUnlockNote_fake.call_count == _noteLockNote_fake.call_count);
+        CHECK(_noteTransactionStop_fake.call_count == 1);
+    }
+
+    RESET_FAKE(_noteTransactionShouldLockAndStart);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(_noteTransactionStop);
+    RESET_FAKE(_noteLockNote);
+    RESET_FAKE(_noteUnlockNote);
+    RESET_FAKE(_errDoc);
+}
+
+}
@@ -425,13 +425,17 @@ SCENARIO("NoteRequestResponseJSON")
                 NoteFree(rsp);
             }
 
-            AND_GIVEN("The request fails to parse") {
+            AND_GIVEN("JParse would fail") {
                 JParse_fake.custom_fake = nullptr;
                 JParse_fake.return_val = NULL;
 
                 WHEN("NoteRequestResponseJSON is called") {
                     char *rsp = NoteRequestResponseJSON(req);
 
+                    THEN("The request is scanned rather than parsed") {
+                        CHECK(JParse_fake.call_count == 0);
+                    }
+
                     THEN("The error is returned in a well-formed JSON error string") {
                         REQUIRE(rsp != NULL);
                         J *json = JParseWithOpts(rsp, 0, 0);
@@ -441,11 +445,11 @@ SCENARIO("NoteRequestResponseJSON")
                         JDelete(json);
                     }
 
-                    THEN("The id is not returned in a well-formed JSON error string") {
+                    THEN("The id is returned in a well-formed JSON error string") {
                         REQUIRE(rsp != NULL);
                         J *json = JParseWithOpts(rsp, 0, 0);
 
-                        CHECK(!JHasObjectItem(json, "id"));
+                        CHECK(JGetInt(json, "id") == 917);
 
                         JDelete(json);
                     }
@@ -491,10 +495,10 @@ SCENARIO("NoteRequestResponseJSON")
 
             AND_GIVEN("_Malloc fails to allocate rspJSON") {
                 NoteMalloc_fake.custom_fake = [](size_t size) -> void * {
-                    // Allow the first seventeen calls to malloc to succeed for
-                    // JParse(6), JCreateObject(9) and JPrintUnformatted(2), but
-                    // fail the eighteenth call.
-                    if (NoteMalloc_fake.call_count > 17)
+                    // Allow the first eleven calls to malloc to succeed for
+                    // JCreateObject(9) and JPrintUnformatted(2), but fail the
+                    // twelfth call.
+                    if (NoteMalloc_fake.call_count > 11)
                     {
                         return NULL;
                     }
@@ -512,6 +516,74 @@ SCENARIO("NoteRequestResponseJSON")
         }
     }
 
+    GIVEN("The request is a pipeline of requests and commands") {
+        char req[] = "{\"req\":\"card.version\"}\n"
+                     "{\"cmd\":\"card.attn\"}\n"
+                     "{\"req\":\"hub.status\",\"id\":2}\n"
+                     "{\"req\":\"card.time\"}\n";
+        _noteJSONTransaction_fake.custom_fake = [](const char *request, size_t, char **response, uint32_t) -> const char * {
+            if (response == NULL) {
+                return NULL;
+            }
+            if (strncmp(request, "{\"req\":\"hub.status\"", 19) == 0) {
+                return "an error occurred";
+            }
+            *response = strdup((strncmp(request, "{\"req\":\"card.version\"", 21) == 0) ? "{\"version\":1}\n" : "{\"time\":2}");
+            return NULL;
+        };
+
+        WHEN("NoteRequestResponseJSON is called") {
+            char *rsp = NoteRequestResponseJSON(req);
+
+            THEN("Every line is sent") {
+                CHECK(_noteJSONTransaction_fake.call_count == 4);
+                CHECK(_noteJSONTransaction_fake.arg2_history[1] == NULL);
+            }
+
+            THEN("The Notecard is locked and the transaction started once") {
+                CHECK(_noteLockNote_fake.call_count == 1);
+                CHECK(_noteUnlockNote_fake.call_count == 1);
+                CHECK(_noteTransactionStart_fake.call_count == 1);
+                CHECK(_noteTransactionStop_fake.call_count == 1);
+            }
+
+            THEN("The responses are returned in order, one per line, with an "
+                 "error document for the failed request") {
+                REQUIRE(rsp != NULL);
+                const char *line2 = strchr(rsp, '\n');
+                REQUIRE(line2 != NULL);
+                const char *line3 = strchr(line2 + 1, '\n');
+                REQUIRE(line3 != NULL);
+                CHECK(strncmp(rsp, "{\"version\":1}\n", line2 - rsp + 1) == 0);
+                CHECK(strcmp(line3 + 1, "{\"time\":2}") == 0);
+
+                J *errdoc = JParseWithOpts(line2 + 1, 0, 0);
+                CHECK(JContainsString(errdoc, "err", "an error occurred"));
+                CHECK(JGetInt(errdoc, "id") == 2);
+                JDelete(errdoc);
+            }
+
+            NoteFree(rsp);
+        }
+
+        AND_GIVEN("A line in the middle is malformed") {
+            char badReq[] = "{\"cmd\":\"card.attn}\n"
+                            "{\"req\":\"card.time\"}\n";
+
+            WHEN("NoteRequestResponseJSON is called") {
+                char *rsp = NoteRequestResponseJSON(badReq);
+
+                THEN("The malformed line is skipped and the rest are sent") {
+                    CHECK(_noteJSONTransaction_fake.call_count == 1);
+                    REQUIRE(rsp != NULL);
+                    CHECK(strcmp(rsp, "{\"time\":2}") == 0);
+                }
+
+                NoteFree(rsp);
+            }
+        }
+    }
+
     RESET_FAKE(_noteJSONTransaction);
     RESET_FAKE(_noteLockNote);
     RESET_FAKE(_noteTransactionStart);
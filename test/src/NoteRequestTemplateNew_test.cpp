@@ -0,0 +1,206 @@
+/*!
+ * @file NoteRequestTemplateNew_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include <string>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(char *, _crcAdd, char *, uint16_t)
+FAKE_VALUE_FUNC(const char *, _noteJSONTransaction, const char *, size_t, char **, uint32_t)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+
+namespace
+{
+
+std::string sent;
+
+const char *_noteJSONTransactionCapture(const char *request, size_t reqLen, char **response, uint32_t)
+{
+    sent = std::string(request, reqLen);
+    if (response != NULL) {
+        *response = strdup("{\"total\":1}");
+    }
+    return NULL;
+}
+
+J *newTelemetryRequest(void)
+{
+    J *req = NoteNewRequest("note.add");
+    JAddStringToObject(req, "file", "sensors.qo");
+    J *body = JAddObjectToObject(req, "body");
+    JAddStringToObject(body, "temp", "{{temp}}");
+    JAddStringToObject(body, "count", "{{count}}");
+    JAddStringToObject(body, "state", "{{state}}");
+    return req;
+}
+
+SCENARIO("NoteRequestTemplateNew")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    _noteTransactionStart_fake.return_val = true;
+    _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionCapture;
+    sent.clear();
+
+    SECTION("A NULL request yields no template") {
+        CHECK(NoteRequestTemplateNew(NULL) == NULL);
+    }
+
+    SECTION("A request with neither req nor cmd yields no template") {
+        J *req = JCreateObject();
+        JAddStringToObject(req, "file", "{{file}}");
+
+        CHECK(NoteRequestTemplateNew(req) == NULL);
+    }
+
+    SECTION("Duplicate slots are rejected") {
+        J *req = NoteNewRequest("note.add");
+        JAddStringToObject(req, "file", "{{x}}");
+        JAddStringToObject(req, "note", "{{x}}");
+
+        CHECK(NoteRequestTemplateNew(req) == NULL);
+    }
+
+    SECTION("The slot values are stamped into the request") {
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(newTelemetryRequest());
+        REQUIRE(tmpl != NULL);
+
+        CHECK(NoteRequestTemplateSetNumber(tmpl, "temp", 21.5));
+        CHECK(NoteRequestTemplateSetInt(tmpl, "count", 42));
+        CHECK(NoteRequestTemplateSetString(tmpl, "state", "ok"));
+        J *rsp = NoteRequestTemplateResponse(tmpl);
+
+        REQUIRE(rsp != NULL);
+        CHECK(JGetInt(rsp, "total") == 1);
+        CHECK(sent == "{\"req\":\"note.add\",\"file\":\"sensors.qo\",\"body\":{\"temp\":21.5,\"count\":42,\"state\":\"ok\"}}\n");
+
+        JDelete(rsp);
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    SECTION("The stamped request matches the one built from scratch") {
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(newTelemetryRequest());
+        REQUIRE(tmpl != NULL);
+        NoteRequestTemplateSetNumber(tmpl, "temp", -3.25);
+        NoteRequestTemplateSetNumber(tmpl, "count", 7);
+        NoteRequestTemplateSetString(tmpl, "state", "a \"quoted\"\\path\n\x01");
+        REQUIRE(NoteRequestTemplateSend(tmpl));
+        const std::string stamped = sent;
+
+        J *req = NoteNewRequest("note.add");
+        JAddStringToObject(req, "file", "sensors.qo");
+        J *body = JAddObjectToObject(req, "body");
+        JAddNumberToObject(body, "temp", -3.25);
+        JAddNumberToObject(body, "count", 7);
+        JAddStringToObject(body, "state", "a \"quoted\"\\path\n\x01");
+        REQUIRE(NoteRequest(req));
+
+        CHECK(stamped == sent);
+
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    SECTION("The template can be sent repeatedly with new values") {
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(newTelemetryRequest());
+        REQUIRE(tmpl != NULL);
+        NoteRequestTemplateSetNumber(tmpl, "temp", 1);
+        NoteRequestTemplateSetInt(tmpl, "count", 1);
+        NoteRequestTemplateSetString(tmpl, "state", "a much longer state than before");
+        REQUIRE(NoteRequestTemplateSend(tmpl));
+
+        NoteRequestTemplateSetString(tmpl, "state", "ok");
+        NoteRequestTemplateSetInt(tmpl, "count", 2);
+        REQUIRE(NoteRequestTemplateSend(tmpl));
+
+        CHECK(_noteJSONTransaction_fake.call_count == 2);
+        CHECK(sent == "{\"req\":\"note.add\",\"file\":\"sensors.qo\",\"body\":{\"temp\":1,\"count\":2,\"state\":\"ok\"}}\n");
+
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    SECTION("A template with an unset slot is not sent") {
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(newTelemetryRequest());
+        REQUIRE(tmpl != NULL);
+        NoteRequestTemplateSetNumber(tmpl, "temp", 1);
+
+        CHECK(NoteRequestTemplateResponse(tmpl) == NULL);
+        CHECK(!NoteRequestTemplateSend(tmpl));
+        CHECK(_noteJSONTransaction_fake.call_count == 0);
+
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    SECTION("Unknown slots are not set") {
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(newTelemetryRequest());
+        REQUIRE(tmpl != NULL);
+
+        CHECK(!NoteRequestTemplateSetInt(tmpl, "missing", 1));
+        CHECK(!NoteRequestTemplateSetInt(NULL, "count", 1));
+
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    SECTION("Placeholders used as keys or within strings are not slots") {
+        J *req = NoteNewRequest("note.add");
+        JAddStringToObject(req, "{{key}}", "value");
+        JAddStringToObject(req, "text", "\"{{quoted}}\"");
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(req);
+        REQUIRE(tmpl != NULL);
+
+        CHECK(!NoteRequestTemplateSetInt(tmpl, "key", 1));
+        CHECK(!NoteRequestTemplateSetInt(tmpl, "quoted", 1));
+        CHECK(NoteRequestTemplateSend(tmpl));
+
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    SECTION("A command template is sent without waiting for a response") {
+        J *req = NoteNewCommand("card.log");
+        JAddStringToObject(req, "text", "{{text}}");
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(req);
+        REQUIRE(tmpl != NULL);
+        NoteRequestTemplateSetString(tmpl, "text", "hello");
+
+        CHECK(NoteRequestTemplateSend(tmpl));
+        CHECK(_noteJSONTransaction_fake.arg2_val == NULL);
+        CHECK(sent == "{\"cmd\":\"card.log\",\"text\":\"hello\"}\n");
+
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    SECTION("An error document is returned when the Notecard isn't ready") {
+        NoteRequestTemplate *tmpl = NoteRequestTemplateNew(newTelemetryRequest());
+        REQUIRE(tmpl != NULL);
+        NoteRequestTemplateSetNumber(tmpl, "temp", 1);
+        NoteRequestTemplateSetInt(tmpl, "count", 1);
+        NoteRequestTemplateSetString(tmpl, "state", "ok");
+        _noteTransactionStart_fake.return_val = false;
+
+        J *rsp = NoteRequestTemplateResponse(tmpl);
+
+        CHECK(NoteResponseErrorContains(rsp, "{io}"));
+        CHECK(_noteJSONTransaction_fake.call_count == 0);
+
+        JDelete(rsp);
+        NoteRequestTemplateDelete(tmpl);
+    }
+
+    RESET_FAKE(_crcAdd);
+    RESET_FAKE(_noteJSONTransaction);
+    RESET_FAKE(_noteTransactionStart);
+}
+
+}
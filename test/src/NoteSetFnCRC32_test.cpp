@@ -0,0 +1,95 @@
+/*!
+ * @file NoteSetFnCRC32_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VOID_FUNC(_noteLockNote)
+FAKE_VOID_FUNC(_noteUnlockNote)
+FAKE_VALUE_FUNC(uint32_t, mockCrc32Fn, uint32_t, const uint8_t *, size_t)
+
+extern crc32Fn hookCrc32;
+
+namespace
+{
+
+SCENARIO("NoteSetFnCRC32")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    // Ignore the locking performed while setting the hooks
+    RESET_FAKE(_noteLockNote);
+    RESET_FAKE(_noteUnlockNote);
+
+    GIVEN("The CRC32 hook has not been set (i.e. NULL)") {
+        hookCrc32 = NULL;
+
+        WHEN("NoteSetFnCRC32 is called with a function") {
+            NoteSetFnCRC32(mockCrc32Fn);
+
+            THEN("The hook is set") {
+                crc32Fn fn = NULL;
+                NoteGetFnCRC32(&fn);
+                CHECK(hookCrc32 == mockCrc32Fn);
+                CHECK(fn == mockCrc32Fn);
+            }
+
+            THEN("The Notecard lock is taken and released") {
+                CHECK(1 == _noteLockNote_fake.call_count);
+                CHECK(_noteUnlockNote_fake.call_count == _noteLockNote_fake.call_count);
+            }
+        }
+    }
+
+    GIVEN("The CRC32 hook has been set") {
+        hookCrc32 = mockCrc32Fn;
+
+#ifndef NOTE_C_LOW_MEM
+        WHEN("A request is protected with a CRC") {
+            mockCrc32Fn_fake.return_val = 0x0BADF00D;
+            char req[] = "{\"req\":\"hub.sync\"}";
+            char *json = _crcAdd(req, 1);
+
+            THEN("The hook computes the CRC") {
+                REQUIRE(json != NULL);
+                CHECK(mockCrc32Fn_fake.call_count > 0);
+                CHECK(strstr(json, "0BADF00D") != NULL);
+            }
+
+            NoteFree(json);
+        }
+#endif
+
+        WHEN("NoteSetFnCRC32 is called with NULL") {
+            NoteSetFnCRC32(NULL);
+
+            THEN("The built-in tables are restored") {
+                CHECK(hookCrc32 == NULL);
+#ifndef NOTE_C_LOW_MEM
+                const char check[] = "123456789";
+                CHECK(_noteCrc32(0, (const uint8_t *)check, sizeof(check) - 1) == 0xCBF43926);
+                CHECK(mockCrc32Fn_fake.call_count == 0);
+#endif
+            }
+        }
+    }
+
+    hookCrc32 = NULL;
+    RESET_FAKE(_noteLockNote);
+    RESET_FAKE(_noteUnlockNote);
+    RESET_FAKE(mockCrc32Fn);
+}
+
+}
@@ -0,0 +1,132 @@
+/*!
+ * @file NoteSetFnRealloc_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(void *, NoteMalloc, size_t)
+FAKE_VALUE_FUNC(void *, reallocHook, void *, size_t)
+
+namespace
+{
+
+void *NoteMallocSystem(size_t size)
+{
+    return malloc(size);
+}
+
+void *reallocSystem(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+SCENARIO("NoteSetFnRealloc")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    NoteMalloc_fake.custom_fake = NoteMallocSystem;
+    reallocHook_fake.custom_fake = reallocSystem;
+
+    SECTION("The hook is set and returned") {
+        NoteSetFnRealloc(reallocHook);
+
+        reallocFn fn = NULL;
+        NoteGetFnRealloc(&fn);
+
+        CHECK(fn == reallocHook);
+    }
+
+    SECTION("Memory is resized with the hook when it is set") {
+        NoteSetFnRealloc(reallocHook);
+        char *buf = (char *)NoteMalloc(4);
+        REQUIRE(buf != NULL);
+        memcpy(buf, "abc", 4);
+        NoteMalloc_fake.call_count = 0;
+
+        buf = (char *)_noteRealloc(buf, 4, 1024);
+
+        REQUIRE(buf != NULL);
+        CHECK(strcmp(buf, "abc") == 0);
+        CHECK(reallocHook_fake.call_count == 1);
+        CHECK(reallocHook_fake.arg1_val == 1024);
+        CHECK(NoteMalloc_fake.call_count == 0);
+        NoteFree(buf);
+    }
+
+    SECTION("Without the hook, the bytes in use are copied to new memory") {
+        char *buf = (char *)NoteMalloc(8);
+        REQUIRE(buf != NULL);
+        memcpy(buf, "abc", 4);
+
+        char *resized = (char *)_noteRealloc(buf, 4, 1024);
+
+        REQUIRE(resized != NULL);
+        CHECK(strcmp(resized, "abc") == 0);
+        CHECK(NoteMalloc_fake.call_count == 2);
+        CHECK(NoteMalloc_fake.arg0_val == 1024);
+        NoteFree(resized);
+    }
+
+    SECTION("Memory is left allocated if it can't be resized") {
+        char *buf = (char *)NoteMalloc(4);
+        REQUIRE(buf != NULL);
+        NoteMalloc_fake.custom_fake = NULL;
+        NoteMalloc_fake.return_val = NULL;
+
+        CHECK(_noteRealloc(buf, 4, 1024) == NULL);
+
+        free(buf);
+    }
+
+    SECTION("Buffers grow in whole ALLOC_CHUNK blocks") {
+        CHECK(_noteAllocGrowLen(0, 1) == ALLOC_CHUNK);
+        CHECK(_noteAllocGrowLen(ALLOC_CHUNK, ALLOC_CHUNK + 1) % ALLOC_CHUNK == 0);
+        CHECK(_noteAllocGrowLen(ALLOC_CHUNK, (10 * ALLOC_CHUNK) + 1) == (11 * ALLOC_CHUNK));
+    }
+
+#if NOTE_C_ALLOC_GROWTH_GEOMETRIC
+    SECTION("Buffers grow by at least half their length") {
+        CHECK(_noteAllocGrowLen(64 * ALLOC_CHUNK, (64 * ALLOC_CHUNK) + 1) == (96 * ALLOC_CHUNK));
+    }
+#else
+    SECTION("Buffers grow by just enough blocks") {
+        CHECK(_noteAllocGrowLen(64 * ALLOC_CHUNK, (64 * ALLOC_CHUNK) + 1) == (65 * ALLOC_CHUNK));
+    }
+#endif
+
+    SECTION("Printing a large object resizes the print buffer with the hook") {
+        NoteSetFnRealloc(reallocHook);
+        J *obj = JCreateObject();
+        REQUIRE(obj != NULL);
+        const std::string value(16 * 1024, 'x');
+        JAddStringToObject(obj, "value", value.c_str());
+
+        char *json = JPrintUnformatted(obj);
+
+        REQUIRE(json != NULL);
+        CHECK(strlen(json) == (value.size() + strlen("{\"value\":\"\"}")));
+        CHECK(reallocHook_fake.call_count > 0);
+        NoteFree(json);
+        JDelete(obj);
+    }
+
+    NoteSetFnRealloc(NULL);
+    RESET_FAKE(NoteMalloc);
+    RESET_FAKE(reallocHook);
+}
+
+}
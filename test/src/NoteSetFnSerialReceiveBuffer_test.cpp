@@ -0,0 +1,160 @@
+/*!
+ * @file NoteSetFnSerialReceiveBuffer_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(bool, serialAvailable)
+FAKE_VALUE_FUNC(char, serialReceive)
+FAKE_VALUE_FUNC(size_t, serialAvailableCount)
+FAKE_VALUE_FUNC(bool, serialReceiveBuffer, uint8_t *, size_t, size_t *)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+
+namespace
+{
+
+std::string wire;
+
+bool serialReset(void)
+{
+    return true;
+}
+
+void serialTransmit(uint8_t *, size_t, bool)
+{
+}
+
+size_t serialAvailableCountWire(void)
+{
+    return wire.size();
+}
+
+bool serialReceiveBufferWire(uint8_t *buf, size_t max, size_t *got)
+{
+    *got = ((wire.size() < max) ? wire.size() : max);
+    memcpy(buf, wire.data(), *got);
+    wire.erase(0, *got);
+    return true;
+}
+
+SCENARIO("NoteSetFnSerialReceiveBuffer")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    NoteSetFnSerial(serialReset, serialTransmit, serialAvailable, serialReceive);
+    serialAvailableCount_fake.custom_fake = serialAvailableCountWire;
+    serialReceiveBuffer_fake.custom_fake = serialReceiveBufferWire;
+    wire.clear();
+
+    uint8_t buf[32];
+    uint32_t size = sizeof(buf);
+    uint32_t available = 37;
+
+    SECTION("The hooks are set and returned") {
+        NoteSetFnSerialReceiveBuffer(serialAvailableCount, serialReceiveBuffer);
+
+        serialAvailableCountFn availCountFn = NULL;
+        serialReceiveBufferFn receiveBufferFn = NULL;
+        NoteGetFnSerialReceiveBuffer(&availCountFn, &receiveBufferFn);
+
+        CHECK(availCountFn == serialAvailableCount);
+        CHECK(receiveBufferFn == serialReceiveBuffer);
+    }
+
+    SECTION("A packet is received in bulk rather than a byte at a time") {
+        NoteSetFnSerialReceiveBuffer(serialAvailableCount, serialReceiveBuffer);
+        wire = "{\"total\":1}\r\n";
+
+        const char *err = _serialChunkedReceive(buf, &size, true, 1000, &available);
+
+        CHECK(err == NULL);
+        CHECK(std::string((char *)buf, size) == "{\"total\":1}\r\n");
+        CHECK(available == 0);
+        CHECK(serialReceiveBuffer_fake.call_count == 1);
+        CHECK(serialAvailable_fake.call_count == 0);
+        CHECK(serialReceive_fake.call_count == 0);
+    }
+
+    SECTION("Bytes beyond the end of a packet are kept for the next receive") {
+        NoteSetFnSerialReceiveBuffer(serialAvailableCount, serialReceiveBuffer);
+        wire = "{}\r\nbinary\n";
+
+        CHECK(_serialChunkedReceive(buf, &size, true, 1000, &available) == NULL);
+        CHECK(std::string((char *)buf, size) == "{}\r\n");
+
+        size = sizeof(buf);
+        CHECK(_serialChunkedReceive(buf, &size, true, 1000, &available) == NULL);
+        CHECK(std::string((char *)buf, size) == "binary\n");
+        CHECK(serialReceiveBuffer_fake.call_count == 1);
+    }
+
+    SECTION("Reads are limited to the available count") {
+        NoteSetFnSerialReceiveBuffer(serialAvailableCount, serialReceiveBuffer);
+        wire = "{}\n";
+
+        CHECK(_serialChunkedReceive(buf, &size, true, 1000, &available) == NULL);
+        CHECK(serialReceiveBuffer_fake.arg1_val == 3);
+    }
+
+    SECTION("Packets larger than the output buffer report more available") {
+        NoteSetFnSerialReceiveBuffer(NULL, serialReceiveBuffer);
+        wire = std::string(40, 'a') + "\n";
+
+        CHECK(_serialChunkedReceive(buf, &size, true, 1000, &available) == NULL);
+        CHECK(size == sizeof(buf));
+        CHECK(available == 1);
+
+        size = sizeof(buf);
+        CHECK(_serialChunkedReceive(buf, &size, true, 1000, &available) == NULL);
+        CHECK(size == 9);
+        CHECK(buf[size - 1] == '\n');
+        CHECK(available == 0);
+    }
+
+    SECTION("Resetting the serial interface discards received bytes") {
+        NoteSetFnSerialReceiveBuffer(NULL, serialReceiveBuffer);
+        wire = "{}\r\nstale";
+        CHECK(_serialChunkedReceive(buf, &size, true, 1000, &available) == NULL);
+
+        _noteSerialReset();
+
+        CHECK_FALSE(_noteSerialAvailable());
+    }
+
+    SECTION("Without the hooks data is received a byte at a time") {
+        serialAvailable_fake.return_val = true;
+        char bytes[] = {'{', '}', '\n'};
+        SET_RETURN_SEQ(serialReceive, bytes, sizeof(bytes));
+
+        CHECK(_serialChunkedReceive(buf, &size, true, 1000, &available) == NULL);
+        CHECK(size == 3);
+        CHECK(serialReceive_fake.call_count == 3);
+        CHECK(serialReceiveBuffer_fake.call_count == 0);
+    }
+
+    NoteSetFnSerialReceiveBuffer(NULL, NULL);
+    NoteSetFnDisabled();
+    RESET_FAKE(serialAvailable);
+    RESET_FAKE(serialReceive);
+    RESET_FAKE(serialAvailableCount);
+    RESET_FAKE(serialReceiveBuffer);
+    RESET_FAKE(NoteGetMs);
+    RESET_FAKE(NoteDelayMs);
+}
+
+}
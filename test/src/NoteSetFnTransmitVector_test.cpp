@@ -0,0 +1,176 @@
+/*!
+ * @file NoteSetFnTransmitVector_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VOID_FUNC(serialTransmit, uint8_t *, size_t, bool)
+FAKE_VOID_FUNC(serialTransmitVector, const NoteIoVec *, size_t, bool)
+FAKE_VALUE_FUNC(const char *, i2cTransmit, uint16_t, uint8_t *, uint16_t)
+FAKE_VALUE_FUNC(const char *, i2cTransmitVector, uint16_t, const NoteIoVec *, size_t)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+
+namespace
+{
+
+std::string wire;
+size_t gathered = 0;
+
+bool serialReset(void)
+{
+    return true;
+}
+
+bool serialAvailable(void)
+{
+    return false;
+}
+
+char serialReceive(void)
+{
+    return '\0';
+}
+
+bool i2cReset(uint16_t)
+{
+    return true;
+}
+
+const char *i2cReceive(uint16_t, uint8_t *, uint16_t, uint32_t *)
+{
+    return NULL;
+}
+
+void serialTransmitVectorWire(const NoteIoVec *iov, size_t iovCount, bool)
+{
+    for (size_t i = 0 ; i < iovCount ; ++i) {
+        wire.append((const char *)iov[i].data, iov[i].len);
+    }
+}
+
+const char *i2cTransmitVectorWire(uint16_t, const NoteIoVec *iov, size_t iovCount)
+{
+    gathered = iovCount;
+    for (size_t i = 0 ; i < iovCount ; ++i) {
+        CHECK(iov[i].len <= 30);
+        wire.append((const char *)iov[i].data, iov[i].len);
+    }
+    return NULL;
+}
+
+SCENARIO("NoteSetFnTransmitVector")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    serialTransmitVector_fake.custom_fake = serialTransmitVectorWire;
+    i2cTransmitVector_fake.custom_fake = i2cTransmitVectorWire;
+    wire.clear();
+    gathered = 0;
+
+    SECTION("The hooks are set and returned") {
+        NoteSetFnTransmitVector(serialTransmitVector, i2cTransmitVector);
+
+        serialTransmitVectorFn serialFn = NULL;
+        i2cTransmitVectorFn i2cFn = NULL;
+        NoteGetFnTransmitVector(&serialFn, &i2cFn);
+
+        CHECK(serialFn == serialTransmitVector);
+        CHECK(i2cFn == i2cTransmitVector);
+    }
+
+    SECTION("A serial request and its terminator are sent in one call") {
+        NoteSetFnSerial(serialReset, serialTransmit, serialAvailable, serialReceive);
+        NoteSetFnTransmitVector(serialTransmitVector, NULL);
+        const char req[] = "{\"req\":\"card.version\"}\n";
+
+        CHECK(_serialNoteTransaction(req, strlen(req), NULL, 0) == NULL);
+
+        CHECK(serialTransmitVector_fake.call_count == 1);
+        CHECK(serialTransmitVector_fake.arg1_val == 2);
+        CHECK(serialTransmitVector_fake.arg2_val);
+        CHECK(serialTransmit_fake.call_count == 0);
+        CHECK(wire == "{\"req\":\"card.version\"}\r\n");
+    }
+
+    SECTION("A long serial request is sent in segments, the last with the terminator") {
+        NoteSetFnSerial(serialReset, serialTransmit, serialAvailable, serialReceive);
+        NoteSetFnTransmitVector(serialTransmitVector, NULL);
+        const std::string req = std::string(CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN + 10, 'a');
+
+        CHECK(_serialChunkedTransmitLine((const uint8_t *)req.data(), (uint32_t)req.size(), false) == NULL);
+
+        CHECK(serialTransmitVector_fake.call_count == 2);
+        CHECK(serialTransmitVector_fake.arg1_history[0] == 1);
+        CHECK_FALSE(serialTransmitVector_fake.arg2_history[0]);
+        CHECK(serialTransmitVector_fake.arg1_history[1] == 2);
+        CHECK(wire == (req + "\r\n"));
+    }
+
+    SECTION("Without the vectored hook each buffer goes to the serial transmit hook") {
+        NoteSetFnSerial(serialReset, serialTransmit, serialAvailable, serialReceive);
+        const char req[] = "{}";
+
+        CHECK(_serialChunkedTransmitLine((const uint8_t *)req, 2, false) == NULL);
+
+        CHECK(serialTransmit_fake.call_count == 2);
+        CHECK_FALSE(serialTransmit_fake.arg2_history[0]);
+        CHECK(serialTransmit_fake.arg2_history[1]);
+    }
+
+    SECTION("I2C chunks without processing delays are sent as gather lists") {
+        NoteSetFnI2C(0, 30, i2cReset, i2cTransmit, i2cReceive);
+        NoteSetFnTransmitVector(NULL, i2cTransmitVector);
+        const std::string data = std::string(100, 'b');
+
+        CHECK(_i2cChunkedTransmit((const uint8_t *)data.data(), (uint32_t)data.size(), false) == NULL);
+
+        CHECK(i2cTransmitVector_fake.call_count == 1);
+        CHECK(gathered == 4);
+        CHECK(i2cTransmit_fake.call_count == 0);
+        CHECK(wire == data);
+    }
+
+    SECTION("I2C chunks that need processing delays are sent one at a time") {
+        NoteSetFnI2C(0, 30, i2cReset, i2cTransmit, i2cReceive);
+        NoteSetFnTransmitVector(NULL, i2cTransmitVector);
+        const std::string data = std::string(100, 'b');
+
+        CHECK(_i2cChunkedTransmit((const uint8_t *)data.data(), (uint32_t)data.size(), true) == NULL);
+
+        CHECK(i2cTransmitVector_fake.call_count == 0);
+        CHECK(i2cTransmit_fake.call_count == 4);
+    }
+
+    SECTION("An I2C gather error is returned") {
+        NoteSetFnI2C(0, 30, i2cReset, i2cTransmit, i2cReceive);
+        NoteSetFnTransmitVector(NULL, i2cTransmitVector);
+        i2cTransmitVector_fake.custom_fake = NULL;
+        i2cTransmitVector_fake.return_val = "i2c failure";
+
+        CHECK(_i2cChunkedTransmit((const uint8_t *)"{}", 2, false) != NULL);
+    }
+
+    NoteSetFnTransmitVector(NULL, NULL);
+    NoteSetFnDisabled();
+    RESET_FAKE(serialTransmit);
+    RESET_FAKE(serialTransmitVector);
+    RESET_FAKE(i2cTransmit);
+    RESET_FAKE(i2cTransmitVector);
+    RESET_FAKE(NoteDelayMs);
+}
+
+}
@@ -0,0 +1,229 @@
+/*!
+ * @file NoteSetFnWaitForData_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(const char *, _noteI2CReceive, uint16_t, uint8_t *, uint16_t, uint32_t *)
+FAKE_VALUE_FUNC(bool, waitForData, uint32_t)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+
+namespace
+{
+
+uint32_t rtcMs;
+
+// The emulated Notecard has its response ready at this time
+uint32_t readyAtMs;
+std::string pending;
+
+std::vector<uint32_t> delays;
+std::vector<uint32_t> waits;
+
+uint32_t NoteGetMsMock()
+{
+    return rtcMs;
+}
+
+void NoteDelayMsMock(uint32_t delayMs)
+{
+    rtcMs += delayMs;
+    delays.push_back(delayMs);
+}
+
+const char *_noteI2CReceiveMock(uint16_t, uint8_t *buf, uint16_t size, uint32_t *available)
+{
+    if (rtcMs < readyAtMs) {
+        *available = 0;
+    } else if (size == 0) {
+        *available = (uint32_t)pending.size();
+    } else {
+        memcpy(buf, pending.data(), size);
+        pending.erase(0, size);
+        *available = (uint32_t)pending.size();
+    }
+    return NULL;
+}
+
+// Signals as soon as the response is ready, like an ATTN interrupt
+bool waitForDataMock(uint32_t timeoutMs)
+{
+    waits.push_back(timeoutMs);
+    if (readyAtMs <= (rtcMs + timeoutMs)) {
+        rtcMs = (readyAtMs > rtcMs) ? readyAtMs : rtcMs;
+        return true;
+    }
+    rtcMs += timeoutMs;
+    return false;
+}
+
+// Signals immediately whether or not there is a response, like a stuck line
+bool waitForDataStuck(uint32_t timeoutMs)
+{
+    waits.push_back(timeoutMs);
+    return true;
+}
+
+bool i2cReset(uint16_t)
+{
+    return true;
+}
+
+const char *i2cTransmit(uint16_t, uint8_t *, uint16_t)
+{
+    return NULL;
+}
+
+const char *i2cReceive(uint16_t, uint8_t *, uint16_t, uint32_t *)
+{
+    return NULL;
+}
+
+SCENARIO("NoteSetFnWaitForData")
+{
+    NoteSetFnI2C(0, 0, i2cReset, i2cTransmit, i2cReceive);
+    NoteSetFnWaitForData(NULL);
+    rtcMs = 0;
+    readyAtMs = 0;
+    pending = "{}\n";
+    delays.clear();
+    waits.clear();
+    NoteGetMs_fake.custom_fake = NoteGetMsMock;
+    NoteDelayMs_fake.custom_fake = NoteDelayMsMock;
+    _noteI2CReceive_fake.custom_fake = _noteI2CReceiveMock;
+    waitForData_fake.custom_fake = waitForDataMock;
+    uint32_t available = 0;
+
+    SECTION("The hook can be retrieved") {
+        waitForDataFn fn = NULL;
+
+        NoteSetFnWaitForData(waitForData);
+        NoteGetFnWaitForData(&fn);
+        CHECK(fn == waitForData);
+        NoteGetFnWaitForData(NULL);
+    }
+
+    SECTION("Without a hook, the poll interval doubles up to the maximum") {
+        readyAtMs = 200;
+
+        CHECK(_i2cNoteQueryLength(&available, 5000) == NULL);
+        CHECK(available == pending.size());
+        const std::vector<uint32_t> expected = {1, 2, 4, 8, 16, 32, 50, 50, 50};
+        CHECK(delays == expected);
+        // The response is picked up within one interval of being ready
+        CHECK(rtcMs - readyAtMs < NOTE_C_I2C_POLL_MAX_MS);
+    }
+
+    SECTION("Without a hook, polling stops at the timeout") {
+        readyAtMs = UINT32_MAX;
+
+        const char *err = _i2cNoteQueryLength(&available, 10);
+        REQUIRE(err != NULL);
+        CHECK(strstr(err, "{io}") != NULL);
+        const std::vector<uint32_t> expected = {1, 2, 4, 3};
+        CHECK(delays == expected);
+        CHECK(rtcMs == 10);
+    }
+
+    SECTION("With a hook, the response is picked up when it is signalled") {
+        NoteSetFnWaitForData(waitForData);
+        readyAtMs = 123;
+
+        CHECK(_i2cNoteQueryLength(&available, 5000) == NULL);
+        CHECK(available == pending.size());
+        CHECK(rtcMs == readyAtMs);
+        CHECK(delays.empty());
+        // Two queries, one on either side of the wait
+        CHECK(waitForData_fake.call_count == 1);
+        CHECK(_noteI2CReceive_fake.call_count == 2);
+    }
+
+    SECTION("With a hook, each wait is bounded") {
+        NoteSetFnWaitForData(waitForData);
+        readyAtMs = 2500;
+
+        CHECK(_i2cNoteQueryLength(&available, 3000) == NULL);
+        const std::vector<uint32_t> expected = {NOTE_C_I2C_WAIT_MAX_MS, NOTE_C_I2C_WAIT_MAX_MS, 1000};
+        CHECK(waits == expected);
+        CHECK(delays.empty());
+
+        SECTION("By the timeout") {
+            available = 0;
+            waits.clear();
+            rtcMs = 0;
+            readyAtMs = UINT32_MAX;
+
+            CHECK(_i2cNoteQueryLength(&available, 300) != NULL);
+            CHECK(waits == std::vector<uint32_t> {300});
+        }
+    }
+
+    SECTION("A signal with no data behind it reverts to polling") {
+        NoteSetFnWaitForData(waitForData);
+        waitForData_fake.custom_fake = waitForDataStuck;
+        readyAtMs = 20;
+
+        CHECK(_i2cNoteQueryLength(&available, 5000) == NULL);
+        CHECK(waitForData_fake.call_count == 1);
+        const std::vector<uint32_t> expected = {1, 2, 4, 8, 16};
+        CHECK(delays == expected);
+    }
+
+    SECTION("The hook is not used unless I2C is active") {
+        NoteSetFnWaitForData(waitForData);
+        NoteSetFnDisabled();
+        bool ready = false;
+
+        CHECK(!_noteI2CWaitForData(100, &ready));
+        CHECK(waitForData_fake.call_count == 0);
+    }
+
+    SECTION("Chunked receive waits on the hook") {
+        NoteSetFnWaitForData(waitForData);
+        readyAtMs = 77;
+        uint8_t buf[16] = {0};
+        uint32_t size = sizeof(buf);
+
+        CHECK(_i2cChunkedReceive(buf, &size, true, 5000, &available) == NULL);
+        CHECK(std::string((const char *)buf, size) == "{}\n");
+        CHECK(rtcMs == readyAtMs);
+        CHECK(delays.empty());
+        CHECK(waitForData_fake.call_count == 1);
+    }
+
+    SECTION("Chunked receive polls without a hook") {
+        readyAtMs = 77;
+        uint8_t buf[16] = {0};
+        uint32_t size = sizeof(buf);
+
+        CHECK(_i2cChunkedReceive(buf, &size, true, 5000, &available) == NULL);
+        CHECK(std::string((const char *)buf, size) == "{}\n");
+        const std::vector<uint32_t> expected = {1, 2, 4, 8, 16, 32, 50};
+        CHECK(delays == expected);
+    }
+
+    NoteSetFnWaitForData(NULL);
+    RESET_FAKE(_noteI2CReceive);
+    RESET_FAKE(waitForData);
+    RESET_FAKE(NoteGetMs);
+    RESET_FAKE(NoteDelayMs);
+}
+
+}
@@ -0,0 +1,185 @@
+/*!
+ * @file NoteSetI2CBusSharing_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(const char *, _noteI2CTransmit, uint16_t, const uint8_t *, uint16_t)
+FAKE_VALUE_FUNC(const char *, _noteI2CReceive, uint16_t, uint8_t *, uint16_t, uint32_t *)
+FAKE_VALUE_FUNC(bool, _noteI2CReset, uint16_t)
+FAKE_VOID_FUNC(NoteLockI2C)
+FAKE_VOID_FUNC(NoteUnlockI2C)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+
+namespace
+{
+
+// L/U lock and unlock the bus, T and R transmit and receive, D delays
+std::string events;
+uint32_t rtcMs;
+std::string pending;
+int queries;
+
+void NoteLockI2CRecord(void)
+{
+    events += 'L';
+}
+
+void NoteUnlockI2CRecord(void)
+{
+    events += 'U';
+}
+
+void NoteDelayMsRecord(uint32_t ms)
+{
+    rtcMs += ms;
+    events += 'D';
+}
+
+uint32_t NoteGetMsMock(void)
+{
+    return rtcMs;
+}
+
+const char *_noteI2CTransmitRecord(uint16_t, const uint8_t *, uint16_t)
+{
+    events += 'T';
+    return NULL;
+}
+
+// The response is ready on the second query
+const char *_noteI2CReceiveRecord(uint16_t, uint8_t *buf, uint16_t size, uint32_t *available)
+{
+    events += 'R';
+    if (size == 0 && ++queries < 2) {
+        *available = 0;
+        return NULL;
+    }
+    memcpy(buf, pending.data(), size);
+    pending.erase(0, size);
+    *available = (uint32_t)pending.size();
+    return NULL;
+}
+
+// Whether every bus I/O happens with the bus locked, and no delay does
+bool everyIOLocked(void)
+{
+    bool locked = false;
+    for (char event : events) {
+        if (event == 'L') {
+            locked = true;
+        } else if (event == 'U') {
+            locked = false;
+        } else if (event == 'D' && locked) {
+            return false;
+        } else if ((event == 'T' || event == 'R') && !locked) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SCENARIO("NoteSetI2CBusSharing")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    events.clear();
+    rtcMs = 0;
+    pending = "{}\n";
+    queries = 0;
+    NoteLockI2C_fake.custom_fake = NoteLockI2CRecord;
+    NoteUnlockI2C_fake.custom_fake = NoteUnlockI2CRecord;
+    NoteDelayMs_fake.custom_fake = NoteDelayMsRecord;
+    NoteGetMs_fake.custom_fake = NoteGetMsMock;
+    _noteI2CTransmit_fake.custom_fake = _noteI2CTransmitRecord;
+    _noteI2CReceive_fake.custom_fake = _noteI2CReceiveRecord;
+    NoteSetI2CMtu(0);
+
+    const std::string request(100, 'a');
+    char *response = NULL;
+
+    SECTION("Bus sharing is off by default") {
+        bool enabled = true;
+        NoteGetI2CBusSharing(&enabled);
+        CHECK(!enabled);
+        NoteGetI2CBusSharing(NULL);
+    }
+
+    SECTION("Without bus sharing, the bus is held for the whole transaction") {
+        CHECK(_i2cNoteTransaction(request.c_str(), request.size(), &response, 5000) == NULL);
+        REQUIRE(response != NULL);
+        CHECK(std::string(response) == "{}\n");
+
+        CHECK(events.front() == 'L');
+        CHECK(events.back() == 'U');
+        CHECK(NoteLockI2C_fake.call_count == 1);
+        CHECK(NoteUnlockI2C_fake.call_count == 1);
+    }
+
+    SECTION("With bus sharing") {
+        NoteSetI2CBusSharing(true);
+        bool enabled = false;
+        NoteGetI2CBusSharing(&enabled);
+        CHECK(enabled);
+
+        SECTION("The bus is held only around each I/O") {
+            CHECK(_i2cNoteTransaction(request.c_str(), request.size(), &response, 5000) == NULL);
+            REQUIRE(response != NULL);
+            CHECK(std::string(response) == "{}\n");
+
+            CHECK(everyIOLocked());
+            // Four chunks transmitted, two queries and one read
+            CHECK(NoteLockI2C_fake.call_count == 7);
+            CHECK(NoteUnlockI2C_fake.call_count == 7);
+        }
+
+        SECTION("Chunked transfers hold the bus only around each I/O") {
+            uint8_t buf[16] = {0};
+            uint32_t size = sizeof(buf);
+            uint32_t available = 0;
+
+            CHECK(_i2cNoteChunkedTransmit((const uint8_t *)request.data(), request.size(), true) == NULL);
+            CHECK(_i2cNoteChunkedReceive(buf, &size, true, 5000, &available) == NULL);
+            CHECK(everyIOLocked());
+            CHECK(NoteLockI2C_fake.call_count == NoteUnlockI2C_fake.call_count);
+        }
+
+        SECTION("A transmit error resets the bus with it held") {
+            _noteI2CTransmit_fake.custom_fake = NULL;
+            _noteI2CTransmit_fake.return_val = "nack";
+            _noteI2CReset_fake.return_val = true;
+
+            CHECK(_i2cNoteTransaction(request.c_str(), request.size(), &response, 5000) != NULL);
+            CHECK(_noteI2CReset_fake.call_count == 1);
+            CHECK(events == "DLULU");
+        }
+
+        NoteSetI2CBusSharing(false);
+    }
+
+    _Free(response);
+    RESET_FAKE(_noteI2CTransmit);
+    RESET_FAKE(_noteI2CReceive);
+    RESET_FAKE(_noteI2CReset);
+    RESET_FAKE(NoteLockI2C);
+    RESET_FAKE(NoteUnlockI2C);
+    RESET_FAKE(NoteDelayMs);
+    RESET_FAKE(NoteGetMs);
+}
+
+}
@@ -0,0 +1,211 @@
+/*!
+ * @file NoteSetI2CPacing_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(const char *, _noteI2CTransmit, uint16_t, const uint8_t *, uint16_t)
+FAKE_VALUE_FUNC(bool, _noteEcho, size_t, uint32_t)
+FAKE_VALUE_FUNC(bool, NoteReset)
+FAKE_VALUE_FUNC(int, NoteGetActiveInterface)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+FAKE_VOID_FUNC(pacingSave, const NoteI2CPacing *)
+
+namespace
+{
+
+uint32_t sleptMs;
+NoteI2CPacing saved;
+
+// The emulated Notecard keeps up once the pause after each chunk is at least
+// this long
+uint16_t stableChunkDelayMs;
+
+void NoteDelayMsSum(uint32_t ms)
+{
+    sleptMs += ms;
+}
+
+bool _noteEchoStable(size_t, uint32_t)
+{
+    NoteI2CPacing pacing;
+    NoteGetI2CPacing(&pacing);
+    return (pacing.chunkDelayMs >= stableChunkDelayMs);
+}
+
+void pacingSaveCopy(const NoteI2CPacing *pacing)
+{
+    saved = *pacing;
+}
+
+SCENARIO("NoteSetI2CPacing")
+{
+    sleptMs = 0;
+    NoteDelayMs_fake.custom_fake = NoteDelayMsSum;
+    NoteSetI2CPacing(NULL);
+    NoteSetI2CMtu(0);
+
+    uint8_t buf[1000];
+    memset(buf, 'a', sizeof(buf));
+
+    SECTION("The default pacing") {
+        NoteI2CPacing pacing;
+        NoteGetI2CPacing(&pacing);
+        CHECK(pacing.ioDelayMs == CARD_REQUEST_I2C_IO_DELAY_MS);
+        CHECK(pacing.chunkDelayMs == CARD_REQUEST_I2C_CHUNK_DELAY_MS);
+        CHECK(pacing.segmentLen == CARD_REQUEST_I2C_SEGMENT_MAX_LEN);
+        CHECK(pacing.segmentDelayMs == CARD_REQUEST_I2C_SEGMENT_DELAY_MS);
+
+        CHECK(_i2cChunkedTransmit(buf, sizeof(buf), true) == NULL);
+
+        // 34 chunks of at most 30 bytes, with a segment pause after every
+        // 250 bytes
+        CHECK(_noteI2CTransmit_fake.call_count == 34);
+        CHECK(sleptMs == ((34 * (CARD_REQUEST_I2C_IO_DELAY_MS + CARD_REQUEST_I2C_CHUNK_DELAY_MS)) + (3 * CARD_REQUEST_I2C_SEGMENT_DELAY_MS)));
+    }
+
+    SECTION("The pacing is set and returned") {
+        NoteI2CPacing pacing = {1, 2, 500, 100};
+        NoteSetI2CPacing(&pacing);
+
+        NoteI2CPacing current;
+        NoteGetI2CPacing(&current);
+        CHECK(current.ioDelayMs == 1);
+        CHECK(current.chunkDelayMs == 2);
+        CHECK(current.segmentLen == 500);
+        CHECK(current.segmentDelayMs == 100);
+
+        CHECK(_i2cChunkedTransmit(buf, sizeof(buf), true) == NULL);
+        CHECK(sleptMs == ((34 * 3) + 100));
+    }
+
+    SECTION("A zero segment length selects the default") {
+        NoteI2CPacing pacing = {0, 0, 0, 0};
+        NoteSetI2CPacing(&pacing);
+
+        NoteI2CPacing current;
+        NoteGetI2CPacing(&current);
+        CHECK(current.segmentLen == CARD_REQUEST_I2C_SEGMENT_MAX_LEN);
+    }
+
+    SECTION("Zero pauses are skipped") {
+        NoteI2CPacing pacing = {0, 0, 0, 0};
+        NoteSetI2CPacing(&pacing);
+
+        CHECK(_i2cChunkedTransmit(buf, sizeof(buf), true) == NULL);
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    SECTION("Turbo I/O skips the pause before each I/O") {
+        cardTurboIO = true;
+
+        CHECK(_i2cChunkedTransmit(buf, sizeof(buf), true) == NULL);
+        CHECK(sleptMs == ((34 * CARD_REQUEST_I2C_CHUNK_DELAY_MS) + (3 * CARD_REQUEST_I2C_SEGMENT_DELAY_MS)));
+
+        cardTurboIO = false;
+    }
+
+    SECTION("NoteGetI2CPacing tolerates NULL") {
+        NoteGetI2CPacing(NULL);
+    }
+
+    SECTION("Calibration") {
+        NoteGetActiveInterface_fake.return_val = NOTE_C_INTERFACE_I2C;
+        _noteEcho_fake.custom_fake = _noteEchoStable;
+        pacingSave_fake.custom_fake = pacingSaveCopy;
+        NoteReset_fake.return_val = true;
+        saved = {};
+
+        SECTION("A Notecard that keeps up with no pauses") {
+            stableChunkDelayMs = 0;
+
+            CHECK(NoteCalibrateI2CPacing(pacingSave));
+            CHECK(_noteEcho_fake.call_count == NOTE_C_I2C_CALIBRATION_TRIALS);
+            CHECK(_noteEcho_fake.arg0_val == NOTE_C_I2C_CALIBRATION_LEN);
+            CHECK(NoteReset_fake.call_count == 0);
+            CHECK(saved.ioDelayMs == 0);
+            CHECK(saved.chunkDelayMs == 0);
+            CHECK(saved.segmentDelayMs == 0);
+            CHECK(saved.segmentLen == CARD_REQUEST_I2C_SEGMENT_MAX_LEN);
+        }
+
+        SECTION("Backs off until the Notecard keeps up") {
+            stableChunkDelayMs = 5;
+
+            CHECK(NoteCalibrateI2CPacing(pacingSave));
+            // No pauses, then 1/16 and 1/8 of the default pauses fail
+            CHECK(NoteReset_fake.call_count == 3);
+            CHECK(saved.ioDelayMs == (CARD_REQUEST_I2C_IO_DELAY_MS / 4));
+            CHECK(saved.chunkDelayMs == (CARD_REQUEST_I2C_CHUNK_DELAY_MS / 4));
+            CHECK(saved.segmentDelayMs == (CARD_REQUEST_I2C_SEGMENT_DELAY_MS / 4));
+
+            NoteI2CPacing current;
+            NoteGetI2CPacing(&current);
+            CHECK(current.chunkDelayMs == saved.chunkDelayMs);
+        }
+
+        SECTION("A failure on any trial backs off") {
+            bool echoes[] = {true, true, false, true, true, true};
+            SET_RETURN_SEQ(_noteEcho, echoes, 6);
+            _noteEcho_fake.custom_fake = NULL;
+
+            CHECK(NoteCalibrateI2CPacing(pacingSave));
+            CHECK(NoteReset_fake.call_count == 1);
+            CHECK(saved.chunkDelayMs == (CARD_REQUEST_I2C_CHUNK_DELAY_MS >> (NOTE_C_I2C_CALIBRATION_STEPS - 1)));
+        }
+
+        SECTION("The result need not be saved") {
+            stableChunkDelayMs = 0;
+
+            CHECK(NoteCalibrateI2CPacing(NULL));
+        }
+
+        SECTION("A Notecard that never answers") {
+            NoteI2CPacing previous = {1, 2, 3, 4};
+            NoteSetI2CPacing(&previous);
+            _noteEcho_fake.custom_fake = NULL;
+            _noteEcho_fake.return_val = false;
+
+            CHECK(!NoteCalibrateI2CPacing(pacingSave));
+            CHECK(NoteReset_fake.call_count == (NOTE_C_I2C_CALIBRATION_STEPS + 1));
+            CHECK(pacingSave_fake.call_count == 0);
+
+            NoteI2CPacing current;
+            NoteGetI2CPacing(&current);
+            CHECK(current.ioDelayMs == 1);
+            CHECK(current.chunkDelayMs == 2);
+            CHECK(current.segmentLen == 3);
+            CHECK(current.segmentDelayMs == 4);
+        }
+
+        SECTION("I2C is not active") {
+            NoteGetActiveInterface_fake.return_val = NOTE_C_INTERFACE_SERIAL;
+
+            CHECK(!NoteCalibrateI2CPacing(pacingSave));
+            CHECK(_noteEcho_fake.call_count == 0);
+        }
+    }
+
+    NoteSetI2CPacing(NULL);
+    RESET_FAKE(_noteI2CTransmit);
+    RESET_FAKE(_noteEcho);
+    RESET_FAKE(NoteReset);
+    RESET_FAKE(NoteGetActiveInterface);
+    RESET_FAKE(NoteDelayMs);
+    RESET_FAKE(pacingSave);
+}
+
+}
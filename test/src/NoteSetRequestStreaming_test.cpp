@@ -0,0 +1,181 @@
+/*!
+ * @file NoteSetRequestStreaming_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+#include <string>
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(void *, NoteMalloc, size_t)
+FAKE_VALUE_FUNC(bool, _noteHardReset)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VALUE_FUNC(const char *, _noteChunkedTransmit, const uint8_t *, uint32_t, bool)
+FAKE_VALUE_FUNC(const char *, _noteJSONTransaction, const char *, size_t, char **, uint32_t)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+
+namespace
+{
+
+std::string transmitted;
+uint32_t largestSegment;
+size_t largestAllocation;
+
+void *NoteMallocTracked(size_t size)
+{
+    largestAllocation = (size > largestAllocation) ? size : largestAllocation;
+    return malloc(size);
+}
+
+const char *_noteChunkedTransmitCapture(const uint8_t *buffer, uint32_t size, bool)
+{
+    transmitted.append(reinterpret_cast<const char *>(buffer), size);
+    largestSegment = (size > largestSegment) ? size : largestSegment;
+    return NULL;
+}
+
+const char *_noteJSONTransactionReceiveOnly(const char *, size_t reqLen, char **resp, uint32_t)
+{
+    static const char respString[] = "{\"total\":1}\n";
+
+    // The request must already have been streamed
+    if (reqLen != 0) {
+        return "request sent twice {io}";
+    }
+
+    if (resp) {
+        char *respBuf = reinterpret_cast<char *>(malloc(sizeof(respString)));
+        memcpy(respBuf, respString, sizeof(respString));
+        *resp = respBuf;
+    }
+
+    return NULL;
+}
+
+bool i2cReset(uint16_t)
+{
+    return true;
+}
+
+const char *i2cTransmit(uint16_t, uint8_t *, uint16_t)
+{
+    return NULL;
+}
+
+const char *i2cReceive(uint16_t, uint8_t *, uint16_t, uint32_t *)
+{
+    return NULL;
+}
+
+SCENARIO("NoteSetRequestStreaming")
+{
+    NoteMalloc_fake.custom_fake = NoteMallocTracked;
+    _noteHardReset_fake.return_val = true;
+    _noteTransactionStart_fake.return_val = true;
+    _noteChunkedTransmit_fake.custom_fake = _noteChunkedTransmitCapture;
+    _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionReceiveOnly;
+    transmitted.clear();
+    largestSegment = 0;
+
+    J *req = NoteNewRequest("note.add");
+    REQUIRE(req != NULL);
+    J *body = JAddObjectToObject(req, "body");
+    REQUIRE(body != NULL);
+    JAddStringToObject(body, "data", std::string(1000, 'x').c_str());
+    char *expected = JPrintUnformatted(req);
+    REQUIRE(expected != NULL);
+    const std::string expectedJson(expected);
+    JFree(expected);
+
+    SECTION("Streaming is disabled by default") {
+        CHECK(!NoteSetRequestStreaming(false));
+    }
+
+    SECTION("Requests are streamed in segments with a CRC") {
+        CHECK(!NoteSetRequestStreaming(true));
+        largestAllocation = 0;
+
+        J *rsp = NoteTransaction(req);
+
+        REQUIRE(rsp != NULL);
+        CHECK(!NoteResponseError(rsp));
+        CHECK(JGetInt(rsp, "total") == 1);
+        JDelete(rsp);
+
+        // The request is never held in memory in full
+        CHECK(largestAllocation < expectedJson.size());
+        CHECK(largestSegment <= CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN);
+        CHECK(_noteChunkedTransmit_fake.call_count > 1);
+        // Serial segments are paced by the transport, not between them
+        CHECK(NoteDelayMs_fake.call_count == 0);
+
+#ifndef NOTE_C_LOW_MEM
+        // The streamed bytes match the fully serialized request, with the CRC
+        // of the request appended
+        const size_t crcFieldLen = strlen(",\"crc\":\"SSSS:CCCCCCCC\"}\n");
+        REQUIRE(transmitted.size() == (expectedJson.size() - 1 + crcFieldLen));
+        CHECK(transmitted.compare(0, expectedJson.size() - 1, expectedJson, 0, expectedJson.size() - 1) == 0);
+        char crcHex[9];
+        _n_htoa32(_crc32Update(0, expectedJson.c_str(), expectedJson.size()), crcHex);
+        CHECK(transmitted.substr(transmitted.size() - 11, 8) == crcHex);
+#else
+        // The streamed bytes match the fully serialized request
+        CHECK(transmitted == (expectedJson + "\n"));
+#endif // !NOTE_C_LOW_MEM
+        CHECK(transmitted.back() == '\n');
+
+        NoteSetRequestStreaming(false);
+    }
+
+    SECTION("I2C segments are paced between them") {
+        NoteSetFnI2C(0, 0, i2cReset, i2cTransmit, i2cReceive);
+        NoteSetRequestStreaming(true);
+
+        JDelete(NoteTransaction(req));
+
+        CHECK(_noteChunkedTransmit_fake.call_count > 1);
+        CHECK(NoteDelayMs_fake.call_count == (_noteChunkedTransmit_fake.call_count - 1));
+
+        NoteSetRequestStreaming(false);
+        NoteSetFnDisabled();
+    }
+
+    SECTION("Commands are streamed without waiting for a response") {
+        NoteSetRequestStreaming(true);
+        J *cmd = NoteNewCommand("card.attn");
+        REQUIRE(cmd != NULL);
+
+        J *rsp = NoteTransaction(cmd);
+
+        REQUIRE(rsp != NULL);
+        CHECK(transmitted == "{\"cmd\":\"card.attn\"}\n");
+        CHECK(_noteJSONTransaction_fake.call_count == 0);
+        JDelete(rsp);
+        JDelete(cmd);
+
+        NoteSetRequestStreaming(false);
+    }
+
+    JDelete(req);
+
+    RESET_FAKE(NoteMalloc);
+    RESET_FAKE(_noteHardReset);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(_noteChunkedTransmit);
+    RESET_FAKE(_noteJSONTransaction);
+    RESET_FAKE(NoteDelayMs);
+}
+
+}
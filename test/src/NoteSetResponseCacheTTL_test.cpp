@@ -0,0 +1,267 @@
+/*!
+ * @file NoteSetResponseCacheTTL_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(J *, _noteTransactionShouldLockAndStart, J *, bool, bool)
+FAKE_VOID_FUNC(_noteLockNote)
+FAKE_VOID_FUNC(_noteUnlockNote)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(_noteTransactionStop)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+
+namespace
+{
+
+uint32_t clockMs = 1;
+
+// The order in which the Notecard is locked (L) and unlocked (U), and the
+// transaction window is opened (S) and closed (T)
+std::string calls;
+
+uint32_t NoteGetMsClock(void)
+{
+    return clockMs;
+}
+
+J *_noteTransactionShouldLockAndStartValid(J *req, bool, bool)
+{
+    J *rsp = JCreateObject();
+    JAddStringToObject(rsp, "echo", JGetString(req, "req"));
+    JAddIntToObject(rsp, "count", _noteTransactionShouldLockAndStart_fake.call_count);
+    return rsp;
+}
+
+J *_noteTransactionShouldLockAndStartError(J *, bool, bool)
+{
+    J *rsp = JCreateObject();
+    JAddStringToObject(rsp, "err", "not available");
+    return rsp;
+}
+
+void _noteLockNoteRecord(void)
+{
+    calls += 'L';
+}
+
+void _noteUnlockNoteRecord(void)
+{
+    calls += 'U';
+}
+
+bool _noteTransactionStartRecord(uint32_t)
+{
+    calls += 'S';
+    return true;
+}
+
+void _noteTransactionStopRecord(void)
+{
+    calls += 'T';
+}
+
+J *envGet(const char *name)
+{
+    J *req = NoteNewRequest("env.get");
+    JAddStringToObject(req, "name", name);
+    return req;
+}
+
+SCENARIO("NoteSetResponseCacheTTL")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    clockMs = 1;
+    NoteGetMs_fake.custom_fake = NoteGetMsClock;
+    _noteTransactionShouldLockAndStart_fake.custom_fake = _noteTransactionShouldLockAndStartValid;
+    _noteLockNote_fake.custom_fake = _noteLockNoteRecord;
+    _noteUnlockNote_fake.custom_fake = _noteUnlockNoteRecord;
+    _noteTransactionStart_fake.custom_fake = _noteTransactionStartRecord;
+    _noteTransactionStop_fake.custom_fake = _noteTransactionStopRecord;
+    calls.clear();
+
+    SECTION("Only read-only APIs are cacheable") {
+        CHECK(NoteSetResponseCacheTTL("card.version", 1000));
+        CHECK(NoteSetResponseCacheTTL("env.get", 1000));
+        CHECK_FALSE(NoteSetResponseCacheTTL("note.add", 1000));
+        CHECK_FALSE(NoteSetResponseCacheTTL(NULL, 1000));
+    }
+
+    SECTION("Responses aren't cached by default") {
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 2);
+    }
+
+    SECTION("A cached response is served until its TTL elapses") {
+        NoteSetResponseCacheTTL("card.version", 1000);
+
+        J *rsp1 = NoteRequestResponse(NoteNewRequest("card.version"));
+        clockMs += 999;
+        J *rsp2 = NoteRequestResponse(NoteNewRequest("card.version"));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 1);
+        REQUIRE(rsp1 != NULL);
+        REQUIRE(rsp2 != NULL);
+        CHECK(rsp1 != rsp2);
+        CHECK(JContainsString(rsp2, "echo", "card.version"));
+        CHECK(JGetInt(rsp2, "count") == 1);
+        CHECK(_noteLockNote_fake.call_count == _noteUnlockNote_fake.call_count);
+
+        clockMs += 1;
+        J *rsp3 = NoteRequestResponse(NoteNewRequest("card.version"));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 2);
+        CHECK(JGetInt(rsp3, "count") == 2);
+
+        JDelete(rsp1);
+        JDelete(rsp2);
+        JDelete(rsp3);
+    }
+
+    SECTION("The transaction window is opened before the Notecard is locked") {
+        NoteSetResponseCacheTTL("card.version", 1000);
+        calls.clear();
+
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+        CHECK(calls == "LUSLUT");
+        CHECK(_noteTransactionShouldLockAndStart_fake.arg1_val == false);
+        CHECK(_noteTransactionShouldLockAndStart_fake.arg2_val == false);
+
+        // A cached response doesn't wake the Notecard
+        calls.clear();
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+        CHECK(calls == "LU");
+
+        calls.clear();
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+        CHECK(calls == "SLUT");
+    }
+
+    SECTION("The Notecard isn't locked when it isn't ready") {
+        NoteSetResponseCacheTTL("card.version", 1000);
+        _noteTransactionStart_fake.custom_fake = NULL;
+        _noteTransactionStart_fake.return_val = false;
+        calls.clear();
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+        CHECK(NoteResponseErrorContains(rsp, c_ioerr));
+        CHECK(calls.empty());
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 0);
+        JDelete(rsp);
+    }
+
+    SECTION("Requests are cached by their arguments") {
+        NoteSetResponseCacheTTL("env.get", 1000);
+
+        JDelete(NoteRequestResponse(envGet("a")));
+        JDelete(NoteRequestResponse(envGet("b")));
+        JDelete(NoteRequestResponse(envGet("a")));
+        JDelete(NoteRequestResponse(envGet("b")));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 2);
+    }
+
+    SECTION("Requests with arguments that may change state aren't cached") {
+        NoteSetResponseCacheTTL("card.wireless", 1000);
+
+        J *req = NoteNewRequest("card.wireless");
+        JAddStringToObject(req, "mode", "auto");
+        JDelete(NoteRequestResponse(req));
+        req = NoteNewRequest("card.wireless");
+        JAddStringToObject(req, "mode", "auto");
+        JDelete(NoteRequestResponse(req));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 2);
+    }
+
+    SECTION("Requests that change state invalidate cached responses") {
+        NoteSetResponseCacheTTL("env.get", 1000);
+        NoteSetResponseCacheTTL("card.version", 1000);
+
+        JDelete(NoteRequestResponse(envGet("a")));
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+        J *req = NoteNewRequest("env.set");
+        JAddStringToObject(req, "name", "a");
+        JAddStringToObject(req, "text", "1");
+        JDelete(NoteRequestResponse(req));
+        JDelete(NoteRequestResponse(envGet("a")));
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 4);
+    }
+
+    SECTION("Error responses aren't cached") {
+        NoteSetResponseCacheTTL("hub.status", 1000);
+        _noteTransactionShouldLockAndStart_fake.custom_fake = _noteTransactionShouldLockAndStartError;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("hub.status")));
+        JDelete(NoteRequestResponse(NoteNewRequest("hub.status")));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 2);
+    }
+
+    SECTION("NoteInvalidateResponseCache discards cached responses") {
+        NoteSetResponseCacheTTL("card.time", 1000);
+        NoteSetResponseCacheTTL("card.version", 1000);
+
+        JDelete(NoteRequestResponse(NoteNewRequest("card.time")));
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+        NoteInvalidateResponseCache("card.time");
+        JDelete(NoteRequestResponse(NoteNewRequest("card.time")));
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 3);
+
+        NoteInvalidateResponseCache(NULL);
+        JDelete(NoteRequestResponse(NoteNewRequest("card.time")));
+        JDelete(NoteRequestResponse(NoteNewRequest("card.version")));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == 5);
+    }
+
+    SECTION("The oldest response is evicted when the cache is full") {
+        NoteSetResponseCacheTTL("env.get", 1000);
+
+        char name[8];
+        for (int i = 0 ; i <= NOTE_C_RESPONSE_CACHE_ENTRIES ; ++i) {
+            snprintf(name, sizeof(name), "v%d", i);
+            JDelete(NoteRequestResponse(envGet(name)));
+            clockMs++;
+        }
+        JDelete(NoteRequestResponse(envGet(name)));
+        JDelete(NoteRequestResponse(envGet("v0")));
+
+        CHECK(_noteTransactionShouldLockAndStart_fake.call_count == (NOTE_C_RESPONSE_CACHE_ENTRIES + 2));
+    }
+
+    NoteSetResponseCacheTTL("card.version", 0);
+    NoteSetResponseCacheTTL("hub.status", 0);
+    NoteSetResponseCacheTTL("card.time", 0);
+    NoteSetResponseCacheTTL("card.wireless", 0);
+    NoteSetResponseCacheTTL("env.get", 0);
+    RESET_FAKE(_noteTransactionShouldLockAndStart);
+    RESET_FAKE(_noteLockNote);
+    RESET_FAKE(_noteUnlockNote);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(_noteTransactionStop);
+    RESET_FAKE(NoteGetMs);
+}
+
+}
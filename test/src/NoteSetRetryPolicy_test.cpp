@@ -0,0 +1,233 @@
+/*!
+ * @file NoteSetRetryPolicy_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(char *, _crcAdd, char *, uint16_t)
+FAKE_VALUE_FUNC(bool, _crcError, char *, uint16_t)
+FAKE_VALUE_FUNC(bool, _noteHardReset)
+FAKE_VALUE_FUNC(const char *, _noteJSONTransaction, const char *, size_t, char **, uint32_t)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+FAKE_VALUE_FUNC(J *, NoteUserAgent)
+
+namespace
+{
+
+uint32_t clockMs = 0;
+
+void NoteDelayMsAdvance(uint32_t delayMs)
+{
+    clockMs += delayMs;
+}
+
+uint32_t NoteGetMsClock(void)
+{
+    return clockMs;
+}
+
+const char *respond(char **resp, const char *respString)
+{
+    if (resp) {
+        *resp = strdup(respString);
+    }
+    return NULL;
+}
+
+const char *_noteJSONTransactionIOError(const char *, size_t, char **resp, uint32_t)
+{
+    return respond(resp, "{\"err\":\"{io}\"}");
+}
+
+const char *_noteJSONTransactionBadBin(const char *, size_t, char **resp, uint32_t)
+{
+    return respond(resp, "{\"err\":\"binary mismatch {bad-bin}\"}");
+}
+
+const char *_noteJSONTransactionValid(const char *, size_t, char **resp, uint32_t)
+{
+    return respond(resp, "{\"total\":1}");
+}
+
+SCENARIO("NoteSetRetryPolicy")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    NoteSetRetryPolicy(NULL);
+    clockMs = 0;
+    NoteDelayMs_fake.custom_fake = NoteDelayMsAdvance;
+    NoteGetMs_fake.custom_fake = NoteGetMsClock;
+    _noteHardReset_fake.return_val = true;
+    _noteTransactionStart_fake.return_val = true;
+
+    NoteRetryPolicy policy;
+
+    SECTION("The default policy retries 5 times every 500 ms") {
+        NoteGetRetryPolicy(&policy);
+
+        CHECK(policy.initialDelayMs == 500);
+        CHECK(policy.maxDelayMs == 500);
+        CHECK(policy.deadlineMs == 0);
+        CHECK(policy.backoffFactor == 1);
+        CHECK(policy.jitterPercent == 0);
+        CHECK(policy.maxRetries == CARD_REQUEST_RETRIES_ALLOWED);
+        CHECK(policy.ioRetries == CARD_REQUEST_RETRIES_ALLOWED);
+        CHECK(policy.crcRetries == CARD_REQUEST_RETRIES_ALLOWED);
+        CHECK(policy.badBinRetries == 0);
+    }
+
+    SECTION("Passing NULL restores the default policy") {
+        policy = {100, 1000, 0, 2, 0, 1, 1, 1, 1};
+        NoteSetRetryPolicy(&policy);
+        NoteSetRetryPolicy(NULL);
+
+        NoteGetRetryPolicy(&policy);
+
+        CHECK(policy.initialDelayMs == 500);
+        CHECK(policy.badBinRetries == 0);
+    }
+
+    SECTION("The policy is normalized") {
+        policy = {1000, 10, 0, 0, 200, 5, 5, 5, 0};
+        NoteSetRetryPolicy(&policy);
+
+        NoteGetRetryPolicy(&policy);
+
+        CHECK(policy.initialDelayMs == 1000);
+        CHECK(policy.maxDelayMs == 1000);
+        CHECK(policy.backoffFactor == 1);
+        CHECK(policy.jitterPercent == 100);
+    }
+
+    SECTION("I/O errors are retried with exponential backoff") {
+        policy = {100, 1000, 0, 2, 0, 5, 5, 5, 0};
+        NoteSetRetryPolicy(&policy);
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionIOError;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+
+        CHECK(NoteResponseErrorContains(rsp, "{io}"));
+        CHECK(_noteJSONTransaction_fake.call_count == 6);
+        REQUIRE(NoteDelayMs_fake.call_count >= 5);
+        CHECK(NoteDelayMs_fake.arg0_history[0] == 100);
+        CHECK(NoteDelayMs_fake.arg0_history[1] == 200);
+        CHECK(NoteDelayMs_fake.arg0_history[2] == 400);
+        CHECK(NoteDelayMs_fake.arg0_history[3] == 800);
+        CHECK(NoteDelayMs_fake.arg0_history[4] == 1000);
+
+        JDelete(rsp);
+    }
+
+    SECTION("Jitter keeps the delay within its spread") {
+        policy = {1000, 1000, 0, 1, 50, 5, 5, 5, 0};
+        NoteSetRetryPolicy(&policy);
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionIOError;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+
+        REQUIRE(NoteDelayMs_fake.call_count >= 5);
+        for (unsigned int i = 0 ; i < 5 ; ++i) {
+            CHECK(NoteDelayMs_fake.arg0_history[i] >= 500);
+            CHECK(NoteDelayMs_fake.arg0_history[i] <= 1500);
+        }
+
+        JDelete(rsp);
+    }
+
+    SECTION("I/O errors have their own limit") {
+        policy = {100, 100, 0, 1, 0, 5, 2, 5, 0};
+        NoteSetRetryPolicy(&policy);
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionIOError;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+
+        CHECK(NoteResponseErrorContains(rsp, "{io}"));
+        CHECK(_noteJSONTransaction_fake.call_count == 3);
+
+        JDelete(rsp);
+    }
+
+#ifndef NOTE_C_LOW_MEM
+    SECTION("CRC errors have their own limit") {
+        policy = {100, 100, 0, 1, 0, 5, 5, 1, 0};
+        NoteSetRetryPolicy(&policy);
+        _crcAdd_fake.custom_fake = [](char *json, uint16_t) -> char * {
+            return strdup(json);
+        };
+        _crcError_fake.return_val = true;
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+
+        CHECK(NoteResponseErrorContains(rsp, "{io}"));
+        CHECK(_noteJSONTransaction_fake.call_count == 2);
+
+        JDelete(rsp);
+    }
+#endif // !NOTE_C_LOW_MEM
+
+    SECTION("Retries stop at the deadline") {
+        policy = {500, 500, 1200, 1, 0, 5, 5, 5, 0};
+        NoteSetRetryPolicy(&policy);
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionIOError;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+
+        CHECK(NoteResponseErrorContains(rsp, "{io}"));
+        CHECK(_noteJSONTransaction_fake.call_count == 3);
+        CHECK(clockMs < 1200);
+
+        JDelete(rsp);
+    }
+
+    SECTION("{bad-bin} errors are not retried by default") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionBadBin;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+
+        CHECK(NoteResponseErrorContains(rsp, "{bad-bin}"));
+        CHECK(_noteJSONTransaction_fake.call_count == 1);
+        CHECK(NoteDelayMs_fake.call_count == 0);
+
+        JDelete(rsp);
+    }
+
+    SECTION("{bad-bin} errors are retried when the policy allows") {
+        policy = {100, 100, 0, 1, 0, 5, 5, 5, 2};
+        NoteSetRetryPolicy(&policy);
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionBadBin;
+
+        J *rsp = NoteRequestResponse(NoteNewRequest("note.add"));
+
+        CHECK(NoteResponseErrorContains(rsp, "{bad-bin}"));
+        CHECK(_noteJSONTransaction_fake.call_count == 3);
+
+        JDelete(rsp);
+    }
+
+    NoteSetRetryPolicy(NULL);
+    RESET_FAKE(_crcAdd);
+    RESET_FAKE(_crcError);
+    RESET_FAKE(_noteHardReset);
+    RESET_FAKE(_noteJSONTransaction);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(NoteDelayMs);
+    RESET_FAKE(NoteGetMs);
+    RESET_FAKE(NoteUserAgent);
+}
+
+}
@@ -0,0 +1,172 @@
+/*!
+ * @file NoteSetSerialPacing_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VOID_FUNC(_noteSerialTransmit, const uint8_t *, size_t, bool)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+
+namespace
+{
+
+uint32_t nowMs;
+std::vector<size_t> segments;
+
+uint32_t NoteGetMsNow(void)
+{
+    return nowMs;
+}
+
+void NoteDelayMsAdvance(uint32_t ms)
+{
+    nowMs += ms;
+}
+
+void _noteSerialTransmitRecord(const uint8_t *, size_t size, bool)
+{
+    segments.push_back(size);
+}
+
+SCENARIO("NoteSetSerialPacing")
+{
+    nowMs = 0;
+    segments.clear();
+    NoteGetMs_fake.custom_fake = NoteGetMsNow;
+    NoteDelayMs_fake.custom_fake = NoteDelayMsAdvance;
+    _noteSerialTransmit_fake.custom_fake = _noteSerialTransmitRecord;
+    NoteSetSerialPacing(NULL);
+
+    uint8_t buf[1000];
+    memset(buf, 'a', sizeof(buf));
+
+    SECTION("The default pacing sends 250 bytes every 250 ms") {
+        NoteSerialPacing pacing;
+        NoteGetSerialPacing(&pacing);
+        CHECK(pacing.baudRate == 0);
+        CHECK(pacing.drainBytesPerSec == 1000);
+        CHECK(pacing.bufferLen == CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN);
+        CHECK(!pacing.flowControl);
+
+        CHECK(_serialChunkedTransmit(buf, sizeof(buf), true) == NULL);
+
+        CHECK(segments == std::vector<size_t>({250, 250, 250, 250}));
+        CHECK(NoteDelayMs_fake.call_count == 3);
+        CHECK(NoteDelayMs_fake.arg0_history[0] == CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS);
+        CHECK(nowMs == (3 * CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS));
+    }
+
+    SECTION("The pacing is set and returned") {
+        NoteSerialPacing pacing = {115200, 4000, 128, false};
+        NoteSetSerialPacing(&pacing);
+
+        NoteSerialPacing current;
+        NoteGetSerialPacing(&current);
+        CHECK(current.baudRate == 115200);
+        CHECK(current.drainBytesPerSec == 4000);
+        CHECK(current.bufferLen == 128);
+        CHECK(!current.flowControl);
+    }
+
+    SECTION("The default drain rate is used if not given, whatever the baud rate") {
+        NoteSerialPacing pacing = {115200, 0, 0, false};
+        NoteSetSerialPacing(&pacing);
+
+        NoteGetSerialPacing(&pacing);
+        CHECK(pacing.drainBytesPerSec == 1000);
+        CHECK(pacing.bufferLen == CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN);
+
+        CHECK(_serialChunkedTransmit(buf, sizeof(buf), true) == NULL);
+
+        CHECK(NoteDelayMs_fake.call_count == 3);
+        CHECK(nowMs == (3 * CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS));
+    }
+
+    SECTION("Segments are sized to the Notecard's buffer") {
+        NoteSerialPacing pacing = {0, 1000, 100, false};
+        NoteSetSerialPacing(&pacing);
+
+        CHECK(_serialChunkedTransmit(buf, 250, true) == NULL);
+
+        CHECK(segments == std::vector<size_t>({100, 100, 50}));
+        CHECK(NoteDelayMs_fake.arg0_history[0] == 100);
+        CHECK(NoteDelayMs_fake.arg0_history[1] == 50);
+    }
+
+    SECTION("A faster drain rate shortens the pauses") {
+        NoteSerialPacing pacing = {0, 5000, 250, false};
+        NoteSetSerialPacing(&pacing);
+
+        CHECK(_serialChunkedTransmit(buf, sizeof(buf), true) == NULL);
+
+        CHECK(NoteDelayMs_fake.call_count == 3);
+        CHECK(nowMs == 150);
+    }
+
+    SECTION("Time spent elsewhere counts towards the pauses") {
+        CHECK(_serialChunkedTransmit(buf, 250, true) == NULL);
+        nowMs += 200;
+
+        CHECK(_serialChunkedTransmit(buf, 250, true) == NULL);
+
+        CHECK(NoteDelayMs_fake.call_count == 1);
+        CHECK(NoteDelayMs_fake.arg0_val == 50);
+    }
+
+    SECTION("No pauses are made with hardware flow control") {
+        NoteSerialPacing pacing = {115200, 0, 0, true};
+        NoteSetSerialPacing(&pacing);
+
+        CHECK(_serialChunkedTransmit(buf, sizeof(buf), true) == NULL);
+
+        CHECK(segments.size() == 4);
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    SECTION("No pauses are made when the port is slower than the Notecard") {
+        NoteSerialPacing pacing = {9600, 1000, 0, false};
+        NoteSetSerialPacing(&pacing);
+
+        CHECK(_serialChunkedTransmit(buf, sizeof(buf), true) == NULL);
+
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    SECTION("No pauses are made when delays are not respected") {
+        CHECK(_serialChunkedTransmit(buf, sizeof(buf), false) == NULL);
+
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    SECTION("The Notecard's buffer is empty once it responds") {
+        CHECK(_serialChunkedTransmit(buf, 250, true) == NULL);
+
+        _serialPacingReset();
+
+        CHECK(_serialChunkedTransmit(buf, 250, true) == NULL);
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    NoteSetSerialPacing(NULL);
+    RESET_FAKE(_noteSerialTransmit);
+    RESET_FAKE(NoteDelayMs);
+    RESET_FAKE(NoteGetMs);
+}
+
+}
@@ -0,0 +1,180 @@
+/*!
+ * @file NoteTraceRead_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+#ifdef NOTE_C_TRACE
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(const char *, _noteJSONTransaction, const char *, size_t, char **, uint32_t)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+FAKE_VALUE_FUNC(J *, NoteUserAgent)
+
+namespace
+{
+
+uint32_t clockUs = 0;
+std::string debugOutput;
+
+uint32_t traceClock(void)
+{
+    return clockUs;
+}
+
+size_t debugOutputCapture(const char *text)
+{
+    debugOutput += text;
+    return strlen(text);
+}
+
+const char *_noteJSONTransactionValid(const char *, size_t, char **resp, uint32_t)
+{
+    clockUs += 1500;
+    if (resp) {
+        *resp = strdup("{\"total\":1}");
+    }
+    return NULL;
+}
+
+const char *_noteJSONTransactionIOError(const char *, size_t, char **resp, uint32_t)
+{
+    if (resp) {
+        *resp = strdup("{\"err\":\"{io}\"}");
+    }
+    return NULL;
+}
+
+SCENARIO("NoteTraceRead")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    NoteSetTraceClock(traceClock);
+    NoteTraceClear();
+    clockUs = 0;
+    resetRequired = false;
+    _noteTransactionStart_fake.return_val = true;
+
+    NoteTraceEvent events[NOTE_C_TRACE_EVENTS];
+
+    SECTION("Transactions are recorded with the API and their duration") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        REQUIRE(NoteTraceRead(events, NOTE_C_TRACE_EVENTS) == 2);
+        CHECK(events[0].type == NOTE_C_TRACE_TXN_START);
+        CHECK(events[0].arg == _noteApiIndex(_noteApiLookup("note.add")));
+        CHECK(events[0].timeUs == 0);
+        CHECK(events[1].type == NOTE_C_TRACE_TXN_STOP);
+        CHECK(events[1].arg == 0);
+        CHECK(events[1].timeUs == 1500);
+    }
+
+    SECTION("Unknown APIs are recorded without an index") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("test.api")));
+
+        REQUIRE(NoteTraceRead(events, NOTE_C_TRACE_EVENTS) == 2);
+        CHECK(events[0].arg == 0xFFFF);
+    }
+
+    SECTION("Retries are recorded") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionIOError;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        const size_t count = NoteTraceRead(events, NOTE_C_TRACE_EVENTS);
+        REQUIRE(count == (CARD_REQUEST_RETRIES_ALLOWED + 2));
+        for (size_t i = 1 ; i < (count - 1) ; ++i) {
+            CHECK(events[i].type == NOTE_C_TRACE_RETRY);
+        }
+        CHECK(events[count - 1].type == NOTE_C_TRACE_TXN_STOP);
+        CHECK(events[count - 1].arg == 1);
+    }
+
+    SECTION("Resets of the I/O interface are recorded") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+        resetRequired = true;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        REQUIRE(NoteTraceRead(events, NOTE_C_TRACE_EVENTS) == 3);
+        CHECK(events[1].type == NOTE_C_TRACE_RESET);
+        CHECK(events[1].arg == 1);
+    }
+
+    SECTION("The ring keeps the most recent events") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        for (int i = 0 ; i <= (NOTE_C_TRACE_EVENTS / 2) ; ++i) {
+            JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+        }
+
+        REQUIRE(NoteTraceRead(events, NOTE_C_TRACE_EVENTS) == NOTE_C_TRACE_EVENTS);
+        CHECK(events[0].type == NOTE_C_TRACE_TXN_START);
+        CHECK(events[0].timeUs == 1500);
+        CHECK(events[NOTE_C_TRACE_EVENTS - 1].type == NOTE_C_TRACE_TXN_STOP);
+        CHECK(events[NOTE_C_TRACE_EVENTS - 1].timeUs == (1500 * ((NOTE_C_TRACE_EVENTS / 2) + 1)));
+    }
+
+    SECTION("Only as many events as requested are copied") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        CHECK(NoteTraceRead(events, 1) == 1);
+        CHECK(events[0].type == NOTE_C_TRACE_TXN_START);
+        CHECK(NoteTraceRead(NULL, NOTE_C_TRACE_EVENTS) == 0);
+    }
+
+    SECTION("NoteTraceClear discards the events") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+        JDelete(NoteRequestResponse(NoteNewRequest("note.add")));
+
+        NoteTraceClear();
+
+        CHECK(NoteTraceRead(events, NOTE_C_TRACE_EVENTS) == 0);
+    }
+
+    SECTION("NoteTraceDump writes the events to the debug output") {
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionValid;
+        JDelete(NoteRequestResponse(NoteNewRequest("test.api")));
+        debugOutput.clear();
+        NoteSetFnDebugOutput(debugOutputCapture);
+
+        NoteTraceDump();
+
+        NoteSetFnDebugOutput(NULL);
+        CHECK(debugOutput.find("notetrace 00000000 0001 FFFF") != std::string::npos);
+        CHECK(debugOutput.find("notetrace 000005DC 0002 0000") != std::string::npos);
+    }
+
+    NoteSetTraceClock(NULL);
+    NoteTraceClear();
+    RESET_FAKE(_noteJSONTransaction);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(NoteDelayMs);
+    RESET_FAKE(NoteGetMs);
+    RESET_FAKE(NoteUserAgent);
+}
+
+}
+
+#endif // NOTE_C_TRACE
@@ -0,0 +1,157 @@
+/*!
+ * @file NoteTransactionBegin_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(bool, _noteHardReset)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(_noteTransactionStop)
+FAKE_VOID_FUNC(_noteLockNote)
+FAKE_VOID_FUNC(_noteUnlockNote)
+FAKE_VALUE_FUNC(char *, JPrintUnformatted, const J *)
+
+namespace
+{
+
+char *JPrintUnformattedMalloc(const J *)
+{
+    return strdup("{\"req\":\"card.version\"}");
+}
+
+SCENARIO("NoteTransactionBegin")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    // Ignore the locking performed while setting the hooks
+    RESET_FAKE(_noteLockNote);
+    RESET_FAKE(_noteUnlockNote);
+    _noteHardReset_fake.return_val = true;
+    _noteTransactionStart_fake.return_val = true;
+    JPrintUnformatted_fake.custom_fake = JPrintUnformattedMalloc;
+    resetRequired = false;
+
+    SECTION("A NULL request is rejected") {
+        CHECK(!NoteTransactionBegin(NULL));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+        CHECK(_noteTransactionStart_fake.call_count == 0);
+    }
+
+    SECTION("A request with neither req nor cmd is rejected") {
+        J *req = JCreateObject();
+
+        CHECK(!NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+
+        JDelete(req);
+    }
+
+    SECTION("A request with both req and cmd is rejected") {
+        J *req = NoteNewRequest("card.version");
+        JAddStringToObject(req, "cmd", "card.version");
+
+        CHECK(!NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+
+        JDelete(req);
+    }
+
+    SECTION("A request that can't be serialized is rejected") {
+        J *req = NoteNewRequest("card.version");
+        JPrintUnformatted_fake.custom_fake = NULL;
+        JPrintUnformatted_fake.return_val = NULL;
+
+        CHECK(!NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+        CHECK(_noteTransactionStart_fake.call_count == 0);
+
+        JDelete(req);
+    }
+
+    SECTION("The lock and transaction window are taken and held") {
+        J *req = NoteNewRequest("card.version");
+
+        REQUIRE(NoteTransactionBegin(req));
+        JDelete(req);
+
+        CHECK(_noteTransactionStart_fake.call_count == 1);
+        CHECK(_noteLockNote_fake.call_count == 1);
+        CHECK(_noteUnlockNote_fake.call_count == 0);
+        CHECK(_noteTransactionStop_fake.call_count == 0);
+
+        AND_THEN("A second transaction can't be begun while it is in flight") {
+            J *req2 = NoteNewRequest("card.version");
+
+            CHECK(!NoteTransactionBegin(req2));
+            CHECK(_noteTransactionStart_fake.call_count == 1);
+
+            JDelete(req2);
+        }
+
+        // Abandon the transaction, which releases the Notecard
+        J *rsp = NoteTransactionEnd();
+        CHECK(NoteResponseErrorContains(rsp, c_ioerr));
+        CHECK(_noteUnlockNote_fake.call_count == 1);
+        CHECK(_noteTransactionStop_fake.call_count == 1);
+        CHECK(resetRequired);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+        JDelete(rsp);
+    }
+
+    SECTION("The transaction completes at once with an error if the Notecard isn't ready") {
+        _noteTransactionStart_fake.return_val = false;
+        J *req = NoteNewRequest("card.version");
+        JAddIntToObject(req, "id", 7);
+
+        REQUIRE(NoteTransactionBegin(req));
+        JDelete(req);
+
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+        CHECK(_noteLockNote_fake.call_count == 0);
+        J *rsp = NoteTransactionEnd();
+        CHECK(NoteResponseErrorContains(rsp, c_ioerr));
+        CHECK(JGetInt(rsp, "id") == 7);
+        JDelete(rsp);
+    }
+
+    SECTION("The transaction completes at once with an error if the reset fails") {
+        resetRequired = true;
+        _noteHardReset_fake.return_val = false;
+        J *req = NoteNewRequest("card.version");
+
+        REQUIRE(NoteTransactionBegin(req));
+        JDelete(req);
+
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+        CHECK(_noteUnlockNote_fake.call_count == _noteLockNote_fake.call_count);
+        CHECK(_noteTransactionStop_fake.call_count == 1);
+        J *rsp = NoteTransactionEnd();
+        CHECK(NoteResponseErrorContains(rsp, c_ioerr));
+        JDelete(rsp);
+    }
+
+    SECTION("Ending without a transaction returns NULL") {
+        CHECK(NoteTransactionEnd() == NULL);
+    }
+
+    RESET_FAKE(_noteHardReset);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(_noteTransactionStop);
+    RESET_FAKE(_noteLockNote);
+    RESET_FAKE(_noteUnlockNote);
+    RESET_FAKE(JPrintUnformatted);
+}
+
+}
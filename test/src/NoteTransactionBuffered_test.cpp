@@ -0,0 +1,221 @@
+/*!
+ * @file NoteTransactionBuffered_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+#include <string>
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(void *, NoteMalloc, size_t)
+FAKE_VALUE_FUNC(bool, _noteHardReset)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(_noteTransactionStop)
+FAKE_VALUE_FUNC(const char *, _noteChunkedTransmit, const uint8_t *, uint32_t, bool)
+FAKE_VALUE_FUNC(const char *, _noteChunkedReceive, uint8_t *, uint32_t *, bool, uint32_t, uint32_t *)
+FAKE_VOID_FUNC(NoteDebugWithLevel, uint8_t, const char *)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+
+namespace
+{
+
+std::string transmitted;
+const char *responses[4];
+
+const char *_noteChunkedTransmitCapture(const uint8_t *buffer, uint32_t size, bool)
+{
+    transmitted.assign(reinterpret_cast<const char *>(buffer), size);
+    return NULL;
+}
+
+// Deliver the canned response matching the receive call number
+const char *_noteChunkedReceiveCanned(uint8_t *buffer, uint32_t *size, bool, uint32_t, uint32_t *available)
+{
+    const char *rsp = responses[_noteChunkedReceive_fake.call_count - 1];
+    const uint32_t rspLen = strlen(rsp);
+    if (rspLen > *size) {
+        memcpy(buffer, rsp, *size);
+        *available = (rspLen - *size);
+        return NULL;
+    }
+    memcpy(buffer, rsp, rspLen);
+    *size = rspLen;
+    *available = 0;
+    return NULL;
+}
+
+SCENARIO("NoteTransactionBuffered")
+{
+    NoteMalloc_fake.custom_fake = malloc;
+    _noteHardReset_fake.return_val = true;
+    _noteTransactionStart_fake.return_val = true;
+    _noteChunkedTransmit_fake.custom_fake = _noteChunkedTransmitCapture;
+    _noteChunkedReceive_fake.custom_fake = _noteChunkedReceiveCanned;
+    resetRequired = false;
+    transmitted.clear();
+    responses[0] = "{\"total\":1}\r\n";
+
+    uint8_t scratch[256];
+    J *req = NoteNewRequest("note.add");
+    REQUIRE(req != NULL);
+    JAddStringToObject(req, "file", "data.qo");
+    NoteMalloc_fake.call_count = 0;
+
+    SECTION("Invalid parameters are rejected") {
+        CHECK(NoteTransactionBuffered(NULL, scratch, sizeof(scratch)) != NULL);
+        CHECK(NoteTransactionBuffered(req, NULL, sizeof(scratch)) != NULL);
+        CHECK(NoteTransactionBuffered(req, scratch, 2) != NULL);
+        CHECK(_noteTransactionStart_fake.call_count == 0);
+    }
+
+    SECTION("A request without req or cmd is rejected") {
+        J *empty = JCreateObject();
+        REQUIRE(empty != NULL);
+
+        CHECK(NoteTransactionBuffered(empty, scratch, sizeof(scratch)) != NULL);
+        CHECK(_noteChunkedTransmit_fake.call_count == 0);
+
+        JDelete(empty);
+    }
+
+    SECTION("The response is received into the scratch buffer") {
+        CHECK(NoteTransactionBuffered(req, scratch, sizeof(scratch)) == NULL);
+
+        CHECK(strcmp(reinterpret_cast<char *>(scratch), "{\"total\":1}") == 0);
+        CHECK(transmitted.find("\"req\":\"note.add\"") != std::string::npos);
+#ifndef NOTE_C_LOW_MEM
+        CHECK(transmitted.find("\"crc\":\"") != std::string::npos);
+#endif
+        CHECK(transmitted.back() == '\n');
+        CHECK(_noteTransactionStop_fake.call_count == 1);
+    }
+
+    SECTION("Transactions do not allocate") {
+        for (size_t i = 0 ; i < 10 ; ++i) {
+            _noteChunkedReceive_fake.call_count = 0;
+            CHECK(NoteTransactionBuffered(req, scratch, sizeof(scratch)) == NULL);
+        }
+
+        CHECK(_noteChunkedTransmit_fake.call_count == 10);
+        CHECK(NoteMalloc_fake.call_count == 0);
+    }
+
+    SECTION("Commands transmit only and leave an empty object") {
+        J *cmd = NoteNewCommand("card.attn");
+        REQUIRE(cmd != NULL);
+        NoteMalloc_fake.call_count = 0;
+
+        CHECK(NoteTransactionBuffered(cmd, scratch, sizeof(scratch)) == NULL);
+
+        CHECK(strcmp(reinterpret_cast<char *>(scratch), "{}") == 0);
+        CHECK(transmitted.find("\"crc\"") == std::string::npos);
+        CHECK(_noteChunkedReceive_fake.call_count == 0);
+        CHECK(NoteMalloc_fake.call_count == 0);
+
+        JDelete(cmd);
+    }
+
+    SECTION("A request that does not fit is not transmitted") {
+        CHECK(NoteTransactionBuffered(req, scratch, 16) != NULL);
+
+        CHECK(_noteChunkedTransmit_fake.call_count == 0);
+        CHECK(_noteTransactionStop_fake.call_count == 1);
+    }
+
+    SECTION("A response that does not fit queues a reset") {
+        responses[0] = "{\"total\":1,\"padding\":\"0123456789012345678901234567890123456789012345678901234567890123456789\"}\n";
+
+        const char *err = NoteTransactionBuffered(req, scratch, 64);
+
+        REQUIRE(err != NULL);
+        CHECK(NoteErrorContains(err, c_mem));
+        CHECK(resetRequired);
+    }
+
+    SECTION("An {io} error in the response is retried") {
+        responses[0] = "{\"err\":\"{io}\"}\n";
+        responses[1] = "{\"total\":2}\n";
+
+        CHECK(NoteTransactionBuffered(req, scratch, sizeof(scratch)) == NULL);
+
+        CHECK(strcmp(reinterpret_cast<char *>(scratch), "{\"total\":2}") == 0);
+        CHECK(_noteChunkedTransmit_fake.call_count == 2);
+        CHECK(NoteMalloc_fake.call_count == 0);
+    }
+
+    SECTION("Other Notecard errors are returned in the response") {
+        responses[0] = "{\"err\":\"no such file\"}\n";
+
+        CHECK(NoteTransactionBuffered(req, scratch, sizeof(scratch)) == NULL);
+
+        CHECK(NoteErrorContains(reinterpret_cast<char *>(scratch), "no such file"));
+        CHECK(_noteChunkedTransmit_fake.call_count == 1);
+    }
+
+    SECTION("Heartbeats continue receiving without retransmitting") {
+        responses[0] = "{\"err\":\"{heartbeat}\",\"status\":\"testing stsafe\"}\n";
+        responses[1] = "{\"total\":3}\n";
+
+        CHECK(NoteTransactionBuffered(req, scratch, sizeof(scratch)) == NULL);
+
+        CHECK(strcmp(reinterpret_cast<char *>(scratch), "{\"total\":3}") == 0);
+        CHECK(_noteChunkedTransmit_fake.call_count == 1);
+        CHECK(_noteChunkedReceive_fake.call_count == 2);
+    }
+
+#ifdef NOTE_C_HEARTBEAT_CALLBACK
+    SECTION("The heartbeat callback receives the heartbeat status") {
+        static char receivedHeartbeat[sizeof("testing stsafe")];
+        auto heartbeatCallback = [](const char *heartbeatJson, void *) -> bool {
+            strlcpy(receivedHeartbeat, heartbeatJson, sizeof(receivedHeartbeat));
+            return false;
+        };
+        NoteSetFnHeartbeat(heartbeatCallback, NULL);
+        receivedHeartbeat[0] = '\0';
+        responses[0] = "{\"err\":\"{heartbeat}\",\"status\":\"testing stsafe\"}\n";
+        responses[1] = "{\"total\":3}\n";
+
+        CHECK(NoteTransactionBuffered(req, scratch, sizeof(scratch)) == NULL);
+
+        CHECK(strcmp(receivedHeartbeat, "testing stsafe") == 0);
+        NoteSetFnHeartbeat(NULL, NULL);
+    }
+#endif // NOTE_C_HEARTBEAT_CALLBACK
+
+    SECTION("Transport errors are retried until the limit is reached") {
+        _noteChunkedReceive_fake.custom_fake = NULL;
+        _noteChunkedReceive_fake.return_val = "timeout {io}";
+
+        const char *err = NoteTransactionBuffered(req, scratch, sizeof(scratch));
+
+        REQUIRE(err != NULL);
+        CHECK(NoteErrorContains(err, c_ioerr));
+        CHECK(_noteChunkedTransmit_fake.call_count == (CARD_REQUEST_RETRIES_ALLOWED + 1));
+        CHECK(resetRequired);
+    }
+
+    JDelete(req);
+
+    RESET_FAKE(NoteMalloc);
+    RESET_FAKE(_noteHardReset);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(_noteTransactionStop);
+    RESET_FAKE(_noteChunkedTransmit);
+    RESET_FAKE(_noteChunkedReceive);
+    RESET_FAKE(NoteDebugWithLevel);
+    RESET_FAKE(NoteDelayMs);
+}
+
+}
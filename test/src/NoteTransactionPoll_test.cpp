@@ -0,0 +1,326 @@
+/*!
+ * @file NoteTransactionPoll_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+#include <string>
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(int, NoteGetActiveInterface)
+FAKE_VALUE_FUNC(bool, _noteHardReset)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(_noteTransactionStop)
+FAKE_VALUE_FUNC(const char *, _noteChunkedTransmit, const uint8_t *, uint32_t, bool)
+FAKE_VALUE_FUNC(bool, _noteSerialAvailable)
+FAKE_VALUE_FUNC(char, _noteSerialReceive)
+FAKE_VALUE_FUNC(const char *, _noteI2CReceive, uint16_t, uint8_t *, uint16_t, uint32_t *)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+
+#ifndef NOTE_C_LOW_MEM
+extern bool notecardFirmwareSupportsCrc;
+#endif
+
+namespace
+{
+
+uint32_t nowMs;
+std::string transmitted;
+std::string rxData;     // Bytes the Notecard will send
+size_t rxVisible;       // How many of them have arrived so far
+size_t rxOffset;        // How many of them have been read
+
+uint32_t NoteGetMsNow(void)
+{
+    return nowMs;
+}
+
+const char *_noteChunkedTransmitCapture(const uint8_t *buffer, uint32_t size, bool)
+{
+    transmitted.append(reinterpret_cast<const char *>(buffer), size);
+    return NULL;
+}
+
+bool _noteSerialAvailableData(void)
+{
+    return (rxOffset < rxVisible);
+}
+
+char _noteSerialReceiveData(void)
+{
+    return rxData[rxOffset++];
+}
+
+const char *_noteI2CReceiveData(uint16_t, uint8_t *buffer, uint16_t size, uint32_t *available)
+{
+    memcpy(buffer, rxData.data() + rxOffset, size);
+    rxOffset += size;
+    *available = (rxVisible - rxOffset);
+    return NULL;
+}
+
+// Let the Notecard send everything it has been given
+void arrive(const char *rsp)
+{
+    rxData += rsp;
+    rxVisible = rxData.size();
+}
+
+int pollFor(uint32_t ms)
+{
+    int status = NoteTransactionPoll();
+    for (uint32_t end = (nowMs + ms) ; status == NOTE_C_TXN_IN_PROGRESS && nowMs < end ; nowMs += 10) {
+        status = NoteTransactionPoll();
+    }
+    return status;
+}
+
+SCENARIO("NoteTransactionPoll")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    NoteGetActiveInterface_fake.return_val = NOTE_C_INTERFACE_SERIAL;
+    NoteGetMs_fake.custom_fake = NoteGetMsNow;
+    _noteHardReset_fake.return_val = true;
+    _noteTransactionStart_fake.return_val = true;
+    _noteChunkedTransmit_fake.custom_fake = _noteChunkedTransmitCapture;
+    _noteSerialAvailable_fake.custom_fake = _noteSerialAvailableData;
+    _noteSerialReceive_fake.custom_fake = _noteSerialReceiveData;
+    _noteI2CReceive_fake.custom_fake = _noteI2CReceiveData;
+    resetRequired = false;
+#ifndef NOTE_C_LOW_MEM
+    notecardFirmwareSupportsCrc = false;
+#endif
+    nowMs = 1000;
+    transmitted.clear();
+    rxData.clear();
+    rxVisible = 0;
+    rxOffset = 0;
+
+    J *req = NoteNewRequest("note.add");
+    REQUIRE(req != NULL);
+    JAddStringToObject(req, "file", "data.qo");
+
+    SECTION("Polling without a transaction reports idle") {
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+    }
+
+    SECTION("The response is collected across polls without blocking") {
+        REQUIRE(NoteTransactionBegin(req));
+
+        // The request goes out on the first poll
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(transmitted.find("\"req\":\"note.add\"") != std::string::npos);
+        CHECK(transmitted.back() == '\n');
+
+        // A partial response leaves the transaction in progress
+        rxData = "{\"total\":";
+        rxVisible = rxData.size();
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        arrive("1}\r\n");
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+
+        J *rsp = NoteTransactionEnd();
+        REQUIRE(rsp != NULL);
+        CHECK(!NoteResponseError(rsp));
+        CHECK(JGetInt(rsp, "total") == 1);
+        JDelete(rsp);
+
+        CHECK(NoteDelayMs_fake.call_count == 0);
+        CHECK(_noteTransactionStop_fake.call_count == 1);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+    }
+
+    SECTION("Long requests are sent in segments, pausing between polls") {
+        std::string body(600, 'x');
+        JAddStringToObject(req, "payload", body.c_str());
+        REQUIRE(NoteTransactionBegin(req));
+
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(_noteChunkedTransmit_fake.call_count == 1);
+        CHECK(_noteChunkedTransmit_fake.arg1_val == CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN);
+
+        // Nothing more is sent until the segment delay has elapsed
+        nowMs += (CARD_REQUEST_SERIAL_SEGMENT_DELAY_MS - 1);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(_noteChunkedTransmit_fake.call_count == 1);
+        nowMs += 1;
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(_noteChunkedTransmit_fake.call_count == 2);
+
+        arrive("{}\r\n");
+        CHECK(pollFor(1000) == NOTE_C_TXN_COMPLETE);
+        CHECK(_noteChunkedTransmit_fake.call_count == 3);
+        CHECK(transmitted.find(body) != std::string::npos);
+
+        JDelete(NoteTransactionEnd());
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    SECTION("A command completes once it has been sent") {
+        J *cmd = NoteNewCommand("card.attn");
+        REQUIRE(NoteTransactionBegin(cmd));
+        JDelete(cmd);
+
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+        J *rsp = NoteTransactionEnd();
+        REQUIRE(rsp != NULL);
+        CHECK(!NoteResponseError(rsp));
+        JDelete(rsp);
+    }
+
+    SECTION("Heartbeats keep the transaction waiting without resending") {
+        REQUIRE(NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        arrive("{\"err\":\"{heartbeat}\",\"status\":\"testing\"}\r\n");
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        arrive("{\"total\":2}\r\n");
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+        CHECK(_noteChunkedTransmit_fake.call_count == 1);
+
+        J *rsp = NoteTransactionEnd();
+        CHECK(JGetInt(rsp, "total") == 2);
+        JDelete(rsp);
+    }
+
+    SECTION("A corrupt response is retried after a non-blocking delay") {
+        REQUIRE(NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        arrive("{\"err\":\"corrupted {io}\"}\r\n");
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(_noteChunkedTransmit_fake.call_count == 1);
+
+        CHECK(pollFor(1000) == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(_noteChunkedTransmit_fake.call_count == 2);
+
+        arrive("{\"total\":3}\r\n");
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+
+        J *rsp = NoteTransactionEnd();
+        CHECK(JGetInt(rsp, "total") == 3);
+        JDelete(rsp);
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    SECTION("A missing response times out and the retries are exhausted") {
+        REQUIRE(NoteTransactionBegin(req));
+
+        CHECK(pollFor(10 * 60 * 1000) == NOTE_C_TXN_COMPLETE);
+        CHECK(_noteChunkedTransmit_fake.call_count == (CARD_REQUEST_RETRIES_ALLOWED + 1));
+
+        J *rsp = NoteTransactionEnd();
+        CHECK(NoteResponseErrorContains(rsp, c_iotimeout));
+        CHECK(resetRequired);
+        JDelete(rsp);
+    }
+
+    SECTION("A partial response times out once the Notecard stops sending") {
+        REQUIRE(NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        arrive("{\"total\"");
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+        nowMs += (CARD_INTRA_TRANSACTION_TIMEOUT_SEC * 1000);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        // The request is sent again
+        CHECK(_noteHardReset_fake.call_count == 1);
+        CHECK(pollFor(1000) == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(_noteChunkedTransmit_fake.call_count == 2);
+
+        JDelete(NoteTransactionEnd());
+    }
+
+    SECTION("A response larger than the first buffer is received whole") {
+        const std::string text(4 * ALLOC_CHUNK, 'x');
+        REQUIRE(NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        arrive(("{\"text\":\"" + text + "\"}\r\n").c_str());
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_COMPLETE);
+
+        J *rsp = NoteTransactionEnd();
+        CHECK(JGetString(rsp, "text") == text);
+        JDelete(rsp);
+    }
+
+    SECTION("Abandoning a request returns an error") {
+        REQUIRE(NoteTransactionBegin(req));
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        J *rsp = NoteTransactionEnd();
+        CHECK(NoteResponseErrorContains(rsp, c_ioerr));
+        CHECK(resetRequired);
+        JDelete(rsp);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+    }
+
+    SECTION("Abandoning a command returns NULL") {
+        J *cmd = NoteNewCommand("card.attn");
+        JAddStringToObject(cmd, "text", std::string(4 * CARD_REQUEST_SERIAL_SEGMENT_MAX_LEN, 'x').c_str());
+        REQUIRE(NoteTransactionBegin(cmd));
+        JDelete(cmd);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+
+        CHECK(NoteTransactionEnd() == NULL);
+        CHECK(resetRequired);
+        CHECK(NoteTransactionPoll() == NOTE_C_TXN_IDLE);
+    }
+
+    SECTION("The response is read over I2C") {
+        NoteGetActiveInterface_fake.return_val = NOTE_C_INTERFACE_I2C;
+        REQUIRE(NoteTransactionBegin(req));
+
+        CHECK(pollFor(100) == NOTE_C_TXN_IN_PROGRESS);
+        CHECK(transmitted.back() == '\n');
+
+        // The Notecard is queried at most every 50 ms while it is busy
+        const unsigned queries = _noteI2CReceive_fake.call_count;
+        for (int i = 0 ; i < 10 ; ++i) {
+            CHECK(NoteTransactionPoll() == NOTE_C_TXN_IN_PROGRESS);
+        }
+        CHECK(_noteI2CReceive_fake.call_count <= (queries + 1));
+
+        arrive("{\"total\":4}\r\n");
+        CHECK(pollFor(100) == NOTE_C_TXN_COMPLETE);
+
+        J *rsp = NoteTransactionEnd();
+        CHECK(JGetInt(rsp, "total") == 4);
+        JDelete(rsp);
+        CHECK(NoteDelayMs_fake.call_count == 0);
+    }
+
+    JDelete(req);
+    // Abandon any transaction left in flight by a failed check
+    JDelete(NoteTransactionEnd());
+
+    RESET_FAKE(NoteGetActiveInterface);
+    RESET_FAKE(_noteHardReset);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(_noteTransactionStop);
+    RESET_FAKE(_noteChunkedTransmit);
+    RESET_FAKE(_noteSerialAvailable);
+    RESET_FAKE(_noteSerialReceive);
+    RESET_FAKE(_noteI2CReceive);
+    RESET_FAKE(NoteGetMs);
+    RESET_FAKE(NoteDelayMs);
+}
+
+}
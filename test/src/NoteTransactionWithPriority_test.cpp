@@ -0,0 +1,210 @@
+/*!
+ * @file NoteTransactionWithPriority_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(const char *, _noteJSONTransaction, const char *, size_t, char **, uint32_t)
+FAKE_VALUE_FUNC(bool, _noteTransactionStart, uint32_t)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+
+namespace
+{
+
+uint32_t clockMs = 0;
+std::vector<std::string> sent;
+J *nestedReq = NULL;
+J *nestedRsp = NULL;
+
+uint32_t NoteGetMsClock(void)
+{
+    return clockMs;
+}
+
+const char *_noteJSONTransactionRecord(const char *request, size_t reqLen, char **resp, uint32_t)
+{
+    J *req = JParse(std::string(request, reqLen).c_str());
+    sent.push_back(JGetString(req, "req"));
+    JDelete(req);
+    if (resp) {
+        *resp = strdup("{}");
+    }
+    return NULL;
+}
+
+bool tryLockFail(uint32_t)
+{
+    return false;
+}
+
+// While the first request waits, a request of a higher class arrives, then
+// the thread holding the Notecard releases it
+void NoteDelayMsHigherClass(uint32_t delayMs)
+{
+    clockMs += delayMs;
+    if (NoteDelayMs_fake.call_count == 1) {
+        nestedReq = NoteNewRequest("hub.sync");
+        nestedRsp = NoteTransactionWithPriority(nestedReq, NOTE_C_PRIORITY_HIGH, 0);
+    } else if (NoteDelayMs_fake.call_count == 2) {
+        _noteUnlockNote();
+    }
+}
+
+// While the first request waits, a second request of the same class arrives,
+// then the thread holding the Notecard releases it
+void NoteDelayMsSameClass(uint32_t delayMs)
+{
+    clockMs += delayMs;
+    if (NoteDelayMs_fake.call_count == 1) {
+        nestedReq = NoteNewRequest("hub.sync");
+        nestedRsp = NoteTransactionWithPriority(nestedReq, NOTE_C_PRIORITY_NORMAL, 5);
+    } else if (NoteDelayMs_fake.call_count == 2) {
+        _noteUnlockNote();
+    }
+}
+
+// The thread holding the Notecard releases it after a long transaction
+uint32_t longestDelayMs = 0;
+void NoteDelayMsLongTransaction(uint32_t delayMs)
+{
+    clockMs += delayMs;
+    longestDelayMs = ((delayMs > longestDelayMs) ? delayMs : longestDelayMs);
+    if (clockMs >= 30000 && clockMs < (30000 + delayMs)) {
+        _noteUnlockNote();
+    }
+}
+
+SCENARIO("NoteTransactionWithPriority")
+{
+    NoteSetFnDefault(malloc, free, NULL, NULL);
+    clockMs = 0;
+    sent.clear();
+    nestedReq = NULL;
+    nestedRsp = NULL;
+    NoteGetMs_fake.custom_fake = NoteGetMsClock;
+    _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionRecord;
+    _noteTransactionStart_fake.return_val = true;
+
+    J *req = NoteNewRequest("card.version");
+    REQUIRE(req != NULL);
+
+    SECTION("NULL request") {
+        CHECK(NoteTransactionWithPriority(NULL, NOTE_C_PRIORITY_HIGH, 0) == NULL);
+    }
+
+    SECTION("Without scheduling, the wait is bounded by the try-lock hook") {
+        NoteSetFnNoteTryLock(tryLockFail);
+
+        J *rsp = NoteTransactionWithPriority(req, NOTE_C_PRIORITY_HIGH, 100);
+
+        CHECK(NoteResponseErrorContains(rsp, c_busy));
+        CHECK(_noteJSONTransaction_fake.call_count == 0);
+        JDelete(rsp);
+
+        rsp = NoteTransactionWithPriority(req, NOTE_C_PRIORITY_HIGH, 0);
+
+        CHECK_FALSE(NoteResponseError(rsp));
+        CHECK(_noteJSONTransaction_fake.call_count == 1);
+        JDelete(rsp);
+
+        NoteSetFnNoteTryLock(NULL);
+    }
+
+    SECTION("With scheduling") {
+        NoteSetRequestScheduling(true);
+
+        SECTION("A free Notecard is used right away") {
+            J *rsp = NoteTransactionWithPriority(req, NOTE_C_PRIORITY_LOW, 0);
+
+            CHECK_FALSE(NoteResponseError(rsp));
+            CHECK(NoteDelayMs_fake.call_count == 0);
+            JDelete(rsp);
+        }
+
+        SECTION("A waiting request of a higher class goes first") {
+            NoteDelayMs_fake.custom_fake = NoteDelayMsHigherClass;
+            _noteLockNote();
+
+            J *rsp = NoteTransactionWithPriority(req, NOTE_C_PRIORITY_LOW, 0);
+
+            REQUIRE(sent.size() == 2);
+            CHECK(sent[0] == "hub.sync");
+            CHECK(sent[1] == "card.version");
+            CHECK_FALSE(NoteResponseError(nestedRsp));
+            CHECK_FALSE(NoteResponseError(rsp));
+            JDelete(rsp);
+        }
+
+        SECTION("Requests of the same class are served in order, and a wait may time out") {
+            NoteDelayMs_fake.custom_fake = NoteDelayMsSameClass;
+            _noteLockNote();
+
+            J *rsp = NoteTransactionWithPriority(req, NOTE_C_PRIORITY_NORMAL, 0);
+
+            REQUIRE(sent.size() == 1);
+            CHECK(sent[0] == "card.version");
+            CHECK(NoteResponseErrorContains(nestedRsp, c_busy));
+            CHECK_FALSE(NoteResponseError(rsp));
+            JDelete(rsp);
+        }
+
+        SECTION("Waiters back off while the Notecard stays busy") {
+            NoteDelayMs_fake.custom_fake = NoteDelayMsLongTransaction;
+            longestDelayMs = 0;
+            _noteLockNote();
+
+            J *rsp = NoteTransactionWithPriority(req, NOTE_C_PRIORITY_NORMAL, 0);
+
+            CHECK_FALSE(NoteResponseError(rsp));
+            CHECK(longestDelayMs == NOTE_C_SCHEDULER_POLL_MAX_MS);
+            CHECK(NoteDelayMs_fake.call_count < ((30000 / NOTE_C_SCHEDULER_POLL_MAX_MS) + 10));
+            JDelete(rsp);
+        }
+
+        SECTION("A command that times out returns NULL") {
+            J *cmd = NoteNewCommand("card.attn");
+            _noteLockNote();
+            NoteDelayMs_fake.custom_fake = [](uint32_t delayMs) {
+                clockMs += delayMs;
+            };
+
+            CHECK(NoteTransactionWithPriority(cmd, NOTE_C_PRIORITY_HIGH, 10) == NULL);
+
+            _noteUnlockNote();
+            JDelete(cmd);
+        }
+
+        // The Notecard is free again
+        JDelete(NoteTransactionWithPriority(req, NOTE_C_PRIORITY_LOW, 1));
+        CHECK(sent.back() == "card.version");
+
+        NoteSetRequestScheduling(false);
+    }
+
+    JDelete(nestedReq);
+    JDelete(nestedRsp);
+    JDelete(req);
+    RESET_FAKE(_noteJSONTransaction);
+    RESET_FAKE(_noteTransactionStart);
+    RESET_FAKE(NoteDelayMs);
+    RESET_FAKE(NoteGetMs);
+}
+
+}
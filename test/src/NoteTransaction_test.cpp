@@ -426,9 +426,15 @@ SCENARIO("NoteTransaction")
             CHECK(resp != NULL);
         }
 
+#ifndef NOTE_C_LOW_MEM
         THEN("The transaction is retried") {
             CHECK(_noteJSONTransaction_fake.call_count == (1 + CARD_REQUEST_RETRIES_ALLOWED));
         }
+#else
+        THEN("The transaction is not retried, because without a CRC the Notecard would add the note again") {
+            CHECK(_noteJSONTransaction_fake.call_count == 1);
+        }
+#endif // !NOTE_C_LOW_MEM
 
         JDelete(req);
         JDelete(resp);
@@ -687,6 +693,54 @@ SCENARIO("NoteTransaction")
         JDelete(resp);
     }
 
+    SECTION("A corrupt response isn't retried when the request has no CRC and isn't safe to resend") {
+        J *req = NoteNewRequest("note.add");
+        REQUIRE(req != NULL);
+        _crcAdd_fake.custom_fake = nullptr;
+        _crcAdd_fake.return_val = nullptr;
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionBadJSON;
+
+        J *resp = NoteTransaction(req);
+
+        CHECK(_noteJSONTransaction_fake.call_count == 1);
+        CHECK(NoteResponseErrorContains(resp, "{io}"));
+
+        JDelete(req);
+        JDelete(resp);
+    }
+
+    SECTION("A corrupt response is retried when the request is safe to resend") {
+        J *req = NoteNewRequest("card.version");
+        REQUIRE(req != NULL);
+        _crcAdd_fake.custom_fake = nullptr;
+        _crcAdd_fake.return_val = nullptr;
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionBadJSON;
+
+        J *resp = NoteTransaction(req);
+
+        CHECK(_noteJSONTransaction_fake.call_count == (CARD_REQUEST_RETRIES_ALLOWED + 1));
+        CHECK(NoteResponseErrorContains(resp, "{io}"));
+
+        JDelete(req);
+        JDelete(resp);
+    }
+
+#ifndef NOTE_C_LOW_MEM
+    SECTION("A corrupt response is retried when the request has a CRC") {
+        J *req = NoteNewRequest("note.add");
+        REQUIRE(req != NULL);
+        _noteJSONTransaction_fake.custom_fake = _noteJSONTransactionBadJSON;
+
+        J *resp = NoteTransaction(req);
+
+        CHECK(_noteJSONTransaction_fake.call_count == (CARD_REQUEST_RETRIES_ALLOWED + 1));
+        CHECK(NoteResponseErrorContains(resp, "{io}"));
+
+        JDelete(req);
+        JDelete(resp);
+    }
+#endif // !NOTE_C_LOW_MEM
+
 #ifndef NOTE_DISABLE_USER_AGENT
     SECTION("hub.set command with product adds user agent information") {
         J *req = NoteNewCommand("hub.set");
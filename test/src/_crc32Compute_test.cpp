@@ -0,0 +1,75 @@
+/*!
+ * @file _crc32Compute_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#ifndef NOTE_C_LOW_MEM
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "n_lib.h"
+
+namespace
+{
+
+uint32_t crc32Bitwise(uint32_t crc, const uint8_t *data, size_t length)
+{
+    crc = ~crc;
+    for (size_t i = 0 ; i < length ; ++i) {
+        crc ^= data[i];
+        for (int bit = 0 ; bit < 8 ; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+SCENARIO("_crc32Compute")
+{
+    SECTION("The standard check value is produced") {
+        const char check[] = "123456789";
+
+        CHECK(_crc32Compute(0, (const uint8_t *)check, sizeof(check) - 1) == 0xCBF43926);
+    }
+
+    SECTION("An empty buffer leaves the CRC unchanged") {
+        CHECK(_crc32Compute(0, NULL, 0) == 0);
+        CHECK(_crc32Compute(0xCBF43926, NULL, 0) == 0xCBF43926);
+    }
+
+    uint8_t buf[300];
+    for (size_t i = 0 ; i < sizeof(buf) ; ++i) {
+        buf[i] = (uint8_t)((i * 131) + 7);
+    }
+
+    SECTION("Every length and alignment matches a bitwise reference") {
+        // Covers the head, body and tail loops of the sliced variants
+        for (size_t offset = 0 ; offset < 8 ; ++offset) {
+            for (size_t length = 0 ; length <= 80 ; ++length) {
+                CHECK(_crc32Compute(0, buf + offset, length) == crc32Bitwise(0, buf + offset, length));
+            }
+        }
+    }
+
+    SECTION("Computing in pieces matches computing in one go") {
+        uint32_t expected = _crc32Compute(0, buf, sizeof(buf));
+
+        for (size_t split = 0 ; split <= sizeof(buf) ; split += 13) {
+            uint32_t crc = _crc32Compute(0, buf, split);
+            crc = _crc32Compute(crc, buf + split, sizeof(buf) - split);
+            CHECK(crc == expected);
+        }
+    }
+}
+
+}
+
+#endif // !NOTE_C_LOW_MEM
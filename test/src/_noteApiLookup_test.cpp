@@ -0,0 +1,95 @@
+/*!
+ * @file _noteApiLookup_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "n_lib.h"
+
+namespace
+{
+
+SCENARIO("_noteApiLookup")
+{
+    SECTION("Known APIs are found by name") {
+        const _noteApiDescriptor *api = _noteApiLookup("card.version");
+
+        CHECK(strcmp(api->name, "card.version") == 0);
+        CHECK(api->rspSize > ALLOC_CHUNK);
+        CHECK(api->flags & API_IDEMPOTENT);
+    }
+
+    SECTION("The first and last entries of the table are found") {
+        CHECK(strcmp(_noteApiLookup("card.attn")->name, "card.attn") == 0);
+        CHECK(strcmp(_noteApiLookup("web.put")->name, "web.put") == 0);
+    }
+
+    SECTION("An API isn't matched by a prefix of its name") {
+        CHECK(_noteApiLookup("card.binary")->name[0] != '\0');
+        CHECK(strcmp(_noteApiLookup("card.binary")->name, "card.binary") == 0);
+        CHECK(strcmp(_noteApiLookup("card.binary.put")->name, "card.binary.put") == 0);
+        CHECK(_noteApiLookup("card.vers")->name[0] == '\0');
+    }
+
+    SECTION("Requests that aren't safe to resend are flagged") {
+        CHECK_FALSE(_noteApiLookup("note.add")->flags & API_IDEMPOTENT);
+        CHECK_FALSE(_noteApiLookup("card.restart")->flags & API_IDEMPOTENT);
+        CHECK_FALSE(_noteApiLookup("web.post")->flags & API_IDEMPOTENT);
+        CHECK(_noteApiLookup("hub.set")->flags & API_IDEMPOTENT);
+    }
+
+    SECTION("The table is strictly sorted, so every entry is found") {
+        const _noteApiDescriptor *api = _noteApiLookup("card.attn");
+        REQUIRE(_noteApiIndex(api) == 0);
+
+        for (; _noteApiIndex(api + 1) != 0xFFFF ; ++api) {
+            INFO(api->name << " precedes " << (api + 1)->name);
+            CHECK(strcmp(api->name, (api + 1)->name) < 0);
+            CHECK(_noteApiLookup(api->name) == api);
+        }
+        CHECK(_noteApiLookup(api->name) == api);
+        CHECK(strcmp(api->name, "web.put") == 0);
+    }
+
+    SECTION("Deletes aren't safe to resend") {
+        CHECK_FALSE(_noteApiLookup("file.delete")->flags & API_IDEMPOTENT);
+        CHECK_FALSE(_noteApiLookup("note.delete")->flags & API_IDEMPOTENT);
+        CHECK_FALSE(_noteApiLookup("var.delete")->flags & API_IDEMPOTENT);
+    }
+
+    SECTION("note.add and web.* requests take their timeout from their arguments") {
+        CHECK(_noteApiLookup("note.add")->flags & API_TIMEOUT_ARGS);
+        CHECK(_noteApiLookup("web.get")->flags & API_TIMEOUT_ARGS);
+        CHECK_FALSE(_noteApiLookup("hub.set")->flags & API_TIMEOUT_ARGS);
+    }
+
+    SECTION("An API without an entry of its own is described by its family") {
+        const _noteApiDescriptor *api = _noteApiLookup("web.patch");
+
+        CHECK(strcmp(api->name, "web.") == 0);
+        CHECK(api->flags & API_TIMEOUT_ARGS);
+    }
+
+    SECTION("Unknown APIs aren't assumed to be safe to resend") {
+        const _noteApiDescriptor *api = _noteApiLookup("test.api");
+
+        REQUIRE(api != NULL);
+        CHECK(api->name[0] == '\0');
+        CHECK(api->rspSize == 0);
+        CHECK(api->flags == 0);
+        CHECK(_noteApiLookup("card.")->flags == 0);
+        CHECK(_noteApiLookup("")->flags == 0);
+        CHECK(_noteApiLookup(NULL)->flags == 0);
+    }
+}
+
+}
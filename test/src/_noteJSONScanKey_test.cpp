@@ -0,0 +1,88 @@
+/*!
+ * @file _noteJSONScanKey_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include "n_lib.h"
+
+namespace
+{
+
+int scan(const std::string &json, const char *key, std::string *value = NULL)
+{
+    const char *valuePtr = NULL;
+    size_t valueLen = 0;
+    const int found = _noteJSONScanKey(json.c_str(), json.size(), key, &valuePtr, &valueLen);
+    if (found > 0 && value != NULL) {
+        *value = std::string(valuePtr, valueLen);
+    }
+    return found;
+}
+
+SCENARIO("_noteJSONScanKey")
+{
+    std::string value;
+
+    SECTION("A top-level string field is found with its quotes") {
+        CHECK(scan("{\"total\":1,\"err\":\"timeout {io}\"}", "err", &value) == 1);
+        CHECK(value == "\"timeout {io}\"");
+    }
+
+    SECTION("Numbers, literals, objects and arrays are found") {
+        const std::string json = "{ \"id\" : 917 , \"ok\":true, \"body\":{\"a\":[1,{\"b\":2}]}, \"list\":[\"x\",\"]\"] }";
+
+        CHECK(scan(json, "id", &value) == 1);
+        CHECK(value == "917");
+        CHECK(scan(json, "ok", &value) == 1);
+        CHECK(value == "true");
+        CHECK(scan(json, "body", &value) == 1);
+        CHECK(value == "{\"a\":[1,{\"b\":2}]}");
+        CHECK(scan(json, "list", &value) == 1);
+        CHECK(value == "[\"x\",\"]\"]");
+    }
+
+    SECTION("Fields of nested objects are not matched") {
+        CHECK(scan("{\"body\":{\"err\":\"{io}\"},\"total\":1}", "err") == 0);
+    }
+
+    SECTION("Keys within string values are not matched") {
+        CHECK(scan("{\"text\":\"\\\"err\\\":\\\"{io}\\\"\"}", "err") == 0);
+    }
+
+    SECTION("A missing field is not found") {
+        CHECK(scan("{\"total\":1}", "err") == 0);
+        CHECK(scan("{}", "err") == 0);
+        CHECK(scan("  {  }\r\n", "err") == 0);
+    }
+
+    SECTION("The text is not required to be null-terminated") {
+        const char json[] = "{\"id\":5}{\"err\":\"{io}\"}";
+
+        CHECK(_noteJSONScanKey(json, 8, "err", NULL, NULL) == 0);
+        CHECK(_noteJSONScanKey(json, 8, "id", NULL, NULL) == 1);
+    }
+
+    SECTION("Malformed text is reported") {
+        CHECK(scan("", "err") == -1);
+        CHECK(scan("[1,2]", "err") == -1);
+        CHECK(scan("{\"total\":1", "err") == -1);
+        CHECK(scan("{\"total\" 1}", "err") == -1);
+        CHECK(scan("{\"text\":\"unterminated}", "err") == -1);
+        CHECK(scan("{\"body\":{\"a\":1}", "err") == -1);
+        CHECK(scan("{\"total\":}", "err") == -1);
+    }
+}
+
+}
@@ -0,0 +1,97 @@
+/*!
+ * @file _noteResetSync_test.cpp
+ *
+ * Written by the Blues Inc. team.
+ *
+ * Copyright (c) 2026 Blues Inc. MIT License. Use of this source code is
+ * governed by licenses granted by the copyright holder including that found in
+ * the
+ * <a href="https://github.com/blues/note-c/blob/master/LICENSE">LICENSE</a>
+ * file.
+ *
+ */
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fff.h>
+
+#include "n_lib.h"
+
+DEFINE_FFF_GLOBALS
+FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+
+namespace
+{
+
+bool scan(_noteResetSync *sync, const std::string &data)
+{
+    return _noteResetSyncScan(sync, reinterpret_cast<const uint8_t *>(data.data()), (uint32_t)data.size());
+}
+
+SCENARIO("_noteResetSync")
+{
+    _noteResetSync sync;
+    _noteResetSyncBegin(&sync);
+    const std::string nonce(sync.nonce, NOTE_C_RESET_NONCE_LEN);
+    const std::string answer = "{\"text\":\"" + nonce + "\"}\r\n";
+
+    SECTION("The request is a newline followed by an echo of the nonce") {
+        const std::string request(reinterpret_cast<const char *>(sync.request), sync.requestLen);
+
+        CHECK(request == ("\n{\"req\":\"echo\",\"text\":\"" + nonce + "\"}\n"));
+    }
+
+    SECTION("The nonce never repeats its first letter") {
+        for (int i = 0 ; i < 100 ; ++i) {
+            _noteResetSyncBegin(&sync);
+            CHECK(std::string(sync.nonce + 1, NOTE_C_RESET_NONCE_LEN - 1).find(sync.nonce[0]) == std::string::npos);
+        }
+    }
+
+    SECTION("Successive nonces differ within the same millisecond") {
+        _noteResetSync next;
+        _noteResetSyncBegin(&next);
+
+        CHECK(memcmp(sync.nonce, next.nonce, NOTE_C_RESET_NONCE_LEN) != 0);
+    }
+
+    SECTION("The answer is recognized once its line ends") {
+        CHECK(!scan(&sync, "\r\n"));
+        CHECK(sync.dataLen == 0);
+        CHECK(!scan(&sync, answer.substr(0, answer.size() - 1)));
+        CHECK(scan(&sync, "\n"));
+    }
+
+    SECTION("The nonce is split across reads") {
+        const size_t split = answer.find(nonce) + (NOTE_C_RESET_NONCE_LEN / 2);
+
+        CHECK(!scan(&sync, answer.substr(0, split)));
+        CHECK(scan(&sync, answer.substr(split)));
+    }
+
+    SECTION("A partial match is not taken for the nonce") {
+        CHECK(!scan(&sync, "{\"text\":\"" + nonce.substr(0, NOTE_C_RESET_NONCE_LEN - 1) + "\"}\r\n"));
+        CHECK(scan(&sync, answer));
+    }
+
+    SECTION("A partial match restarts within the same line") {
+        CHECK(scan(&sync, "{\"text\":\"" + nonce.substr(0, 3) + nonce + "\"}\r\n"));
+    }
+
+    SECTION("Noise before the nonce is counted and skipped") {
+        const std::string noise = "{\"err\":\"stale\"}\r\nxyz";
+
+        CHECK(!scan(&sync, noise));
+        CHECK(sync.dataLen == (noise.size() - 2));
+        CHECK(scan(&sync, "\r\n" + answer));
+    }
+
+    SECTION("A line break before the nonce completes discards the match") {
+        CHECK(!scan(&sync, nonce.substr(0, 4) + "\n" + nonce.substr(4) + "\n"));
+    }
+
+    RESET_FAKE(NoteGetMs);
+}
+
+}
@@ -11,6 +11,9 @@
  *
  */
 
+#include <string>
+#include <vector>
+
 #include <catch2/catch_test_macros.hpp>
 #include <fff.h>
 
@@ -22,33 +25,77 @@ FAKE_VOID_FUNC(_noteSerialTransmit, const uint8_t *, size_t, bool)
 FAKE_VALUE_FUNC(bool, _noteSerialAvailable)
 FAKE_VALUE_FUNC(char, _noteSerialReceive)
 FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
+FAKE_VOID_FUNC(NoteDelayMs, uint32_t)
 
 namespace
 {
 
+uint32_t rtcMs;
+std::string transmitted;
+std::string rx;
+size_t rxOff;
+
+// What the emulated Notecard sends before answering each request, and whether
+// it answers the `echo` at all
+std::string noise;
+bool echo;
+
+// Delays other than the 1 ms polling interval
+std::vector<uint32_t> pauses;
+
 uint32_t NoteGetMsMock()
 {
-    static uint32_t ret = 500;
-
-    // Cycle through returning 0, 1, and 500. 500 ms is the timeout of the
-    // receive loop in _serialNoteReset.
-    switch (ret) {
-    case 0:
-        ret = 1;
-        break;
-    case 1:
-        ret = 500;
-        break;
-    case 500:
-        ret = 0;
-        break;
+    return rtcMs++;
+}
+
+void NoteDelayMsMock(uint32_t delayMs)
+{
+    rtcMs += delayMs;
+    if (delayMs > 1) {
+        pauses.push_back(delayMs);
     }
+}
 
-    return ret;
+void _noteSerialTransmitMock(const uint8_t *buf, size_t len, bool)
+{
+    transmitted.assign(reinterpret_cast<const char *>(buf), len);
+
+    // A bare newline is answered with a blank line, and the `echo` request
+    // with its text
+    rx = noise + "\r\n";
+    const size_t text = transmitted.find("\"text\":\"");
+    if (echo && text != std::string::npos) {
+        const size_t start = text + strlen("\"text\":\"");
+        rx += "{\"text\":\"" + transmitted.substr(start, transmitted.find('"', start) - start) + "\"}\r\n";
+    }
+    rxOff = 0;
+}
+
+bool _noteSerialAvailableMock()
+{
+    return (rxOff < rx.size());
+}
+
+char _noteSerialReceiveMock()
+{
+    return rx[rxOff++];
 }
 
 SCENARIO("_serialNoteReset")
 {
+    rtcMs = 0;
+    transmitted.clear();
+    rx.clear();
+    rxOff = 0;
+    noise.clear();
+    echo = true;
+    pauses.clear();
+    NoteGetMs_fake.custom_fake = NoteGetMsMock;
+    NoteDelayMs_fake.custom_fake = NoteDelayMsMock;
+    _noteSerialTransmit_fake.custom_fake = _noteSerialTransmitMock;
+    _noteSerialAvailable_fake.custom_fake = _noteSerialAvailableMock;
+    _noteSerialReceive_fake.custom_fake = _noteSerialReceiveMock;
+
     SECTION("_noteSerialReset fails") {
         _noteSerialReset_fake.return_val = false;
 
@@ -59,64 +106,100 @@ SCENARIO("_serialNoteReset")
 
     SECTION("Serial never available") {
         _noteSerialReset_fake.return_val = true;
+        _noteSerialAvailable_fake.custom_fake = NULL;
         _noteSerialAvailable_fake.return_val = false;
-        NoteGetMs_fake.custom_fake = NoteGetMsMock;
 
         CHECK(!_serialNoteReset());
         // _serialNoteReset has retry logic, so we expect retries.
-        CHECK(_noteSerialTransmit_fake.call_count > 1);
+        CHECK(_noteSerialTransmit_fake.call_count == CARD_RESET_SYNC_RETRIES);
         CHECK(_noteSerialReceive_fake.call_count == 0);
     }
 
-    SECTION("Character received") {
-        NoteGetMs_fake.custom_fake = NoteGetMsMock;
-        bool serialAvailRetVals[] = {true, false};
-        SET_RETURN_SEQ(_noteSerialAvailable, serialAvailRetVals, 2);
+    SECTION("The nonce is echoed") {
+        _noteSerialReset_fake.return_val = true;
+
+        CHECK(_serialNoteReset());
+        // There should be no retrying.
+        CHECK(_noteSerialTransmit_fake.call_count == 1);
+        // The request is preceded by a bare newline
+        CHECK(transmitted.front() == '\n');
+        CHECK(transmitted.find("\"req\":\"echo\"") != std::string::npos);
+        CHECK(transmitted.back() == '\n');
+        // Nothing the Notecard sent is left unread
+        CHECK(rxOff == rx.size());
+        // Recovery is fast
+        CHECK(rtcMs < CARD_RESET_DRAIN_MS);
+    }
+
+    SECTION("Unrecognized data precedes the echo") {
+        _noteSerialReset_fake.return_val = true;
+        noise = "{\"err\":\"stale\"}\r\n{\"text\":\"ABCDEFG";
+
+        CHECK(_serialNoteReset());
+        CHECK(_noteSerialTransmit_fake.call_count == 1);
+    }
 
-        SECTION("Non-control character received") {
-            _noteSerialReceive_fake.return_val = 'a';
+    SECTION("Only newlines are received") {
+        _noteSerialReset_fake.return_val = true;
+        echo = false;
 
-            SECTION("Retry") {
-                _noteSerialReset_fake.return_val = true;
+        CHECK(!_serialNoteReset());
+        // Expect retries.
+        CHECK(_noteSerialTransmit_fake.call_count == CARD_RESET_SYNC_RETRIES);
+    }
 
-                CHECK(!_serialNoteReset());
-                // Expect retries.
-                CHECK(_noteSerialTransmit_fake.call_count > 1);
-            }
+    SECTION("Non-control character received") {
+        echo = false;
+        noise = "a";
 
-            SECTION("_noteSerialReset fails before retry possible") {
-                bool _noteSerialResetRetVals[] = {true, false};
-                SET_RETURN_SEQ(_noteSerialReset, _noteSerialResetRetVals, 2);
+        SECTION("Retry") {
+            _noteSerialReset_fake.return_val = true;
 
-                CHECK(!_serialNoteReset());
-                // No retries.
-                CHECK(_noteSerialTransmit_fake.call_count == 1);
-            }
+            CHECK(!_serialNoteReset());
+            // Expect retries.
+            CHECK(_noteSerialTransmit_fake.call_count > 1);
         }
 
-        SECTION("Only control character received") {
-            _noteSerialReset_fake.return_val = true;
-            _noteSerialReceive_fake.return_val = '\n';
+        SECTION("_noteSerialReset fails before retry possible") {
+            bool _noteSerialResetRetVals[] = {true, false};
+            SET_RETURN_SEQ(_noteSerialReset, _noteSerialResetRetVals, 2);
 
-            CHECK(_serialNoteReset());
-            // There should be no retrying.
+            CHECK(!_serialNoteReset());
+            // No retries.
             CHECK(_noteSerialTransmit_fake.call_count == 1);
         }
 
         CHECK(_noteSerialReceive_fake.call_count > 0);
     }
 
-    SECTION("NoteGetMs overflow") {
+    SECTION("Rounds are bounded while the Notecard keeps sending") {
         _noteSerialReset_fake.return_val = true;
+        _noteSerialAvailable_fake.custom_fake = NULL;
+        _noteSerialAvailable_fake.return_val = true;
+        _noteSerialReceive_fake.custom_fake = NULL;
         _noteSerialReceive_fake.return_val = '\n';
-        bool serialAvailRetVals[] = {true, false};
-        SET_RETURN_SEQ(_noteSerialAvailable, serialAvailRetVals, 2);
-        uint32_t getMsReturnVals[] = {
-            UINT32_MAX - 500,
-            UINT32_MAX - 400,
-            0
-        };
-        SET_RETURN_SEQ(NoteGetMs, getMsReturnVals, 3);
+
+        CHECK(!_serialNoteReset());
+        CHECK(_noteSerialTransmit_fake.call_count == CARD_RESET_SYNC_RETRIES);
+    }
+
+    SECTION("Rounds back off between retries") {
+        _noteSerialReset_fake.return_val = true;
+        echo = false;
+
+        CHECK(!_serialNoteReset());
+        REQUIRE(pauses.size() == CARD_RESET_SYNC_RETRIES);
+        CHECK(pauses.front() == CARD_RESET_BACKOFF_MS);
+        for (size_t i = 1 ; i < pauses.size() ; ++i) {
+            CHECK(pauses[i] >= pauses[i - 1]);
+            CHECK(pauses[i] <= CARD_RESET_DRAIN_MS);
+        }
+        CHECK(pauses.back() == CARD_RESET_DRAIN_MS);
+    }
+
+    SECTION("NoteGetMs overflow") {
+        _noteSerialReset_fake.return_val = true;
+        rtcMs = UINT32_MAX - 5;
 
         CHECK(_serialNoteReset());
     }
@@ -126,8 +209,7 @@ SCENARIO("_serialNoteReset")
     RESET_FAKE(_noteSerialAvailable);
     RESET_FAKE(_noteSerialReceive);
     RESET_FAKE(NoteGetMs);
+    RESET_FAKE(NoteDelayMs);
 }
 
 }
-
-
@@ -22,7 +22,7 @@ FAKE_VALUE_FUNC(bool, _noteSerialAvailable)
 FAKE_VALUE_FUNC(char, _noteSerialReceive)
 FAKE_VALUE_FUNC(uint32_t, NoteGetMs)
 FAKE_VOID_FUNC(_noteSerialTransmit, const uint8_t *, size_t, bool)
-FAKE_VALUE_FUNC(const char *, _serialChunkedTransmit, const uint8_t *, uint32_t, bool);
+FAKE_VALUE_FUNC(const char *, _serialChunkedTransmitLine, const uint8_t *, uint32_t, bool);
 FAKE_VALUE_FUNC(const char *, _serialChunkedReceive, uint8_t *, uint32_t *, bool, uint32_t, uint32_t *)
 
 namespace
@@ -51,9 +51,10 @@ void _noteSerialTransmitAppend(const uint8_t *buf, size_t len, bool)
     transmitBufLen += len;
 }
 
-const char *_serialChunkedTransmitAppend(const uint8_t *buf, uint32_t len, bool)
+const char *_serialChunkedTransmitLineAppend(const uint8_t *buf, uint32_t len, bool)
 {
-    _noteSerialTransmitAppend(buf, len, true);
+    _noteSerialTransmitAppend(buf, len, false);
+    _noteSerialTransmitAppend((const uint8_t *)c_newline, c_newline_len, true);
 
     return NULL;
 }
@@ -106,7 +107,7 @@ SCENARIO("_serialNoteTransaction")
 
     GIVEN("A valid JSON request C-string and a NULL response pointer") {
         _noteSerialTransmit_fake.custom_fake = _noteSerialTransmitAppend;
-        _serialChunkedTransmit_fake.custom_fake = _serialChunkedTransmitAppend;
+        _serialChunkedTransmitLine_fake.custom_fake = _serialChunkedTransmitLineAppend;
 
         WHEN("_serialNoteTransaction is called") {
             const char *err = _serialNoteTransaction(req, strlen(req), NULL, timeoutMs);
@@ -127,9 +128,9 @@ SCENARIO("_serialNoteTransaction")
             }
         }
 
-        AND_GIVEN("_serialChunkedTransmit returns an error") {
-            _serialChunkedTransmit_fake.custom_fake = NULL;
-            _serialChunkedTransmit_fake.return_val = "some error";
+        AND_GIVEN("_serialChunkedTransmitLine returns an error") {
+            _serialChunkedTransmitLine_fake.custom_fake = NULL;
+            _serialChunkedTransmitLine_fake.return_val = "some error";
 
             WHEN("_serialNoteTransaction is called") {
                 const char *err = _serialNoteTransaction(req, strlen(req), NULL, timeoutMs);
@@ -347,8 +348,8 @@ SCENARIO("_serialNoteTransaction")
         WHEN("_serialNoteTransaction is called with a NULL response") {
             err = _serialNoteTransaction(req, reqLen, NULL, timeoutMs);
 
-            THEN("_serialChunkedTransmit is not called") {
-                CHECK(_serialChunkedTransmit_fake.call_count == 0);
+            THEN("_serialChunkedTransmitLine is not called") {
+                CHECK(_serialChunkedTransmitLine_fake.call_count == 0);
             }
 
             THEN("No newline is transmitted either") {
@@ -383,8 +384,8 @@ SCENARIO("_serialNoteTransaction")
             WHEN("_serialNoteTransaction is called with a response pointer") {
                 const char *err = _serialNoteTransaction(req, reqLen, &rsp, timeoutMs);
 
-                THEN("_serialChunkedTransmit is not called") {
-                    CHECK(_serialChunkedTransmit_fake.call_count == 0);
+                THEN("_serialChunkedTransmitLine is not called") {
+                    CHECK(_serialChunkedTransmitLine_fake.call_count == 0);
                 }
 
                 THEN("No error is returned") {
@@ -408,8 +409,8 @@ SCENARIO("_serialNoteTransaction")
         WHEN("_serialNoteTransaction is called with a NULL response") {
             err = _serialNoteTransaction(req, reqLen, NULL, timeoutMs);
 
-            THEN("_serialChunkedTransmit is not called") {
-                CHECK(_serialChunkedTransmit_fake.call_count == 0);
+            THEN("_serialChunkedTransmitLine is not called") {
+                CHECK(_serialChunkedTransmitLine_fake.call_count == 0);
             }
 
             THEN("No newline is transmitted either") {
@@ -444,8 +445,8 @@ SCENARIO("_serialNoteTransaction")
             WHEN("_serialNoteTransaction is called with a response pointer") {
                 const char *err = _serialNoteTransaction(req, reqLen, &rsp, timeoutMs);
 
-                THEN("_serialChunkedTransmit is not called") {
-                    CHECK(_serialChunkedTransmit_fake.call_count == 0);
+                THEN("_serialChunkedTransmitLine is not called") {
+                    CHECK(_serialChunkedTransmitLine_fake.call_count == 0);
                 }
 
                 THEN("No error is returned") {
@@ -467,7 +468,7 @@ SCENARIO("_serialNoteTransaction")
     RESET_FAKE(_noteSerialTransmit);
     RESET_FAKE(_noteSerialReceive);
     RESET_FAKE(NoteGetMs);
-    RESET_FAKE(_serialChunkedTransmit);
+    RESET_FAKE(_serialChunkedTransmitLine);
     RESET_FAKE(_serialChunkedReceive);
 }
 